@@ -333,6 +333,9 @@ mesh.add('getElementByCoordinates', doc, None, idouble('x'), idouble('y'), idoub
 doc = '''Search the mesh for element(s) located at coordinates (`x', `y', `z'). This function performs a search in a spatial octree. Return the tags of all found elements in `elementTags'. Additional information about the elements can be accessed through `getElement' and `getLocalCoordinatesInElement'. If `dim' is >= 0, only search for elements of the given dimension. If `strict' is not set, use a tolerance to find elements near the search location.'''
 mesh.add('getElementsByCoordinates', doc, None, idouble('x'), idouble('y'), idouble('z'), ovectorsize('elementTags'), iint('dim', '-1'), ibool('strict', 'false', 'False'))
 
+doc = '''Search the mesh for the elements located at the coordinates `coord' of a batch of points, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are searched concurrently. Return the tag of the element found for each point in `elementTags' (0 if no element is found), and the local coordinates within the reference element corresponding to each search location in `localCoord', concatenated: [p1u, p1v, p1w, p2u, ...]. If `dim' is >= 0, only search for elements of the given dimension. If `strict' is not set, use a tolerance to find elements near the search locations.'''
+mesh.add('getElementsForCoordinates', doc, None, ivectordouble('coord'), ovectorsize('elementTags'), ovectordouble('localCoord'), iint('dim', '-1'), ibool('strict', 'false', 'False'))
+
 doc = '''Return the local coordinates (`u', `v', `w') within the element `elementTag' corresponding to the model coordinates (`x', `y', `z'). This function relies on an internal cache (a vector in case of dense element numbering, a map otherwise); for large meshes accessing elements in bulk is often preferable.'''
 mesh.add('getLocalCoordinatesInElement', doc, None, isize('elementTag'), idouble('x'), idouble('y'), idouble('z'), odouble('u'), odouble('v'), odouble('w'))
 
@@ -601,6 +604,9 @@ field.add('setNumbers', doc, None, iint('tag'), istring('option'), ivectordouble
 doc = '''Get the value of the numerical list option `option' for field `tag'.'''
 field.add('getNumbers', doc, None, iint('tag'), istring('option'), ovectordouble('value'))
 
+doc = '''Evaluate the field `tag' at the points given by their coordinates `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. Return the (scalar) field value at each point in `values'. The field is evaluated on all the points at once, which is much faster than point-by-point evaluation for most fields.'''
+field.add('evaluate', doc, None, iint('tag'), ivectordouble('coord'), ovectordouble('values'))
+
 doc = '''Set the field `tag' as the background mesh size field.'''
 field.add('setAsBackgroundMesh', doc, None, iint('tag'))
 
@@ -1003,6 +1009,9 @@ view.add('combine', doc, None, istring('what'), istring('how'), ibool('remove',
 doc = '''Probe the view `tag' for its `value' at point (`x', `y', `z'). If no match is found, `value' is returned empty. Return only the value at step `step' is `step' is positive. Return only values with `numComp' if `numComp' is positive. Return the gradient of the `value' if `gradient' is set. If `distanceMax' is zero, only return a result if an exact match inside an element in the view is found; if `distanceMax' is positive and an exact match is not found, return the value at the closest node if it is closer than `distanceMax'; if `distanceMax' is negative and an exact match is not found, always return the value at the closest node. The distance to the match is returned in `distance'. Return the result from the element described by its coordinates if `xElementCoord', `yElementCoord' and `zElementCoord' are provided. If `dim' is >= 0, return only matches from elements of the specified dimension.'''
 view.add('probe', doc, None, iint('tag'), idouble('x'), idouble('y'), idouble('z'), ovectordouble('value'), odouble('distance'), iint('step', '-1'), iint('numComp', '-1'), ibool('gradient', 'false', 'False'), idouble('distanceMax', '0.'), ivectordouble('xElemCoord', 'std::vector<double>()', '[]', '[]'), ivectordouble('yElemCoord', 'std::vector<double>()', '[]', '[]'), ivectordouble('zElemCoord', 'std::vector<double>()', '[]', '[]'), iint('dim', '-1'))
 
+doc = '''Probe the view `tag' for its values at the points given by their coordinates `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. The points are probed concurrently, in an order that preserves spatial locality, which is much faster than calling `probe' for each point. Return the values in `values', concatenated for all the points: the number of values per point is the number of components (`numComp' if positive, or the number of components of the view otherwise), multiplied by the number of steps (or by 1 if `step' is positive) and by 3 if `gradient' is set. Return the distance to the match for each point in `distances', or -1 if no match is found (in which case the values for the point are set to zero). See `probe' for the meaning of `distanceMax' and `dim'.'''
+view.add('probePoints', doc, None, iint('tag'), ivectordouble('coord'), ovectordouble('values'), ovectordouble('distances'), iint('step', '-1'), iint('numComp', '-1'), ibool('gradient', 'false', 'False'), idouble('distanceMax', '0.'), iint('dim', '-1'))
+
 doc = '''Write the view to a file `fileName'. The export format is determined by the file extension. Append to the file if `append' is set.'''
 view.add('write', doc, None, iint('tag'), istring('fileName'), ibool('append', 'false', 'False'))
 
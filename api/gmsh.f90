@@ -224,6 +224,8 @@ module gmsh
         gmshViewCombine
     procedure, nopass :: probe => &
         gmshViewProbe
+    procedure, nopass :: probePoints => &
+        gmshViewProbePoints
     procedure, nopass :: write => &
         gmshViewWrite
     procedure, nopass :: setVisibilityPerWindow => &
@@ -490,6 +492,8 @@ module gmsh
         gmshModelMeshFieldSetNumbers
     procedure, nopass :: getNumbers => &
         gmshModelMeshFieldGetNumbers
+    procedure, nopass :: evaluate => &
+        gmshModelMeshFieldEvaluate
     procedure, nopass :: setAsBackgroundMesh => &
         gmshModelMeshFieldSetAsBackgroundMesh
     procedure, nopass :: setAsBoundaryLayer => &
@@ -553,6 +557,8 @@ module gmsh
         gmshModelMeshGetElementByCoordinates
     procedure, nopass :: getElementsByCoordinates => &
         gmshModelMeshGetElementsByCoordinates
+    procedure, nopass :: getElementsForCoordinates => &
+        gmshModelMeshGetElementsForCoordinates
     procedure, nopass :: getLocalCoordinatesInElement => &
         gmshModelMeshGetLocalCoordinatesInElement
     procedure, nopass :: getElementTypes => &
@@ -3998,6 +4004,68 @@ module gmsh
       api_elementTags_n_)
   end subroutine gmshModelMeshGetElementsByCoordinates
 
+  !> Search the mesh for the elements located at the coordinates `coord' of a
+  !! batch of points, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are
+  !! searched concurrently. Return the tag of the element found for each point
+  !! in `elementTags' (0 if no element is found), and the local coordinates
+  !! within the reference element corresponding to each search location in
+  !! `localCoord', concatenated: [p1u, p1v, p1w, p2u, ...]. If `dim' is >= 0,
+  !! only search for elements of the given dimension. If `strict' is not set,
+  !! use a tolerance to find elements near the search locations.
+  subroutine gmshModelMeshGetElementsForCoordinates(coord, &
+                                                    elementTags, &
+                                                    localCoord, &
+                                                    dim, &
+                                                    strict, &
+                                                    ierr)
+    interface
+    subroutine C_API(api_coord_, &
+                     api_coord_n_, &
+                     api_elementTags_, &
+                     api_elementTags_n_, &
+                     api_localCoord_, &
+                     api_localCoord_n_, &
+                     dim, &
+                     strict, &
+                     ierr_) &
+      bind(C, name="gmshModelMeshGetElementsForCoordinates")
+      use, intrinsic :: iso_c_binding
+      real(c_double), dimension(*) :: api_coord_
+      integer(c_size_t), value, intent(in) :: api_coord_n_
+      type(c_ptr), intent(out) :: api_elementTags_
+      integer(c_size_t), intent(out) :: api_elementTags_n_
+      type(c_ptr), intent(out) :: api_localCoord_
+      integer(c_size_t) :: api_localCoord_n_
+      integer(c_int), value, intent(in) :: dim
+      integer(c_int), value, intent(in) :: strict
+      integer(c_int), intent(out), optional :: ierr_
+    end subroutine C_API
+    end interface
+    real(c_double), dimension(:), intent(in) :: coord
+    integer(c_size_t), dimension(:), allocatable, intent(out) :: elementTags
+    real(c_double), dimension(:), allocatable, intent(out) :: localCoord
+    integer, intent(in), optional :: dim
+    logical, intent(in), optional :: strict
+    integer(c_int), intent(out), optional :: ierr
+    type(c_ptr) :: api_elementTags_
+    integer(c_size_t) :: api_elementTags_n_
+    type(c_ptr) :: api_localCoord_
+    integer(c_size_t) :: api_localCoord_n_
+    call C_API(api_coord_=coord, &
+         api_coord_n_=size_gmsh_double(coord), &
+         api_elementTags_=api_elementTags_, &
+         api_elementTags_n_=api_elementTags_n_, &
+         api_localCoord_=api_localCoord_, &
+         api_localCoord_n_=api_localCoord_n_, &
+         dim=optval_c_int(-1, dim), &
+         strict=optval_c_bool(.false., strict), &
+         ierr_=ierr)
+    elementTags = ovectorsize_(api_elementTags_, &
+      api_elementTags_n_)
+    localCoord = ovectordouble_(api_localCoord_, &
+      api_localCoord_n_)
+  end subroutine gmshModelMeshGetElementsForCoordinates
+
   !> Return the local coordinates (`u', `v', `w') within the element
   !! `elementTag' corresponding to the model coordinates (`x', `y', `z'). This
   !! function relies on an internal cache (a vector in case of dense element
@@ -7452,6 +7520,47 @@ module gmsh
       api_value_n_)
   end subroutine gmshModelMeshFieldGetNumbers
 
+  !> Evaluate the field `tag' at the points given by their coordinates `coord',
+  !! concatenated: [p1x, p1y, p1z, p2x, ...]. Return the (scalar) field value at
+  !! each point in `values'. The field is evaluated on all the points at once,
+  !! which is much faster than point-by-point evaluation for most fields.
+  subroutine gmshModelMeshFieldEvaluate(tag, &
+                                        coord, &
+                                        values, &
+                                        ierr)
+    interface
+    subroutine C_API(tag, &
+                     api_coord_, &
+                     api_coord_n_, &
+                     api_values_, &
+                     api_values_n_, &
+                     ierr_) &
+      bind(C, name="gmshModelMeshFieldEvaluate")
+      use, intrinsic :: iso_c_binding
+      integer(c_int), value, intent(in) :: tag
+      real(c_double), dimension(*) :: api_coord_
+      integer(c_size_t), value, intent(in) :: api_coord_n_
+      type(c_ptr), intent(out) :: api_values_
+      integer(c_size_t) :: api_values_n_
+      integer(c_int), intent(out), optional :: ierr_
+    end subroutine C_API
+    end interface
+    integer, intent(in) :: tag
+    real(c_double), dimension(:), intent(in) :: coord
+    real(c_double), dimension(:), allocatable, intent(out) :: values
+    integer(c_int), intent(out), optional :: ierr
+    type(c_ptr) :: api_values_
+    integer(c_size_t) :: api_values_n_
+    call C_API(tag=int(tag, c_int), &
+         api_coord_=coord, &
+         api_coord_n_=size_gmsh_double(coord), &
+         api_values_=api_values_, &
+         api_values_n_=api_values_n_, &
+         ierr_=ierr)
+    values = ovectordouble_(api_values_, &
+      api_values_n_)
+  end subroutine gmshModelMeshFieldEvaluate
+
   !> Set the field `tag' as the background mesh size field.
   subroutine gmshModelMeshFieldSetAsBackgroundMesh(tag, &
                                                    ierr)
@@ -13460,6 +13569,91 @@ module gmsh
       api_value_n_)
   end subroutine gmshViewProbe
 
+  !> Probe the view `tag' for its values at the points given by their
+  !! coordinates `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. The points
+  !! are probed concurrently, in an order that preserves spatial locality, which
+  !! is much faster than calling `probe' for each point. Return the values in
+  !! `values', concatenated for all the points: the number of values per point
+  !! is the number of components (`numComp' if positive, or the number of
+  !! components of the view otherwise), multiplied by the number of steps (or by
+  !! 1 if `step' is positive) and by 3 if `gradient' is set. Return the distance
+  !! to the match for each point in `distances', or -1 if no match is found (in
+  !! which case the values for the point are set to zero). See `probe' for the
+  !! meaning of `distanceMax' and `dim'.
+  subroutine gmshViewProbePoints(tag, &
+                                 coord, &
+                                 values, &
+                                 distances, &
+                                 step, &
+                                 numComp, &
+                                 gradient, &
+                                 distanceMax, &
+                                 dim, &
+                                 ierr)
+    interface
+    subroutine C_API(tag, &
+                     api_coord_, &
+                     api_coord_n_, &
+                     api_values_, &
+                     api_values_n_, &
+                     api_distances_, &
+                     api_distances_n_, &
+                     step, &
+                     numComp, &
+                     gradient, &
+                     distanceMax, &
+                     dim, &
+                     ierr_) &
+      bind(C, name="gmshViewProbePoints")
+      use, intrinsic :: iso_c_binding
+      integer(c_int), value, intent(in) :: tag
+      real(c_double), dimension(*) :: api_coord_
+      integer(c_size_t), value, intent(in) :: api_coord_n_
+      type(c_ptr), intent(out) :: api_values_
+      integer(c_size_t) :: api_values_n_
+      type(c_ptr), intent(out) :: api_distances_
+      integer(c_size_t) :: api_distances_n_
+      integer(c_int), value, intent(in) :: step
+      integer(c_int), value, intent(in) :: numComp
+      integer(c_int), value, intent(in) :: gradient
+      real(c_double), value, intent(in) :: distanceMax
+      integer(c_int), value, intent(in) :: dim
+      integer(c_int), intent(out), optional :: ierr_
+    end subroutine C_API
+    end interface
+    integer, intent(in) :: tag
+    real(c_double), dimension(:), intent(in) :: coord
+    real(c_double), dimension(:), allocatable, intent(out) :: values
+    real(c_double), dimension(:), allocatable, intent(out) :: distances
+    integer, intent(in), optional :: step
+    integer, intent(in), optional :: numComp
+    logical, intent(in), optional :: gradient
+    real(c_double), intent(in), optional :: distanceMax
+    integer, intent(in), optional :: dim
+    integer(c_int), intent(out), optional :: ierr
+    type(c_ptr) :: api_values_
+    integer(c_size_t) :: api_values_n_
+    type(c_ptr) :: api_distances_
+    integer(c_size_t) :: api_distances_n_
+    call C_API(tag=int(tag, c_int), &
+         api_coord_=coord, &
+         api_coord_n_=size_gmsh_double(coord), &
+         api_values_=api_values_, &
+         api_values_n_=api_values_n_, &
+         api_distances_=api_distances_, &
+         api_distances_n_=api_distances_n_, &
+         step=optval_c_int(-1, step), &
+         numComp=optval_c_int(-1, numComp), &
+         gradient=optval_c_bool(.false., gradient), &
+         distanceMax=optval_c_double(0., distanceMax), &
+         dim=optval_c_int(-1, dim), &
+         ierr_=ierr)
+    values = ovectordouble_(api_values_, &
+      api_values_n_)
+    distances = ovectordouble_(api_distances_, &
+      api_distances_n_)
+  end subroutine gmshViewProbePoints
+
   !> Write the view to a file `fileName'. The export format is determined by the
   !! file extension. Append to the file if `append' is set.
   subroutine gmshViewWrite(tag, &
@@ -904,6 +904,22 @@ namespace gmsh { // Top-level functions
                                              const int dim = -1,
                                              const bool strict = false);
 
+      // gmsh::model::mesh::getElementsForCoordinates
+      //
+      // Search the mesh for the elements located at the coordinates `coord' of a
+      // batch of points, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are
+      // searched concurrently. Return the tag of the element found for each point
+      // in `elementTags' (0 if no element is found), and the local coordinates
+      // within the reference element corresponding to each search location in
+      // `localCoord', concatenated: [p1u, p1v, p1w, p2u, ...]. If `dim' is >= 0,
+      // only search for elements of the given dimension. If `strict' is not set,
+      // use a tolerance to find elements near the search locations.
+      GMSH_API void getElementsForCoordinates(const std::vector<double> & coord,
+                                              std::vector<std::size_t> & elementTags,
+                                              std::vector<double> & localCoord,
+                                              const int dim = -1,
+                                              const bool strict = false);
+
       // gmsh::model::mesh::getLocalCoordinatesInElement
       //
       // Return the local coordinates (`u', `v', `w') within the element
@@ -1824,6 +1840,17 @@ namespace gmsh { // Top-level functions
                                  const std::string & option,
                                  std::vector<double> & value);
 
+        // gmsh::model::mesh::field::evaluate
+        //
+        // Evaluate the field `tag' at the points given by their coordinates
+        // `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. Return the (scalar)
+        // field value at each point in `values'. The field is evaluated on all the
+        // points at once, which is much faster than point-by-point evaluation for
+        // most fields.
+        GMSH_API void evaluate(const int tag,
+                               const std::vector<double> & coord,
+                               std::vector<double> & values);
+
         // gmsh::model::mesh::field::setAsBackgroundMesh
         //
         // Set the field `tag' as the background mesh size field.
@@ -3476,6 +3503,29 @@ namespace gmsh { // Top-level functions
                         const std::vector<double> & zElemCoord = std::vector<double>(),
                         const int dim = -1);
 
+    // gmsh::view::probePoints
+    //
+    // Probe the view `tag' for its values at the points given by their coordinates
+    // `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. The points are probed
+    // concurrently, in an order that preserves spatial locality, which is much
+    // faster than calling `probe' for each point. Return the values in `values',
+    // concatenated for all the points: the number of values per point is the
+    // number of components (`numComp' if positive, or the number of components of
+    // the view otherwise), multiplied by the number of steps (or by 1 if `step' is
+    // positive) and by 3 if `gradient' is set. Return the distance to the match
+    // for each point in `distances', or -1 if no match is found (in which case the
+    // values for the point are set to zero). See `probe' for the meaning of
+    // `distanceMax' and `dim'.
+    GMSH_API void probePoints(const int tag,
+                              const std::vector<double> & coord,
+                              std::vector<double> & values,
+                              std::vector<double> & distances,
+                              const int step = -1,
+                              const int numComp = -1,
+                              const bool gradient = false,
+                              const double distanceMax = 0.,
+                              const int dim = -1);
+
     // gmsh::view::write
     //
     // Write the view to a file `fileName'. The export format is determined by the
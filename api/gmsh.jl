@@ -1922,6 +1922,36 @@ function getElementsByCoordinates(x, y, z, dim = -1, strict = false)
 end
 const get_elements_by_coordinates = getElementsByCoordinates
 
+"""
+    gmsh.model.mesh.getElementsForCoordinates(coord, dim = -1, strict = false)
+
+Search the mesh for the elements located at the coordinates `coord` of a batch
+of points, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are searched
+concurrently. Return the tag of the element found for each point in
+`elementTags` (0 if no element is found), and the local coordinates within the
+reference element corresponding to each search location in `localCoord`,
+concatenated: [p1u, p1v, p1w, p2u, ...]. If `dim` is >= 0, only search for
+elements of the given dimension. If `strict` is not set, use a tolerance to find
+elements near the search locations.
+
+Return `elementTags`, `localCoord`.
+"""
+function getElementsForCoordinates(coord, dim = -1, strict = false)
+    api_elementTags_ = Ref{Ptr{Csize_t}}()
+    api_elementTags_n_ = Ref{Csize_t}()
+    api_localCoord_ = Ref{Ptr{Cdouble}}()
+    api_localCoord_n_ = Ref{Csize_t}()
+    ierr = Ref{Cint}()
+    ccall((:gmshModelMeshGetElementsForCoordinates, gmsh.lib), Cvoid,
+          (Ptr{Cdouble}, Csize_t, Ptr{Ptr{Csize_t}}, Ptr{Csize_t}, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Cint, Cint, Ptr{Cint}),
+          convert(Vector{Cdouble}, coord), length(coord), api_elementTags_, api_elementTags_n_, api_localCoord_, api_localCoord_n_, dim, strict, ierr)
+    ierr[] != 0 && error(gmsh.logger.getLastError())
+    elementTags = unsafe_wrap(Array, api_elementTags_[], api_elementTags_n_[], own = true)
+    localCoord = unsafe_wrap(Array, api_localCoord_[], api_localCoord_n_[], own = true)
+    return elementTags, localCoord
+end
+const get_elements_for_coordinates = getElementsForCoordinates
+
 """
     gmsh.model.mesh.getLocalCoordinatesInElement(elementTag, x, y, z)
 
@@ -3724,6 +3754,28 @@ function getNumbers(tag, option)
 end
 const get_numbers = getNumbers
 
+"""
+    gmsh.model.mesh.field.evaluate(tag, coord)
+
+Evaluate the field `tag` at the points given by their coordinates `coord`,
+concatenated: [p1x, p1y, p1z, p2x, ...]. Return the (scalar) field value at each
+point in `values`. The field is evaluated on all the points at once, which is
+much faster than point-by-point evaluation for most fields.
+
+Return `values`.
+"""
+function evaluate(tag, coord)
+    api_values_ = Ref{Ptr{Cdouble}}()
+    api_values_n_ = Ref{Csize_t}()
+    ierr = Ref{Cint}()
+    ccall((:gmshModelMeshFieldEvaluate, gmsh.lib), Cvoid,
+          (Cint, Ptr{Cdouble}, Csize_t, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Ptr{Cint}),
+          tag, convert(Vector{Cdouble}, coord), length(coord), api_values_, api_values_n_, ierr)
+    ierr[] != 0 && error(gmsh.logger.getLastError())
+    values = unsafe_wrap(Array, api_values_[], api_values_n_[], own = true)
+    return values
+end
+
 """
     gmsh.model.mesh.field.setAsBackgroundMesh(tag)
 
@@ -6614,6 +6666,38 @@ function probe(tag, x, y, z, step = -1, numComp = -1, gradient = false, distance
     return value, api_distance_[]
 end
 
+"""
+    gmsh.view.probePoints(tag, coord, step = -1, numComp = -1, gradient = false, distanceMax = 0., dim = -1)
+
+Probe the view `tag` for its values at the points given by their coordinates
+`coord`, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are probed
+concurrently, in an order that preserves spatial locality, which is much faster
+than calling `probe` for each point. Return the values in `values`, concatenated
+for all the points: the number of values per point is the number of components
+(`numComp` if positive, or the number of components of the view otherwise),
+multiplied by the number of steps (or by 1 if `step` is positive) and by 3 if
+`gradient` is set. Return the distance to the match for each point in
+`distances`, or -1 if no match is found (in which case the values for the point
+are set to zero). See `probe` for the meaning of `distanceMax` and `dim`.
+
+Return `values`, `distances`.
+"""
+function probePoints(tag, coord, step = -1, numComp = -1, gradient = false, distanceMax = 0., dim = -1)
+    api_values_ = Ref{Ptr{Cdouble}}()
+    api_values_n_ = Ref{Csize_t}()
+    api_distances_ = Ref{Ptr{Cdouble}}()
+    api_distances_n_ = Ref{Csize_t}()
+    ierr = Ref{Cint}()
+    ccall((:gmshViewProbePoints, gmsh.lib), Cvoid,
+          (Cint, Ptr{Cdouble}, Csize_t, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Cint, Cint, Cint, Cdouble, Cint, Ptr{Cint}),
+          tag, convert(Vector{Cdouble}, coord), length(coord), api_values_, api_values_n_, api_distances_, api_distances_n_, step, numComp, gradient, distanceMax, dim, ierr)
+    ierr[] != 0 && error(gmsh.logger.getLastError())
+    values = unsafe_wrap(Array, api_values_[], api_values_n_[], own = true)
+    distances = unsafe_wrap(Array, api_distances_[], api_distances_n_[], own = true)
+    return values, distances
+end
+const probe_points = probePoints
+
 """
     gmsh.view.write(tag, fileName, append = false)
 
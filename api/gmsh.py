@@ -2284,6 +2284,40 @@ class model:
             return _ovectorsize(api_elementTags_, api_elementTags_n_.value)
         get_elements_by_coordinates = getElementsByCoordinates
 
+        @staticmethod
+        def getElementsForCoordinates(coord, dim=-1, strict=False):
+            """
+            gmsh.model.mesh.getElementsForCoordinates(coord, dim=-1, strict=False)
+
+            Search the mesh for the elements located at the coordinates `coord' of a
+            batch of points, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are
+            searched concurrently. Return the tag of the element found for each point
+            in `elementTags' (0 if no element is found), and the local coordinates
+            within the reference element corresponding to each search location in
+            `localCoord', concatenated: [p1u, p1v, p1w, p2u, ...]. If `dim' is >= 0,
+            only search for elements of the given dimension. If `strict' is not set,
+            use a tolerance to find elements near the search locations.
+
+            Return `elementTags', `localCoord'.
+            """
+            api_coord_, api_coord_n_ = _ivectordouble(coord)
+            api_elementTags_, api_elementTags_n_ = POINTER(c_size_t)(), c_size_t()
+            api_localCoord_, api_localCoord_n_ = POINTER(c_double)(), c_size_t()
+            ierr = c_int()
+            lib.gmshModelMeshGetElementsForCoordinates(
+                api_coord_, api_coord_n_,
+                byref(api_elementTags_), byref(api_elementTags_n_),
+                byref(api_localCoord_), byref(api_localCoord_n_),
+                c_int(dim),
+                c_int(bool(strict)),
+                byref(ierr))
+            if ierr.value != 0:
+                raise Exception(logger.getLastError())
+            return (
+                _ovectorsize(api_elementTags_, api_elementTags_n_.value),
+                _ovectordouble(api_localCoord_, api_localCoord_n_.value))
+        get_elements_for_coordinates = getElementsForCoordinates
+
         @staticmethod
         def getLocalCoordinatesInElement(elementTag, x, y, z):
             """
@@ -4292,6 +4326,30 @@ class model:
                 return _ovectordouble(api_value_, api_value_n_.value)
             get_numbers = getNumbers
 
+            @staticmethod
+            def evaluate(tag, coord):
+                """
+                gmsh.model.mesh.field.evaluate(tag, coord)
+
+                Evaluate the field `tag' at the points given by their coordinates `coord',
+                concatenated: [p1x, p1y, p1z, p2x, ...]. Return the (scalar) field value at
+                each point in `values'. The field is evaluated on all the points at once,
+                which is much faster than point-by-point evaluation for most fields.
+
+                Return `values'.
+                """
+                api_coord_, api_coord_n_ = _ivectordouble(coord)
+                api_values_, api_values_n_ = POINTER(c_double)(), c_size_t()
+                ierr = c_int()
+                lib.gmshModelMeshFieldEvaluate(
+                    c_int(tag),
+                    api_coord_, api_coord_n_,
+                    byref(api_values_), byref(api_values_n_),
+                    byref(ierr))
+                if ierr.value != 0:
+                    raise Exception(logger.getLastError())
+                return _ovectordouble(api_values_, api_values_n_.value)
+
             @staticmethod
             def setAsBackgroundMesh(tag):
                 """
@@ -7672,6 +7730,47 @@ class view:
             _ovectordouble(api_value_, api_value_n_.value),
             api_distance_.value)
 
+    @staticmethod
+    def probePoints(tag, coord, step=-1, numComp=-1, gradient=False, distanceMax=0., dim=-1):
+        """
+        gmsh.view.probePoints(tag, coord, step=-1, numComp=-1, gradient=False, distanceMax=0., dim=-1)
+
+        Probe the view `tag' for its values at the points given by their
+        coordinates `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. The points
+        are probed concurrently, in an order that preserves spatial locality, which
+        is much faster than calling `probe' for each point. Return the values in
+        `values', concatenated for all the points: the number of values per point
+        is the number of components (`numComp' if positive, or the number of
+        components of the view otherwise), multiplied by the number of steps (or by
+        1 if `step' is positive) and by 3 if `gradient' is set. Return the distance
+        to the match for each point in `distances', or -1 if no match is found (in
+        which case the values for the point are set to zero). See `probe' for the
+        meaning of `distanceMax' and `dim'.
+
+        Return `values', `distances'.
+        """
+        api_coord_, api_coord_n_ = _ivectordouble(coord)
+        api_values_, api_values_n_ = POINTER(c_double)(), c_size_t()
+        api_distances_, api_distances_n_ = POINTER(c_double)(), c_size_t()
+        ierr = c_int()
+        lib.gmshViewProbePoints(
+            c_int(tag),
+            api_coord_, api_coord_n_,
+            byref(api_values_), byref(api_values_n_),
+            byref(api_distances_), byref(api_distances_n_),
+            c_int(step),
+            c_int(numComp),
+            c_int(bool(gradient)),
+            c_double(distanceMax),
+            c_int(dim),
+            byref(ierr))
+        if ierr.value != 0:
+            raise Exception(logger.getLastError())
+        return (
+            _ovectordouble(api_values_, api_values_n_.value),
+            _ovectordouble(api_distances_, api_distances_n_.value))
+    probe_points = probePoints
+
     @staticmethod
     def write(tag, fileName, append=False):
         """
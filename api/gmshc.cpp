@@ -1287,6 +1287,22 @@ GMSH_API void gmshModelMeshGetElementsByCoordinates(const double x, const double
   }
 }
 
+GMSH_API void gmshModelMeshGetElementsForCoordinates(const double * coord, const size_t coord_n, size_t ** elementTags, size_t * elementTags_n, double ** localCoord, size_t * localCoord_n, const int dim, const int strict, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    std::vector<double> api_coord_(coord, coord + coord_n);
+    std::vector<std::size_t> api_elementTags_;
+    std::vector<double> api_localCoord_;
+    gmsh::model::mesh::getElementsForCoordinates(api_coord_, api_elementTags_, api_localCoord_, dim, strict);
+    vector2ptr(api_elementTags_, elementTags, elementTags_n);
+    vector2ptr(api_localCoord_, localCoord, localCoord_n);
+  }
+  catch(...){
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmshModelMeshGetLocalCoordinatesInElement(const size_t elementTag, const double x, const double y, const double z, double * u, double * v, double * w, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -2486,6 +2502,20 @@ GMSH_API void gmshModelMeshFieldGetNumbers(const int tag, const char * option, d
   }
 }
 
+GMSH_API void gmshModelMeshFieldEvaluate(const int tag, const double * coord, const size_t coord_n, double ** values, size_t * values_n, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    std::vector<double> api_coord_(coord, coord + coord_n);
+    std::vector<double> api_values_;
+    gmsh::model::mesh::field::evaluate(tag, api_coord_, api_values_);
+    vector2ptr(api_values_, values, values_n);
+  }
+  catch(...){
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmshModelMeshFieldSetAsBackgroundMesh(const int tag, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -4337,6 +4367,22 @@ GMSH_API void gmshViewProbe(const int tag, const double x, const double y, const
   }
 }
 
+GMSH_API void gmshViewProbePoints(const int tag, const double * coord, const size_t coord_n, double ** values, size_t * values_n, double ** distances, size_t * distances_n, const int step, const int numComp, const int gradient, const double distanceMax, const int dim, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    std::vector<double> api_coord_(coord, coord + coord_n);
+    std::vector<double> api_values_;
+    std::vector<double> api_distances_;
+    gmsh::view::probePoints(tag, api_coord_, api_values_, api_distances_, step, numComp, gradient, distanceMax, dim);
+    vector2ptr(api_values_, values, values_n);
+    vector2ptr(api_distances_, distances, distances_n);
+  }
+  catch(...){
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmshViewWrite(const int tag, const char * fileName, const int append, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -782,6 +782,21 @@ GMSH_API void gmshModelMeshGetElementsByCoordinates(const double x,
                                                     const int strict,
                                                     int * ierr);
 
+/* Search the mesh for the elements located at the coordinates `coord' of a
+ * batch of points, concatenated: [p1x, p1y, p1z, p2x, ...]. The points are
+ * searched concurrently. Return the tag of the element found for each point
+ * in `elementTags' (0 if no element is found), and the local coordinates
+ * within the reference element corresponding to each search location in
+ * `localCoord', concatenated: [p1u, p1v, p1w, p2u, ...]. If `dim' is >= 0,
+ * only search for elements of the given dimension. If `strict' is not set,
+ * use a tolerance to find elements near the search locations. */
+GMSH_API void gmshModelMeshGetElementsForCoordinates(const double * coord, const size_t coord_n,
+                                                     size_t ** elementTags, size_t * elementTags_n,
+                                                     double ** localCoord, size_t * localCoord_n,
+                                                     const int dim,
+                                                     const int strict,
+                                                     int * ierr);
+
 /* Return the local coordinates (`u', `v', `w') within the element
  * `elementTag' corresponding to the model coordinates (`x', `y', `z'). This
  * function relies on an internal cache (a vector in case of dense element
@@ -1606,6 +1621,15 @@ GMSH_API void gmshModelMeshFieldGetNumbers(const int tag,
                                            double ** value, size_t * value_n,
                                            int * ierr);
 
+/* Evaluate the field `tag' at the points given by their coordinates `coord',
+ * concatenated: [p1x, p1y, p1z, p2x, ...]. Return the (scalar) field value at
+ * each point in `values'. The field is evaluated on all the points at once,
+ * which is much faster than point-by-point evaluation for most fields. */
+GMSH_API void gmshModelMeshFieldEvaluate(const int tag,
+                                         const double * coord, const size_t coord_n,
+                                         double ** values, size_t * values_n,
+                                         int * ierr);
+
 /* Set the field `tag' as the background mesh size field. */
 GMSH_API void gmshModelMeshFieldSetAsBackgroundMesh(const int tag,
                                                     int * ierr);
@@ -3095,6 +3119,28 @@ GMSH_API void gmshViewProbe(const int tag,
                             const int dim,
                             int * ierr);
 
+/* Probe the view `tag' for its values at the points given by their
+ * coordinates `coord', concatenated: [p1x, p1y, p1z, p2x, ...]. The points
+ * are probed concurrently, in an order that preserves spatial locality, which
+ * is much faster than calling `probe' for each point. Return the values in
+ * `values', concatenated for all the points: the number of values per point
+ * is the number of components (`numComp' if positive, or the number of
+ * components of the view otherwise), multiplied by the number of steps (or by
+ * 1 if `step' is positive) and by 3 if `gradient' is set. Return the distance
+ * to the match for each point in `distances', or -1 if no match is found (in
+ * which case the values for the point are set to zero). See `probe' for the
+ * meaning of `distanceMax' and `dim'. */
+GMSH_API void gmshViewProbePoints(const int tag,
+                                  const double * coord, const size_t coord_n,
+                                  double ** values, size_t * values_n,
+                                  double ** distances, size_t * distances_n,
+                                  const int step,
+                                  const int numComp,
+                                  const int gradient,
+                                  const double distanceMax,
+                                  const int dim,
+                                  int * ierr);
+
 /* Write the view to a file `fileName'. The export format is determined by the
  * file extension. Append to the file if `append' is set. */
 GMSH_API void gmshViewWrite(const int tag,
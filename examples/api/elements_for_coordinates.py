@@ -0,0 +1,30 @@
+import gmsh
+import sys
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.occ.addBox(0, 0, 0, 1, 1, 1)
+gmsh.model.occ.synchronize()
+gmsh.option.setNumber("Mesh.MeshSizeMax", 0.1)
+gmsh.model.mesh.generate(3)
+
+# locate a batch of points in the mesh at once: the points are given by their
+# concatenated coordinates [p1x, p1y, p1z, p2x, ...], and are searched
+# concurrently; the last point is outside of the mesh
+coord = [0.1, 0.2, 0.3, 0.5, 0.5, 0.5, 0.9, 0.8, 0.7, 2, 2, 2]
+tags, uvw = gmsh.model.mesh.getElementsForCoordinates(coord, dim=3)
+
+for i in range(len(tags)):
+    if tags[i]:
+        print("Point {} is in element {} (u, v, w = {})".format(
+            coord[3 * i:3 * i + 3], tags[i], uvw[3 * i:3 * i + 3]))
+    else:
+        print("Point {} is not in the mesh".format(coord[3 * i:3 * i + 3]))
+
+# the nodes of the elements can then be retrieved one by one
+_, nodeTags, _, _ = gmsh.model.mesh.getElement(tags[0])
+for n in nodeTags:
+    xyz, _, dim, tag = gmsh.model.mesh.getNode(n)
+    print("Node {}: {} on entity ({}, {})".format(n, list(xyz), dim, tag))
+
+gmsh.finalize()
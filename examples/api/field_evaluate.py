@@ -0,0 +1,33 @@
+import gmsh
+import sys
+
+gmsh.initialize(sys.argv)
+
+# mesh size fields can be evaluated directly through the API, e.g. to inspect
+# them or to use them outside of the mesh generator
+p = gmsh.model.geo.addPoint(0, 0, 0)
+gmsh.model.geo.synchronize()
+
+f1 = gmsh.model.mesh.field.add("Distance")
+gmsh.model.mesh.field.setNumbers(f1, "PointsList", [p])
+
+f2 = gmsh.model.mesh.field.add("Threshold")
+gmsh.model.mesh.field.setNumber(f2, "InField", f1)
+gmsh.model.mesh.field.setNumber(f2, "SizeMin", 0.1)
+gmsh.model.mesh.field.setNumber(f2, "SizeMax", 1)
+gmsh.model.mesh.field.setNumber(f2, "DistMin", 0.5)
+gmsh.model.mesh.field.setNumber(f2, "DistMax", 2)
+
+# the points are given by their concatenated coordinates [p1x, p1y, p1z, p2x,
+# ...], and are all evaluated at once, which is much faster than evaluating
+# them one by one
+N = 10
+coord = []
+for i in range(N):
+    coord.extend([3. * i / (N - 1), 0, 0])
+sizes = gmsh.model.mesh.field.evaluate(f2, coord)
+
+for i in range(N):
+    print("Mesh size at x = {:.2f}: {:.3f}".format(coord[3 * i], sizes[i]))
+
+gmsh.finalize()
@@ -0,0 +1,37 @@
+import gmsh
+import sys
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("incremental_meshing")
+
+
+# a unit cube with its corner at (x0, 0, 0)
+def cube(x0, lc):
+    geo = gmsh.model.geo
+    p = [geo.addPoint(x0 + dx, dy, 0, lc)
+         for dx, dy in [(0, 0), (1, 0), (1, 1), (0, 1)]]
+    l = [geo.addLine(p[i], p[(i + 1) % 4]) for i in range(4)]
+    s = geo.addPlaneSurface([geo.addCurveLoop(l)])
+    e = geo.extrude([(2, s)], 0, 0, 1)
+    return e[1][1]
+
+
+v1 = cube(0, 0.2)
+v2 = cube(2, 0.2)
+gmsh.model.geo.synchronize()
+
+# with Mesh.Incremental, a new mesh generation only remeshes (and optimizes) the
+# entities that changed since the previous one
+gmsh.option.setNumber("Mesh.Incremental", 1)
+gmsh.model.mesh.generate(3)
+
+# refine the second cube: the mesh of the first cube is kept as is
+pts = gmsh.model.getBoundary([(3, v2)], recursive=True)
+gmsh.model.mesh.setSize(pts, 0.1)
+gmsh.model.mesh.generate(3)
+
+if '-nopopup' not in sys.argv:
+    gmsh.fltk.run()
+
+gmsh.finalize()
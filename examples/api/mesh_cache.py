@@ -0,0 +1,38 @@
+import gmsh
+import re
+import sys
+import tempfile
+
+gmsh.initialize(sys.argv)
+
+
+def mesh():
+    gmsh.model.add("mesh_cache")
+    gmsh.model.occ.addSphere(0, 0, 0, 1)
+    gmsh.model.occ.synchronize()
+    gmsh.option.setNumber("Mesh.MeshSizeMax", 0.2)
+    gmsh.logger.start()
+    gmsh.model.mesh.generate(3)
+    log = gmsh.logger.get()
+    gmsh.logger.stop()
+    gmsh.model.remove()
+    # the number of meshes loaded from the cache is printed after meshing
+    hits = [int(m.group(1)) for m in
+            [re.search(r"Mesh cache: (\d+) hit", l) for l in log] if m]
+    return hits[0] if hits else 0
+
+
+# with Mesh.CacheDirectory, the meshes of the entities are stored on disk: the
+# first run saves them, and the second run loads them instead of meshing the
+# entities again
+with tempfile.TemporaryDirectory() as cache:
+    gmsh.option.setString("Mesh.CacheDirectory", cache)
+    print("First run: {} meshes loaded from the cache".format(mesh()))
+    hits = mesh()
+    print("Second run: {} meshes loaded from the cache".format(hits))
+    gmsh.option.setString("Mesh.CacheDirectory", "")
+
+gmsh.finalize()
+
+if hits == 0:
+    sys.exit("The second run did not use the cache")
@@ -0,0 +1,35 @@
+import gmsh
+import os
+import sys
+import tempfile
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("msh_file_mapping")
+gmsh.model.occ.addBox(0, 0, 0, 1, 1, 1)
+gmsh.model.occ.synchronize()
+gmsh.option.setNumber("Mesh.MeshSizeMax", 0.1)
+gmsh.model.mesh.generate(3)
+
+name = os.path.join(tempfile.gettempdir(), "msh_file_mapping.msh")
+gmsh.option.setNumber("Mesh.Binary", 1)
+gmsh.write(name)
+
+# with Mesh.MshFileMapping, a binary MSH file is mapped in memory when it is
+# opened (other MSH 4.1 files are read in compact arrays): the nodes and
+# elements are only created when needed. Only a few API functions (getNodes
+# without boundary nodes, getNode, getElementTypes and getElementsByType)
+# directly use the mapped data; all the other functions (and meshing) first
+# create the whole mesh
+gmsh.clear()
+gmsh.option.setNumber("Mesh.MshFileMapping", 1)
+gmsh.open(name)
+
+xyz, _, dim, tag = gmsh.model.mesh.getNode(1)
+print("Node 1: {} on entity ({}, {})".format(list(xyz), dim, tag))
+tags, _, _ = gmsh.model.mesh.getNodes(3, 1)
+print("{} nodes inside the volume".format(len(tags)))
+
+os.remove(name)
+
+gmsh.finalize()
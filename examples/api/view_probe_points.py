@@ -0,0 +1,34 @@
+import gmsh
+import sys
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("view_probe_points")
+gmsh.model.occ.addRectangle(0, 0, 0, 1, 1)
+gmsh.model.occ.synchronize()
+gmsh.option.setNumber("Mesh.MeshSizeMax", 0.05)
+gmsh.model.mesh.generate(2)
+
+# create a view with the value x + 2 y at the nodes
+nodeTags, coord, _ = gmsh.model.mesh.getNodes()
+data = [[coord[3 * i] + 2 * coord[3 * i + 1]] for i in range(len(nodeTags))]
+v = gmsh.view.add("f")
+gmsh.view.addModelData(v, 0, "view_probe_points", "NodeData", nodeTags, data)
+
+# probe the view at a batch of points at once: the points are given by their
+# concatenated coordinates [p1x, p1y, p1z, p2x, ...], and are probed
+# concurrently, which is much faster than calling gmsh.view.probe() for each
+# point; the last point is outside of the mesh
+points = [0.1, 0.1, 0, 0.5, 0.25, 0, 0.9, 0.6, 0, 2, 2, 0]
+values, distances = gmsh.view.probePoints(v, points)
+
+for i in range(len(distances)):
+    if distances[i] < 0:
+        print("Point {} is not in the mesh".format(points[3 * i:3 * i + 3]))
+    else:
+        print("Value at {}: {}".format(points[3 * i:3 * i + 3], values[i]))
+
+if '-nopopup' not in sys.argv:
+    gmsh.fltk.run()
+
+gmsh.finalize()
@@ -25,7 +25,7 @@ struct contextMeshOptions {
   double lcMin, lcMax, toleranceEdgeLength, toleranceInitialDelaunay;
   double anisoMax, smoothRatio;
   int lcFromPoints, lcFromParametricPoints, lcFromCurvature, lcFromCurvatureIso;
-  int lcExtendFromBoundary;
+  int lcExtendFromBoundary, lcCache;
   int nbSmoothing, algo2d, algo3d, algoSubdivide, algoSwitchOnFailure;
   int algoRecombine, recombineAll, recombineOptimizeTopology;
   int recombineNodeRepositioning;
@@ -43,7 +43,9 @@ struct contextMeshOptions {
   double hoMaxRho, hoMaxAngle, hoMaxInnerAngle;
   int NewtonConvergenceTestXYZ, maxIterDelaunay3D;
   int ignorePeriodicityMsh2, ignoreParametrizationMsh4, boundaryLayerFanElements;
-  int maxNumThreads1D, maxNumThreads2D, maxNumThreads3D;
+  int maxNumThreads1D, maxNumThreads2D, maxNumThreads3D, pipelineMeshing;
+  int concurrentRefinement3D, domainDecomposition3D, incremental;
+  std::string cacheDirectory;
   double angleToleranceFacetOverlap, toleranceReferenceElement;
   int renumber, compoundClassify, reparamMaxTriangles;
   double compoundLcFactor;
@@ -58,7 +60,7 @@ struct contextMeshOptions {
   double mshFileVersion, medFileMinorVersion, scalingFactor;
   int medImportGroupsOfNodes, medSingleModel;
   int saveAll, saveTri, saveGroupsOfNodes, saveGroupsOfElements;
-  int readGroupsOfElements;
+  int readGroupsOfElements, mshFileMapping;
   int binary, bdfFieldFormat;
   int unvStrictFormat, stlRemoveDuplicateTriangles, stlOneSolidPerSurface;
   double stlLinearDeflection, stlAngularDeflection;
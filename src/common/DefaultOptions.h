@@ -168,6 +168,11 @@ StringXString GeometryOptions_String[] = {
 } ;
 
 StringXString MeshOptions_String[] = {
+  { F|O, "CacheDirectory" , opt_mesh_cache_directory , "" ,
+    "Directory of the persistent mesh cache, where the meshes of the curves, "
+    "surfaces and volumes are stored and reused when the same entities are "
+    "meshed again with the same options (leave empty to disable the cache)" },
+
   { 0, nullptr , nullptr , "" , nullptr }
 } ;
 
@@ -1136,11 +1141,20 @@ StringXNumber MeshOptions_Number[] = {
     "[Deprecated]" },
   { F|O, "CompoundMeshSizeFactor" , opt_mesh_compound_lc_factor , 0.5 ,
     "Mesh size factor applied to compound parts" },
+  { F|O, "ConcurrentRefinement3D" , opt_mesh_concurrent_refinement_3d , 0. ,
+    "Refine 3D Delaunay meshes by inserting batches of nodes concurrently; the "
+    "mesh does not depend on the number of threads, but differs from the mesh "
+    "obtained without this option" },
   { F,   "CpuTime" , opt_mesh_cpu_time , 0. ,
     "CPU time (in seconds) for the generation of the current mesh (read-only)" },
   { F|O, "CreateTopologyMsh2" , opt_mesh_create_topology_msh2, 0. ,
     "Attempt to (re)create the model topology when reading MSH2 files" },
 
+  { F|O, "DomainDecomposition3D" , opt_mesh_domain_decomposition_3d , 20000 ,
+    "Minimum number of tetrahedra in the initial mesh of a volume for its "
+    "concurrent Delaunay refinement (see Mesh.ConcurrentRefinement3D) to start "
+    "by refining subdomains independently (0: never decompose; surfaces are "
+    "never decomposed)" },
   { F|O, "DrawSkinOnly" , opt_mesh_draw_skin_only , 0. ,
     "Draw only the skin of 3D meshes?" },
   { F|O, "Dual" , opt_mesh_dual , 0. ,
@@ -1217,6 +1231,9 @@ StringXNumber MeshOptions_Number[] = {
   { F|O, "IgnorePeriodicity" , opt_mesh_ignore_periodicity , 1. ,
     "Skip periodic node section and skip periodic boundary alignment step when "
     "reading meshes in the MSH2 format." },
+  { F|O, "Incremental" , opt_mesh_incremental , 0. ,
+    "Only remesh the entities whose geometry, mesh constraints or boundary mesh "
+    "changed since the last mesh generation, and keep the mesh of the others" },
 
   { F|O, "LabelSampling" , opt_mesh_label_sampling , 1. ,
     "Label sampling rate (display one label every `LabelSampling' elements)" },
@@ -1256,6 +1273,10 @@ StringXNumber MeshOptions_Number[] = {
     "Mesh only visible entities (experimental)" },
   { F|O, "MeshOnlyEmpty" , opt_mesh_mesh_only_empty, 0. ,
     "Mesh only entities that have no existing mesh" },
+  { F|O, "MeshSizeCache" , opt_mesh_lc_cache, 0. ,
+    "Cache the mesh element sizes evaluated at mesh nodes during a meshing step, "
+    "which avoids re-evaluating costly mesh size fields at nodes that have not "
+    "moved (experimental)" },
   { F|O, "MeshSizeExtendFromBoundary" , opt_mesh_lc_extend_from_boundary, 1. ,
     "Extend computation of mesh element sizes from the boundaries into the interior "
     "(0: never; 1: for surfaces and volumes; 2: for surfaces and volumes, but use "
@@ -1305,6 +1326,12 @@ StringXNumber MeshOptions_Number[] = {
     "[Deprecated]"},
   { F|O, "MinimumElementsPerTwoPi" , opt_mesh_lc_from_curvature, 0. ,
     "[Deprecated]" },
+  { F|O, "MshFileMapping" , opt_mesh_msh_file_mapping , 0. ,
+    "Map binary MSH4 files in memory when they are read (or read other MSH 4.1 "
+    "files in compact arrays), and only create the nodes and elements when "
+    "needed: the API functions getNodes (without boundary nodes), getNode, "
+    "getElementTypes and getElementsByType directly use the mapped data "
+    "(experimental)" },
   { F|O, "MshFileVersion" , opt_mesh_msh_file_version , 4.1 ,
     "Version of the MSH file format to use" },
   { F|O, "MedFileMinorVersion" , opt_mesh_med_file_minor_version , -1. ,
@@ -1392,6 +1419,10 @@ StringXNumber MeshOptions_Number[] = {
   { F|O, "PartitionConvertMsh2" , opt_mesh_partition_convert_msh2 , 1 ,
     "When reading partitioned meshes in MSH2 format, create new partition "
     "entities"},
+  { F|O, "PipelineMeshing" , opt_mesh_pipeline_meshing , 0. ,
+    "Mesh curves and surfaces in a single multi-threaded pass, starting the "
+    "meshing of each surface as soon as its bounding curves are meshed "
+    "(experimental)" },
   { F|O|D, "Points" , opt_mesh_nodes , 0. ,
     "[Deprecated]" },
   { F|O|D, "PointNumbers" , opt_mesh_node_labels , 0. ,
@@ -295,6 +295,10 @@ int GmshBatch()
       MergeFile(CTX::instance()->files[i]);
   }
 
+  // a mapped mesh can only be used through the API (see Mesh.MshFileMapping)
+  for(std::size_t i = 0; i < GModel::list.size(); i++)
+    GModel::list[i]->materializeMappedMesh();
+
 #if defined(HAVE_POST) && defined(HAVE_MESH)
   if(!CTX::instance()->bgmFileName.empty()) {
     if(CTX::instance()->bgmFileName.substr(
@@ -37,8 +37,10 @@
 
 #if !defined(WIN32) || defined(__CYGWIN__)
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
 #endif
 
 #if defined(WIN32)
@@ -726,3 +728,53 @@ void UnzipFile(const std::string &fileName, const std::string &prependDir)
   Msg::Error("Gmsh must be compiled with Zipper support to extract zip files");
 #endif
 }
+
+const char *MapFile(const std::string &fileName, std::size_t &size)
+{
+  // map the whole file read-only in memory; the pages are loaded lazily by the
+  // operating system when they are accessed
+  size = 0;
+#if defined(WIN32) && !defined(__CYGWIN__)
+  setwbuf(0, fileName.c_str());
+  HANDLE file = CreateFileW(wbuf[0], GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(file == INVALID_HANDLE_VALUE) return nullptr;
+  LARGE_INTEGER fileSize;
+  if(!GetFileSizeEx(file, &fileSize) || !fileSize.QuadPart) {
+    CloseHandle(file);
+    return nullptr;
+  }
+  HANDLE mapping =
+    CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if(!mapping) return nullptr;
+  void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if(!data) return nullptr;
+  size = fileSize.QuadPart;
+  return (const char *)data;
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd < 0) return nullptr;
+  struct stat buf;
+  if(fstat(fd, &buf) || !buf.st_size) {
+    close(fd);
+    return nullptr;
+  }
+  void *data = mmap(nullptr, buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED) return nullptr;
+  size = buf.st_size;
+  return (const char *)data;
+#endif
+}
+
+void UnmapFile(const char *data, std::size_t size)
+{
+  if(!data) return;
+#if defined(WIN32) && !defined(__CYGWIN__)
+  UnmapViewOfFile(data);
+#else
+  munmap((void *)data, size);
+#endif
+}
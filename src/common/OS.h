@@ -32,5 +32,7 @@ int SystemCallExe(const std::string &exe, const std::string &argsOrCommand,
                   bool blocking = false);
 void RedirectIOToConsole();
 void UnzipFile(const std::string &fileName, const std::string &prependDir = "");
+const char *MapFile(const std::string &fileName, std::size_t &size);
+void UnmapFile(const char *data, std::size_t size);
 
 #endif
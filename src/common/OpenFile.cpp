@@ -501,6 +501,7 @@ int MergeFile(const std::string &fileName, bool errorIfMissing,
         GModel *tmp2 = GModel::current();
         GModel *tmp = new GModel();
         tmp->readMSH(fileName);
+        tmp->materializeMappedMesh();
         tmp->scaleMesh(CTX::instance()->geom.matchMeshScaleFactor);
         status = GeomMeshMatcher::instance()->match(tmp2, tmp);
         delete tmp;
@@ -549,6 +550,11 @@ int MergeFile(const std::string &fileName, bool errorIfMissing,
 
   if(importPhysicalsInOnelab) Msg::ImportPhysicalGroupsInOnelab();
 
+#if defined(HAVE_FLTK)
+  // a mapped mesh can only be used through the API (see Mesh.MshFileMapping)
+  if(FlGui::available()) GModel::current()->materializeMappedMesh();
+#endif
+
 #if defined(HAVE_FLTK) && defined(HAVE_POST)
   if(FlGui::available()) {
     // go directly to the first non-empty step after the one that is requested
@@ -1436,6 +1436,12 @@ std::string opt_geometry_pipe_default_trihedron(OPT_ARGS_STR)
   return CTX::instance()->geom.pipeDefaultTrihedron;
 }
 
+std::string opt_mesh_cache_directory(OPT_ARGS_STR)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.cacheDirectory = val;
+  return CTX::instance()->mesh.cacheDirectory;
+}
+
 std::string opt_solver_socket_name(OPT_ARGS_STR)
 {
   if(action & GMSH_SET) CTX::instance()->solver.socketName = val;
@@ -5123,6 +5129,12 @@ double opt_mesh_lc_extend_from_boundary(OPT_ARGS_NUM)
   return CTX::instance()->mesh.lcExtendFromBoundary;
 }
 
+double opt_mesh_lc_cache(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.lcCache = (int)val;
+  return CTX::instance()->mesh.lcCache;
+}
+
 double opt_mesh_lc_integration_precision(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) {
@@ -5678,6 +5690,12 @@ double opt_mesh_newton_convergence_test_xyz(OPT_ARGS_NUM)
   return CTX::instance()->mesh.NewtonConvergenceTestXYZ;
 }
 
+double opt_mesh_msh_file_mapping(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.mshFileMapping = (int)val;
+  return CTX::instance()->mesh.mshFileMapping;
+}
+
 double opt_mesh_msh_file_version(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.mshFileVersion = val;
@@ -6637,6 +6655,30 @@ double opt_mesh_max_num_threads_3d(OPT_ARGS_NUM)
   return CTX::instance()->mesh.maxNumThreads3D;
 }
 
+double opt_mesh_pipeline_meshing(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.pipelineMeshing = (int)val;
+  return CTX::instance()->mesh.pipelineMeshing;
+}
+
+double opt_mesh_concurrent_refinement_3d(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.concurrentRefinement3D = (int)val;
+  return CTX::instance()->mesh.concurrentRefinement3D;
+}
+
+double opt_mesh_domain_decomposition_3d(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.domainDecomposition3D = (int)val;
+  return CTX::instance()->mesh.domainDecomposition3D;
+}
+
+double opt_mesh_incremental(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.incremental = (int)val;
+  return CTX::instance()->mesh.incremental;
+}
+
 double opt_mesh_angle_tolerance_facet_overlap(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) {
@@ -69,6 +69,7 @@ std::string opt_geometry_double_clicked_surface_command(OPT_ARGS_STR);
 std::string opt_geometry_double_clicked_volume_command(OPT_ARGS_STR);
 std::string opt_geometry_occ_target_unit(OPT_ARGS_STR);
 std::string opt_geometry_pipe_default_trihedron(OPT_ARGS_STR);
+std::string opt_mesh_cache_directory(OPT_ARGS_STR);
 std::string opt_solver_socket_name(OPT_ARGS_STR);
 std::string opt_solver_name(OPT_ARGS_STR);
 std::string opt_solver_name0(OPT_ARGS_STR);
@@ -454,6 +455,7 @@ double opt_mesh_lc_from_curvature_iso(OPT_ARGS_NUM);
 double opt_mesh_lc_from_points(OPT_ARGS_NUM);
 double opt_mesh_lc_from_parametric_points(OPT_ARGS_NUM);
 double opt_mesh_lc_extend_from_boundary(OPT_ARGS_NUM);
+double opt_mesh_lc_cache(OPT_ARGS_NUM);
 double opt_mesh_lc_integration_precision(OPT_ARGS_NUM);
 double opt_mesh_rand_factor(OPT_ARGS_NUM);
 double opt_mesh_rand_factor3d(OPT_ARGS_NUM);
@@ -495,6 +497,7 @@ double opt_mesh_light_lines(OPT_ARGS_NUM);
 double opt_mesh_light_two_side(OPT_ARGS_NUM);
 double opt_mesh_file_format(OPT_ARGS_NUM);
 double opt_mesh_newton_convergence_test_xyz(OPT_ARGS_NUM);
+double opt_mesh_msh_file_mapping(OPT_ARGS_NUM);
 double opt_mesh_msh_file_version(OPT_ARGS_NUM);
 double opt_mesh_med_file_minor_version(OPT_ARGS_NUM);
 double opt_mesh_med_import_groups_of_nodes(OPT_ARGS_NUM);
@@ -611,6 +614,10 @@ double opt_mesh_max_iter_delaunay_3d(OPT_ARGS_NUM);
 double opt_mesh_max_num_threads_1d(OPT_ARGS_NUM);
 double opt_mesh_max_num_threads_2d(OPT_ARGS_NUM);
 double opt_mesh_max_num_threads_3d(OPT_ARGS_NUM);
+double opt_mesh_pipeline_meshing(OPT_ARGS_NUM);
+double opt_mesh_concurrent_refinement_3d(OPT_ARGS_NUM);
+double opt_mesh_domain_decomposition_3d(OPT_ARGS_NUM);
+double opt_mesh_incremental(OPT_ARGS_NUM);
 double opt_mesh_angle_tolerance_facet_overlap(OPT_ARGS_NUM);
 double opt_mesh_tolerance_reference_element(OPT_ARGS_NUM);
 double opt_mesh_renumber(OPT_ARGS_NUM);
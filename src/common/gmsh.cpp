@@ -13,6 +13,7 @@
 #include "GModel.h"
 #include "GModelIO_GEO.h"
 #include "GModelIO_OCC.h"
+#include "GModelIO_MSH4.h"
 #include "GVertex.h"
 #include "GEdge.h"
 #include "GFace.h"
@@ -69,6 +70,7 @@
 #include "meshGRegionDelaunayInsertion.h"
 #include "meshGRegionHxt.h"
 #include "gmshCrossFields.h"
+#include "qualityMeasuresJacobian.h"
 #endif
 
 #if defined(HAVE_POST)
@@ -110,7 +112,7 @@ static int _initialized = 0;
 static int _argc = 0;
 static char **_argv = nullptr;
 
-static bool _checkInit()
+static bool _checkInit(bool keepMappedMesh = false)
 {
   if(!_initialized) {
     CTX::instance()->terminal = 1;
@@ -121,6 +123,9 @@ static bool _checkInit()
     Msg::Error("Gmsh has no current model");
     return false;
   }
+  // unless the function can directly work on the data of a mapped mesh (see
+  // Mesh.MshFileMapping), create the actual nodes and elements
+  if(!keepMappedMesh) GModel::current()->materializeMappedMesh();
   return true;
 }
 
@@ -178,7 +183,7 @@ GMSH_API int gmsh::isInitialized()
 
 GMSH_API void gmsh::finalize()
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   if(GmshFinalize()) {
     _argc = 0;
     if(_argv) delete[] _argv;
@@ -212,7 +217,7 @@ GMSH_API void gmsh::write(const std::string &fileName)
 
 GMSH_API void gmsh::clear()
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   if(!GmshClearProject()) Msg::Error("Could not clear project");
 }
 
@@ -221,7 +226,7 @@ GMSH_API void gmsh::clear()
 GMSH_API void gmsh::option::setNumber(const std::string &name,
                                       const double value)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   std::string c, n;
   int i;
   SplitOptionName(name, c, n, i);
@@ -231,7 +236,7 @@ GMSH_API void gmsh::option::setNumber(const std::string &name,
 
 GMSH_API void gmsh::option::getNumber(const std::string &name, double &value)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   std::string c, n;
   int i;
   SplitOptionName(name, c, n, i);
@@ -242,7 +247,7 @@ GMSH_API void gmsh::option::getNumber(const std::string &name, double &value)
 GMSH_API void gmsh::option::setString(const std::string &name,
                                       const std::string &value)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   std::string c, n;
   int i;
   SplitOptionName(name, c, n, i);
@@ -253,7 +258,7 @@ GMSH_API void gmsh::option::setString(const std::string &name,
 GMSH_API void gmsh::option::getString(const std::string &name,
                                       std::string &value)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   std::string c, n;
   int i;
   SplitOptionName(name, c, n, i);
@@ -264,7 +269,7 @@ GMSH_API void gmsh::option::getString(const std::string &name,
 GMSH_API void gmsh::option::setColor(const std::string &name, const int r,
                                      const int g, const int b, const int a)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   std::string c, n;
   int i;
   SplitOptionName(name, c, n, i);
@@ -278,7 +283,7 @@ GMSH_API void gmsh::option::setColor(const std::string &name, const int r,
 GMSH_API void gmsh::option::getColor(const std::string &name, int &r, int &g,
                                      int &b, int &a)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   std::string c, n;
   int i;
   SplitOptionName(name, c, n, i);
@@ -300,7 +305,7 @@ GMSH_API void gmsh::option::getColor(const std::string &name, int &r, int &g,
 
 GMSH_API void gmsh::model::add(const std::string &name)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   GModel *m = new GModel(name);
   GModel::current(GModel::list.size() - 1);
   if(!m) Msg::Error("Could not add model '%s'", name.c_str());
@@ -308,7 +313,7 @@ GMSH_API void gmsh::model::add(const std::string &name)
 
 GMSH_API void gmsh::model::remove()
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   GModel *m = GModel::current();
   if(m)
     delete m;
@@ -318,20 +323,20 @@ GMSH_API void gmsh::model::remove()
 
 GMSH_API void gmsh::model::list(std::vector<std::string> &names)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   for(std::size_t i = 0; i < GModel::list.size(); i++)
     names.push_back(GModel::list[i]->getName());
 }
 
 GMSH_API void gmsh::model::getCurrent(std::string &name)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   name = GModel::current()->getName();
 }
 
 GMSH_API void gmsh::model::setCurrent(const std::string &name)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   GModel *m = GModel::findByName(name);
   if(!m) {
     Msg::Error("Could not find model '%s'", name.c_str());
@@ -358,7 +363,7 @@ GMSH_API void gmsh::model::setFileName(const std::string &fileName)
 
 GMSH_API void gmsh::model::getEntities(vectorpair &dimTags, const int dim)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   dimTags.clear();
   std::vector<GEntity *> entities;
   GModel::current()->getEntities(entities, dim);
@@ -377,13 +382,13 @@ GMSH_API void gmsh::model::setEntityName(const int dim, const int tag,
 GMSH_API void gmsh::model::getEntityName(const int dim, const int tag,
                                          std::string &name)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   name = GModel::current()->getElementaryName(dim, tag);
 }
 
 GMSH_API void gmsh::model::getPhysicalGroups(vectorpair &dimTags, const int dim)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   dimTags.clear();
   std::map<int, std::vector<GEntity *> > groups[4];
   GModel::current()->getPhysicalGroups(groups);
@@ -412,7 +417,7 @@ GMSH_API void gmsh::model::getEntitiesForPhysicalGroup(const int dim,
                                                        const int tag,
                                                        std::vector<int> &tags)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   tags.clear();
   std::map<int, std::vector<GEntity *> > groups;
   GModel::current()->getPhysicalGroups(dim, groups);
@@ -507,7 +512,7 @@ GMSH_API void gmsh::model::removePhysicalName(const std::string &name)
 GMSH_API void gmsh::model::getPhysicalName(const int dim, const int tag,
                                            std::string &name)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   name = GModel::current()->getPhysicalName(dim, tag);
 }
 
@@ -616,7 +621,7 @@ GMSH_API void gmsh::model::getBoundingBox(const int dim, const int tag,
 
 GMSH_API int gmsh::model::getDimension()
 {
-  if(!_checkInit()) return -1;
+  if(!_checkInit(true)) return -1;
   return GModel::current()->getDim();
 }
 
@@ -1548,7 +1553,9 @@ GMSH_API void gmsh::model::mesh::getNodes(std::vector<std::size_t> &nodeTags,
                                           const bool includeBoundary,
                                           const bool returnParametricCoord)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
+  // boundary nodes are not directly available in a mapped mesh
+  if(includeBoundary) GModel::current()->materializeMappedMesh();
   nodeTags.clear();
   coord.clear();
   parametricCoord.clear();
@@ -1564,8 +1571,14 @@ GMSH_API void gmsh::model::mesh::getNodes(std::vector<std::size_t> &nodeTags,
   else {
     GModel::current()->getEntities(entities, dim);
   }
+  MSH4MappedMesh *mapped = GModel::current()->getMappedMesh();
   for(std::size_t i = 0; i < entities.size(); i++) {
     GEntity *ge = entities[i];
+    if(mapped) {
+      mapped->getNodes(ge, nodeTags, coord, parametricCoord,
+                       dim > 0 && returnParametricCoord);
+      continue;
+    }
     for(std::size_t j = 0; j < ge->mesh_vertices.size(); j++) {
       MVertex *v = ge->mesh_vertices[j];
       nodeTags.push_back(v->getNum());
@@ -1647,7 +1660,18 @@ GMSH_API void gmsh::model::mesh::getNode(const std::size_t nodeTag,
                                          std::vector<double> &parametricCoord,
                                          int &dim, int &tag)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
+  MSH4MappedMesh *mapped = GModel::current()->getMappedMesh();
+  if(mapped) {
+    MSH4MappedMesh::nodeHandle h;
+    if(!mapped->findNode(nodeTag, h)) {
+      Msg::Error("Unknown node %d", nodeTag);
+      return;
+    }
+    parametricCoord.clear();
+    mapped->getNode(h, coord, parametricCoord, dim, tag);
+    return;
+  }
   MVertex *v = GModel::current()->getMeshVertexByTag(nodeTag);
   if(!v) {
     Msg::Error("Unknown node %d", nodeTag);
@@ -1727,7 +1751,7 @@ gmsh::model::mesh::getNodesForPhysicalGroup(const int dim, const int tag,
 
 GMSH_API void gmsh::model::mesh::getMaxNodeTag(std::size_t &maxTag)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   maxTag = GModel::current()->getMaxVertexNumber();
 }
 
@@ -1820,8 +1844,22 @@ _getEntitiesForElementTypes(int dim, int tag,
   else {
     GModel::current()->getEntities(entities, dim);
   }
+  MSH4MappedMesh *mapped = GModel::current()->getMappedMesh();
   for(std::size_t i = 0; i < entities.size(); i++) {
     GEntity *ge = entities[i];
+    if(mapped) {
+      // same element families as for the actual mesh below
+      std::vector<int> types;
+      mapped->getElementTypes(ge, types);
+      for(std::size_t j = 0; j < types.size(); j++) {
+        int familyType = ElementType::getParentType(types[j]);
+        if(ElementType::getDimension(types[j]) == ge->dim() &&
+           familyType != TYPE_POLYG && familyType != TYPE_POLYH &&
+           familyType != TYPE_TRIH)
+          typeEnt[types[j]].push_back(ge);
+      }
+      continue;
+    }
     switch(ge->dim()) {
     case 0: {
       GVertex *v = static_cast<GVertex *>(ge);
@@ -1966,6 +2004,32 @@ GMSH_API void gmsh::model::mesh::getElementsByCoordinates(
   }
 }
 
+GMSH_API void gmsh::model::mesh::getElementsForCoordinates(
+  const std::vector<double> &coord, std::vector<std::size_t> &elementTags,
+  std::vector<double> &localCoord, const int dim, const bool strict)
+{
+  if(!_checkInit()) return;
+  elementTags.clear();
+  localCoord.clear();
+  if(coord.size() % 3) {
+    Msg::Error("Wrong number of coordinates (%lu)",
+               (unsigned long)coord.size());
+    return;
+  }
+  std::size_t n = coord.size() / 3;
+  std::vector<SPoint3> xyz(n), uvw;
+  for(std::size_t i = 0; i < n; i++)
+    xyz[i] = SPoint3(coord[3 * i], coord[3 * i + 1], coord[3 * i + 2]);
+  std::vector<MElement *> e;
+  GModel::current()->getMeshElementByCoord(xyz, e, uvw, dim, strict);
+  elementTags.resize(n);
+  localCoord.resize(3 * n);
+  for(std::size_t i = 0; i < n; i++) {
+    elementTags[i] = e[i] ? e[i]->getNum() : 0;
+    for(int j = 0; j < 3; j++) localCoord[3 * i + j] = uvw[i][j];
+  }
+}
+
 GMSH_API void gmsh::model::mesh::getLocalCoordinatesInElement(
   const std::size_t elementTag, const double x, const double y, const double z,
   double &u, double &v, double &w)
@@ -2063,7 +2127,7 @@ static void _addElements(int dim, int tag, GEntity *ge, int type,
 
 GMSH_API void gmsh::model::mesh::getMaxElementTag(std::size_t &maxTag)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   maxTag = GModel::current()->getMaxElementNumber();
 }
 
@@ -2108,10 +2172,17 @@ GMSH_API void gmsh::model::mesh::addElementsByType(
   GModel::current()->destroyMeshCaches();
 }
 
+static std::size_t _getNumMeshElementsByType(GEntity *ge, int familyType)
+{
+  MSH4MappedMesh *mapped = GModel::current()->getMappedMesh();
+  if(mapped) return mapped->getNumElementsByType(ge, familyType);
+  return ge->getNumMeshElementsByType(familyType);
+}
+
 GMSH_API void gmsh::model::mesh::getElementTypes(std::vector<int> &elementTypes,
                                                  const int dim, const int tag)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   elementTypes.clear();
   std::map<int, std::vector<GEntity *> > typeEnt;
   _getEntitiesForElementTypes(dim, tag, typeEnt);
@@ -2175,7 +2246,7 @@ GMSH_API void gmsh::model::mesh::getElementsByType(
   std::vector<std::size_t> &nodeTags, const int tag, const std::size_t task,
   const std::size_t numTasks)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   int dim = ElementType::getDimension(elementType);
   std::map<int, std::vector<GEntity *> > typeEnt;
   _getEntitiesForElementTypes(dim, tag, typeEnt);
@@ -2183,7 +2254,7 @@ GMSH_API void gmsh::model::mesh::getElementsByType(
   int familyType = ElementType::getParentType(elementType);
   std::size_t numElements = 0;
   for(std::size_t i = 0; i < entities.size(); i++)
-    numElements += entities[i]->getNumMeshElementsByType(familyType);
+    numElements += _getNumMeshElementsByType(entities[i], familyType);
   const int numNodes = ElementType::getNumVertices(elementType);
   if(!numTasks) {
     Msg::Error("Number of tasks should be > 0");
@@ -2206,8 +2277,20 @@ GMSH_API void gmsh::model::mesh::getElementsByType(
   const std::size_t end = ((task + 1) * numElements) / numTasks;
   size_t o = 0;
   size_t idx = begin * numNodes;
+  MSH4MappedMesh *mapped = GModel::current()->getMappedMesh();
   for(std::size_t i = 0; i < entities.size(); i++) {
     GEntity *ge = entities[i];
+    if(mapped) {
+      std::size_t num = mapped->getNumElementsByType(ge, familyType);
+      if(o + num > begin && o < end) {
+        std::size_t b = std::max(begin, o) - o, e = std::min(end, o + num) - o;
+        idx += mapped->getElementsByType(
+          ge, familyType, b, e, haveElementTags ? &elementTags[o + b] : nullptr,
+          haveNodeTags ? &nodeTags[idx] : nullptr);
+      }
+      o += num;
+      continue;
+    }
     for(std::size_t j = 0; j < ge->getNumMeshElementsByType(familyType); j++) {
       if(o >= begin && o < end) {
         MElement *e = ge->getMeshElementByType(familyType, j);
@@ -2228,7 +2311,7 @@ GMSH_API void gmsh::model::mesh::preallocateElementsByType(
   std::vector<std::size_t> &elementTags, std::vector<std::size_t> &nodeTags,
   const int tag)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   int dim = ElementType::getDimension(elementType);
   std::map<int, std::vector<GEntity *> > typeEnt;
   _getEntitiesForElementTypes(dim, tag, typeEnt);
@@ -2236,7 +2319,7 @@ GMSH_API void gmsh::model::mesh::preallocateElementsByType(
   int familyType = ElementType::getParentType(elementType);
   std::size_t numElements = 0;
   for(std::size_t i = 0; i < entities.size(); i++)
-    numElements += entities[i]->getNumMeshElementsByType(familyType);
+    numElements += _getNumMeshElementsByType(entities[i], familyType);
   const int numNodesPerEle = ElementType::getNumVertices(elementType);
   if(!numElements) return;
   if(elementTag) {
@@ -2275,6 +2358,31 @@ GMSH_API void gmsh::model::mesh::getElementQualities(
 
   const std::size_t begin = (task * numElements) / numTasks;
   const std::size_t end = ((task + 1) * numElements) / numTasks;
+
+#if defined(HAVE_MESH)
+  if(qualityName == "minIsotropy") {
+    // process all the elements together, in batches of elements of the same
+    // type
+    std::vector<MElement *> elements;
+    std::vector<std::size_t> indices;
+    for(size_t k = begin; k < end; k++) {
+      MElement *e = GModel::current()->getMeshElementByTag(elementTags[k]);
+      if(!e) {
+        Msg::Error("Unknown element %d", elementTags[k]);
+        elementQualities[k] = 0.;
+        continue;
+      }
+      elements.push_back(e);
+      indices.push_back(k);
+    }
+    std::vector<double> icn;
+    jacobianBasedQuality::minICNMeasure(elements, icn);
+    for(std::size_t i = 0; i < indices.size(); i++)
+      elementQualities[indices[i]] = icn[i];
+    return;
+  }
+#endif
+
   for(size_t k = begin; k < end; k++){
     MElement *e = GModel::current()->getMeshElementByTag(elementTags[k]);
     if(!e) {
@@ -5752,6 +5860,39 @@ gmsh::model::mesh::field::getNumbers(const int tag, const std::string &option,
 #endif
 }
 
+GMSH_API void
+gmsh::model::mesh::field::evaluate(const int tag,
+                                   const std::vector<double> &coord,
+                                   std::vector<double> &values)
+{
+  if(!_checkInit()) return;
+  values.clear();
+#if defined(HAVE_MESH)
+  Field *field = GModel::current()->getFields()->get(tag);
+  if(!field) {
+    Msg::Error("Unknown field %i", tag);
+    return;
+  }
+  if(coord.size() % 3) {
+    Msg::Error("Number of coordinates should be a multiple of 3");
+    return;
+  }
+  std::size_t n = coord.size() / 3;
+  if(!n) return;
+  std::vector<double> x(n), y(n), z(n);
+  for(std::size_t i = 0; i < n; i++) {
+    x[i] = coord[3 * i];
+    y[i] = coord[3 * i + 1];
+    z[i] = coord[3 * i + 2];
+  }
+  values.resize(n);
+  GModel::current()->getFields()->initialize();
+  field->evaluate(n, &x[0], &y[0], &z[0], &values[0]);
+#else
+  Msg::Error("Fields require the mesh module");
+#endif
+}
+
 GMSH_API void gmsh::model::mesh::field::setAsBackgroundMesh(const int tag)
 {
   if(!_checkInit()) return;
@@ -7816,6 +7957,55 @@ GMSH_API void gmsh::view::probe(const int tag, const double x, const double y,
 #endif
 }
 
+GMSH_API void gmsh::view::probePoints(const int tag,
+                                      const std::vector<double> &coord,
+                                      std::vector<double> &values,
+                                      std::vector<double> &distances,
+                                      const int step, const int numComp,
+                                      const bool gradient,
+                                      const double distanceMax, const int dim)
+{
+  if(!_checkInit()) return;
+#if defined(HAVE_POST)
+  PView *view = PView::getViewByTag(tag);
+  if(!view) {
+    Msg::Error("Unknown view with tag %d", tag);
+    return;
+  }
+  PViewData *data = view->getData();
+  if(!data) {
+    Msg::Error("No data in view %d", tag);
+    return;
+  }
+  values.clear();
+  distances.clear();
+  if(coord.size() % 3) {
+    Msg::Error("Wrong number of coordinates (%lu)",
+               (unsigned long)coord.size());
+    return;
+  }
+  int nc = numComp;
+  if(nc <= 0) {
+    if(data->getNumScalars())
+      nc = 1;
+    else if(data->getNumVectors())
+      nc = 3;
+    else if(data->getNumTensors())
+      nc = 9;
+    else
+      nc = 1;
+  }
+  else if(nc != 1 && nc != 3 && nc != 9) {
+    Msg::Error("Wrong number of components (%d)", nc);
+    return;
+  }
+  data->searchClosest(coord, nc, distanceMax, distances, values, step,
+                      gradient, dim);
+#else
+  Msg::Error("Views require the post-processing module");
+#endif
+}
+
 GMSH_API void gmsh::view::write(const int tag, const std::string &fileName,
                                 const bool append)
 {
@@ -8611,20 +8801,20 @@ GMSH_API void gmsh::onelab::run(const std::string &name,
 
 GMSH_API void* gmsh::logger::getCallback()
 {
-  if(!_checkInit()) return nullptr;
+  if(!_checkInit(true)) return nullptr;
   return Msg::GetCallback();
 }
 
 GMSH_API void gmsh::logger::setCallback(void* callback)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   Msg::SetCallback(static_cast<GmshMessage*>(callback));
 }
 
 GMSH_API void gmsh::logger::write(const std::string &message,
                                   const std::string &level)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   if(level == "error")
     Msg::Error("%s", message.c_str());
   else if(level == "warning")
@@ -8649,7 +8839,7 @@ public:
 
 GMSH_API void gmsh::logger::start()
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   GmshMessage *msg = Msg::GetCallback();
   if(msg) { Msg::Warning("Logger already started - ignoring"); }
   else {
@@ -8660,7 +8850,7 @@ GMSH_API void gmsh::logger::start()
 
 GMSH_API void gmsh::logger::get(std::vector<std::string> &log)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   apiMsg *msg = dynamic_cast<apiMsg *>(Msg::GetCallback());
   if(msg) { msg->get(log); }
   else {
@@ -8670,7 +8860,7 @@ GMSH_API void gmsh::logger::get(std::vector<std::string> &log)
 
 GMSH_API void gmsh::logger::stop()
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   GmshMessage *msg = Msg::GetCallback();
   if(msg) {
     delete msg;
@@ -8683,18 +8873,18 @@ GMSH_API void gmsh::logger::stop()
 
 GMSH_API double gmsh::logger::getWallTime()
 {
-  if(!_checkInit()) return -1;
+  if(!_checkInit(true)) return -1;
   return TimeOfDay();
 }
 
 GMSH_API double gmsh::logger::getCpuTime()
 {
-  if(!_checkInit()) return -1;
+  if(!_checkInit(true)) return -1;
   return Cpu();
 }
 
 GMSH_API void gmsh::logger::getLastError(std::string &error)
 {
-  if(!_checkInit()) return;
+  if(!_checkInit(true)) return;
   error = Msg::GetLastError();
 }
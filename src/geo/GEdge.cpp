@@ -52,6 +52,7 @@ GEdge::~GEdge()
 
 void GEdge::deleteMesh()
 {
+  meshSignature = 0;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   for(std::size_t i = 0; i < lines.size(); i++) delete lines[i];
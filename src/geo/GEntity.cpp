@@ -19,7 +19,7 @@
 GEntity::GEntity(GModel *m, int t)
   : _model(m), _tag(t), _meshMaster(this), _visible(1), _selection(0),
     _allElementsVisible(1), _obb(nullptr), va_lines(nullptr),
-    va_triangles(nullptr)
+    va_triangles(nullptr), meshSignature(0)
 {
   _color = CTX::instance()->packColor(0, 0, 255, 0);
 }
@@ -70,6 +70,10 @@ public: // these will become protected at some point
   // Set of high-order elements fixed by "fast curving"
   std::set<MElement *> curvedBLElements;
 
+  // signature of the data the current mesh of the entity was generated from,
+  // used for incremental remeshing (0 if unknown)
+  std::size_t meshSignature;
+
 public:
   // make a set of all the vertices in the entity, with/without closure
   void addVerticesInSet(std::set<MVertex *> &, bool closure) const;
@@ -137,6 +137,7 @@ void GFace::setBoundEdges(const std::vector<int> &tagEdges,
 
 void GFace::deleteMesh()
 {
+  meshSignature = 0;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   transfinite_vertices.clear();
@@ -843,8 +844,8 @@ void GFace::computeMeshSizeFieldAccuracy(double &avg, double &max_e,
     MVertex *vert2 = it->getVertex(1);
     vert2->getParameter(0, u2);
     vert2->getParameter(1, v2);
-    double l1 = BGM_MeshSize(this, u1, v1, vert1->x(), vert1->y(), vert1->z());
-    double l2 = BGM_MeshSize(this, u2, v2, vert2->x(), vert2->y(), vert2->z());
+    double l1 = BGM_MeshSize(this, u1, v1, vert1);
+    double l2 = BGM_MeshSize(this, u2, v2, vert2);
     double correctLC = 0.5 * (l1 + l2);
     double lone = it->length() / correctLC;
     if(lone > oneoversqr2 && lone < sqr2) GS++;
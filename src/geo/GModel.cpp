@@ -12,6 +12,7 @@
 #include "GModel.h"
 #include "GModelIO_GEO.h"
 #include "GModelIO_OCC.h"
+#include "GModelIO_MSH4.h"
 #include "MPoint.h"
 #include "MLine.h"
 #include "MTriangle.h"
@@ -72,7 +73,7 @@ int GModel::_current = -1;
 GModel::GModel(const std::string &name)
   : _name(name), _visible(1), _elementOctree(nullptr),
     _geo_internals(nullptr), _occ_internals(nullptr), _acis_internals(nullptr),
-    _parasolid_internals(nullptr), _fields(nullptr),
+    _parasolid_internals(nullptr), _fields(nullptr), _mappedMesh(nullptr),
     _currentMeshEntity(nullptr), _numPartitions(0), normals(nullptr),
     lcCallback(nullptr)
 {
@@ -80,6 +81,10 @@ GModel::GModel(const std::string &name)
   _maxElementNum = CTX::instance()->mesh.firstElementTag - 1;
   _checkPointedMaxVertexNum = _maxVertexNum;
   _checkPointedMaxElementNum = _maxElementNum;
+  _concurrentNumbering = 0;
+  _concurrentBlocks = 0;
+  _concurrentMaxVertexNum = _concurrentLastVertexNum = _maxVertexNum;
+  _concurrentMaxElementNum = _concurrentLastElementNum = _maxElementNum;
 
   // hide all other models
   for(std::size_t i = 0; i < list.size(); i++) list[i]->setVisibility(0);
@@ -178,6 +183,7 @@ void GModel::destroy(bool keepName)
   _maxElementNum = CTX::instance()->mesh.firstElementTag - 1;
   _checkPointedMaxVertexNum = _maxVertexNum;
   _checkPointedMaxElementNum = _maxElementNum;
+  _concurrentNumbering = 0;
   _currentMeshEntity = nullptr;
   _lastMeshEntityError.clear();
   _lastMeshVertexError.clear();
@@ -200,6 +206,9 @@ void GModel::destroy(bool keepName)
 
   destroyMeshCaches();
 
+  if(_mappedMesh) delete _mappedMesh;
+  _mappedMesh = nullptr;
+
   resetOCCInternals();
 
   if(normals) delete normals;
@@ -240,6 +249,8 @@ void GModel::deleteMesh()
   for(auto it = firstEdge(); it != lastEdge(); ++it) (*it)->deleteMesh();
   for(auto it = firstVertex(); it != lastVertex(); ++it) (*it)->deleteMesh();
   destroyMeshCaches();
+  if(_mappedMesh) delete _mappedMesh;
+  _mappedMesh = nullptr;
   _currentMeshEntity = nullptr;
   _lastMeshEntityError.clear();
   _lastMeshVertexError.clear();
@@ -1727,6 +1738,117 @@ void GModel::renumberMeshVertices()
 #endif
 }
 
+// number of vertex/element numbers reserved at once by a thread during
+// concurrent numbering
+static const std::size_t NUMBER_BLOCK_SIZE = 1024;
+
+// identifier of the last concurrent numbering phase or blocks, for all models
+static std::atomic<std::size_t> lastConcurrentNumbering(0);
+
+struct numberBlock {
+  std::size_t phase, next, last;
+};
+
+static thread_local numberBlock vertexNumberBlock = {0, 0, 0};
+static thread_local numberBlock elementNumberBlock = {0, 0, 0};
+
+static std::size_t getNumberFromBlock(numberBlock &b, std::size_t phase,
+                                      std::size_t &maxNum)
+{
+  if(b.phase != phase || b.next > b.last) {
+    std::size_t last;
+#pragma omp atomic capture
+    {
+      maxNum += NUMBER_BLOCK_SIZE;
+      last = maxNum;
+    }
+    b.phase = phase;
+    b.next = last - NUMBER_BLOCK_SIZE + 1;
+    b.last = last;
+  }
+  return b.next++;
+}
+
+std::size_t GModel::_getVertexNumberFromBlock()
+{
+  return getNumberFromBlock(vertexNumberBlock, _concurrentBlocks,
+                            _maxVertexNum);
+}
+
+std::size_t GModel::_getElementNumberFromBlock()
+{
+  return getNumberFromBlock(elementNumberBlock, _concurrentBlocks,
+                            _maxElementNum);
+}
+
+void GModel::beginConcurrentNumbering()
+{
+  if(_concurrentNumbering) return;
+  _concurrentNumbering = ++lastConcurrentNumbering;
+  _concurrentBlocks = _concurrentNumbering;
+  _concurrentMaxVertexNum = _concurrentLastVertexNum = _maxVertexNum;
+  _concurrentMaxElementNum = _concurrentLastElementNum = _maxElementNum;
+}
+
+void GModel::endConcurrentNumbering()
+{
+  if(!_concurrentNumbering) return;
+  _concurrentNumbering = 0;
+  if(_maxVertexNum == _concurrentMaxVertexNum &&
+     _maxElementNum == _concurrentMaxElementNum)
+    return;
+
+  // renumber the vertices and elements created since beginConcurrentNumbering
+  // in an order that does not depend on the blocks they got their number
+  // from: in the order of the entities, and in the order in which they are
+  // stored in each entity (i.e. their creation order)
+  destroyMeshCaches();
+  std::vector<GEntity *> entities;
+  getEntities(entities);
+  std::size_t nv = _concurrentMaxVertexNum, ne = _concurrentMaxElementNum;
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    GEntity *ge = entities[i];
+    for(std::size_t j = 0; j < ge->getNumMeshVertices(); j++) {
+      MVertex *v = ge->getMeshVertex(j);
+      if(v->getNum() > _concurrentMaxVertexNum) v->forceNum(++nv);
+    }
+    for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
+      MElement *e = ge->getMeshElement(j);
+      if(e->getNum() > _concurrentMaxElementNum) e->forceNum(++ne);
+    }
+  }
+
+  // vertices and elements that are not (yet) stored in an entity keep the
+  // number they got from a block: the maximum numbers are thus not decreased
+  // to nv and ne, so that these numbers are never given again. This only
+  // leaves a gap in the numbering, which does not change the order of the
+  // numbers, and which is removed by renumberMeshVertices() and
+  // renumberMeshElements()
+}
+
+void GModel::endConcurrentNumbering(GEntity *ge)
+{
+  if(!_concurrentNumbering) return;
+
+  // the vertices and elements renumbered so far all got a number from a block
+  // before: these consecutive numbers are thus smaller than the numbers of the
+  // blocks that will be reserved afterwards (they can however be the same as
+  // the numbers of other entities that are not renumbered yet)
+  for(std::size_t j = 0; j < ge->getNumMeshVertices(); j++) {
+    MVertex *v = ge->getMeshVertex(j);
+    if(v->getNum() > _concurrentMaxVertexNum)
+      v->forceNum(++_concurrentLastVertexNum);
+  }
+  for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
+    MElement *e = ge->getMeshElement(j);
+    if(e->getNum() > _concurrentMaxElementNum)
+      e->forceNum(++_concurrentLastElementNum);
+  }
+
+  // make all the threads reserve new blocks, after these numbers
+  _concurrentBlocks = ++lastConcurrentNumbering;
+}
+
 void GModel::renumberMeshElements()
 {
   destroyMeshCaches();
@@ -1833,18 +1955,28 @@ std::size_t GModel::getNumMeshElements(unsigned c[6])
   return 0;
 }
 
-MElement *GModel::getMeshElementByCoord(SPoint3 &p, SPoint3 &param, int dim,
-                                        bool strict)
+MElementOctree *GModel::_getElementOctree()
 {
-  if(!_elementOctree) {
-#pragma omp barrier
-#pragma omp single
-    {
+  // the search structure is built by the first caller; concurrent callers wait
+  // until it is available, and then only perform read-only queries
+  MElementOctree *octree = _elementOctree.load(std::memory_order_acquire);
+  if(octree) return octree;
+#pragma omp critical(GModelElementOctree)
+  {
+    octree = _elementOctree.load(std::memory_order_acquire);
+    if(!octree) {
       Msg::Debug("Rebuilding mesh element octree");
-      _elementOctree = new MElementOctree(this);
+      octree = new MElementOctree(this);
+      _elementOctree.store(octree, std::memory_order_release);
     }
   }
-  MElement *e = _elementOctree->find(p.x(), p.y(), p.z(), dim, strict);
+  return octree;
+}
+
+MElement *GModel::getMeshElementByCoord(SPoint3 &p, SPoint3 &param, int dim,
+                                        bool strict)
+{
+  MElement *e = _getElementOctree()->find(p.x(), p.y(), p.z(), dim, strict);
   if(e) {
     double xyz[3] = {p.x(), p.y(), p.z()}, uvw[3];
     e->xyz2uvw(xyz, uvw);
@@ -1859,15 +1991,33 @@ MElement *GModel::getMeshElementByCoord(SPoint3 &p, SPoint3 &param, int dim,
 std::vector<MElement *> GModel::getMeshElementsByCoord(SPoint3 &p, int dim,
                                                        bool strict)
 {
-  if(!_elementOctree) {
-#pragma omp barrier
-#pragma omp single
-    {
-      Msg::Debug("Rebuilding mesh element octree");
-      _elementOctree = new MElementOctree(this);
+  return _getElementOctree()->findAll(p.x(), p.y(), p.z(), dim, strict);
+}
+
+void GModel::getMeshElementByCoord(const std::vector<SPoint3> &points,
+                                   std::vector<MElement *> &elements,
+                                   std::vector<SPoint3> &params, int dim,
+                                   bool strict)
+{
+  MElementOctree *octree = _getElementOctree();
+  elements.resize(points.size());
+  params.resize(points.size());
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 64)
+  for(std::size_t i = 0; i < points.size(); i++) {
+    const SPoint3 &p = points[i];
+    MElement *e = octree->find(p.x(), p.y(), p.z(), dim, strict);
+    elements[i] = e;
+    if(e) {
+      double xyz[3] = {p.x(), p.y(), p.z()}, uvw[3];
+      e->xyz2uvw(xyz, uvw);
+      params[i].setPosition(uvw[0], uvw[1], uvw[2]);
+    }
+    else {
+      params[i].setPosition(0, 0, 0);
     }
   }
-  return _elementOctree->findAll(p.x(), p.y(), p.z(), dim, strict);
 }
 
 void GModel::rebuildMeshVertexCache(bool onlyIfNecessary)
@@ -1955,10 +2105,11 @@ MVertex *GModel::getMeshVertexByTag(int n)
     }
   }
 
-  if(n < (int)_vertexVectorCache.size())
-    return _vertexVectorCache[n];
-  else
-    return _vertexMapCache[n];
+  // don't modify the cache if the tag is not found, so that lookups can be
+  // performed concurrently once the cache is built
+  if(n < (int)_vertexVectorCache.size()) return _vertexVectorCache[n];
+  auto it = _vertexMapCache.find(n);
+  return (it != _vertexMapCache.end()) ? it->second : nullptr;
 }
 
 void GModel::addMVertexToVertexCache(MVertex* v)
@@ -2009,11 +2160,13 @@ MElement *GModel::getMeshElementByTag(int n, int &entityTag)
     }
   }
 
-  std::pair<MElement*, int> ret;
+  std::pair<MElement*, int> ret(nullptr, 0);
   if(n < (int)_elementVectorCache.size())
     ret = _elementVectorCache[n];
-  else
-    ret = _elementMapCache[n];
+  else {
+    auto it = _elementMapCache.find(n);
+    if(it != _elementMapCache.end()) ret = it->second;
+  }
   entityTag = ret.second;
   return ret.first;
 }
@@ -7,6 +7,7 @@
 #define GMODEL_H
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <set>
 #include <map>
@@ -39,6 +40,7 @@ class gLevelset;
 class discreteFace;
 class discreteRegion;
 class MElementOctree;
+class MSH4MappedMesh;
 
 // A geometric model. The model is a "not yet" non-manifold B-Rep.
 class GModel {
@@ -55,8 +57,18 @@ private:
   // the maximum vertex and element id number in the mesh
   std::size_t _maxVertexNum, _maxElementNum;
   std::size_t _checkPointedMaxVertexNum, _checkPointedMaxElementNum;
+  // concurrent numbering (see beginConcurrentNumbering): identifier of the
+  // current phase (0 if inactive), identifier of the blocks that can currently
+  // be used, maximum numbers when it started, and last numbers given to the
+  // entities renumbered since then
+  std::size_t _concurrentNumbering;
+  std::atomic<std::size_t> _concurrentBlocks;
+  std::size_t _concurrentMaxVertexNum, _concurrentMaxElementNum;
+  std::size_t _concurrentLastVertexNum, _concurrentLastElementNum;
 
 private:
+  std::size_t _getVertexNumberFromBlock();
+  std::size_t _getElementNumberFromBlock();
   int _readMSH2(const std::string &name);
   int _writeMSH2(const std::string &name, double version, bool binary,
                  bool saveAll, bool saveParametric, double scalingFactor,
@@ -73,6 +85,8 @@ private:
                             bool binary, bool saveAll, bool saveParametric,
                             double scalingFactor);
   int _readMSH4(const std::string &name);
+  bool _readMSH4Nodes(FILE *fp, bool binary, bool swap, double version);
+  bool _readMSH4Elements(FILE *fp, bool binary, bool swap, double version);
   int _writeMSH4(const std::string &name, double version, bool binary,
                  bool saveAll, bool saveParametric, double scalingFactor,
                  bool append, int partitionToSave = 0,
@@ -84,6 +98,7 @@ private:
                     double scalingFactor, int x3dsurfaces, int x3dedges,
                     int x3dvertices, int x3dcolorize,
                     std::vector<GFace *> &customFaces);
+  MElementOctree *_getElementOctree();
 
 protected:
   // the name of the model
@@ -109,8 +124,9 @@ protected:
   // /!\ Use only for compatibility with mesh format msh2 and msh3
   std::multimap<MElement *, short> _ghostCells;
 
-  // an octree for fast mesh element lookup
-  MElementOctree *_elementOctree;
+  // a spatial search structure for fast mesh element lookup, built on first
+  // use (see _getElementOctree)
+  std::atomic<MElementOctree *> _elementOctree;
 
   // global cache storage of discrete curvatures
   std::map<MVertex *, std::pair<SVector3, SVector3> > _curvatures;
@@ -127,6 +143,11 @@ protected:
   // characteristic length (mesh size) fields
   FieldManager *_fields;
 
+  // node and element blocks of an MSH4 file mapped in memory (or read in
+  // compact arrays), from which the actual nodes and elements are only created
+  // on demand
+  MSH4MappedMesh *_mappedMesh;
+
   // entity that is currently being meshed (used for error reporting)
   GEntity *_currentMeshEntity;
 
@@ -221,20 +242,32 @@ public:
   // get/set global vertex/element num
   std::size_t getMaxVertexNumber() const { return _maxVertexNum; }
   std::size_t getMaxElementNumber() const { return _maxElementNum; }
+  // only write the maximum numbers if they increase, so that they are not
+  // overwritten with a stale value while other threads reserve numbers (see
+  // beginConcurrentNumbering)
   void setMaxVertexNumber(std::size_t num)
   {
+    std::size_t max;
+#pragma omp atomic read
+    max = _maxVertexNum;
+    if(num <= max) return;
 #pragma omp atomic write
-    _maxVertexNum = _maxVertexNum > num ? _maxVertexNum : num;
+    _maxVertexNum = num;
   }
   void setMaxElementNumber(std::size_t num)
   {
+    std::size_t max;
+#pragma omp atomic read
+    max = _maxElementNum;
+    if(num <= max) return;
 #pragma omp atomic write
-    _maxElementNum = _maxElementNum > num ? _maxElementNum : num;
+    _maxElementNum = num;
   }
 
   // increment and get global vertex/element num
   std::size_t incrementAndGetMaxVertexNumber()
   {
+    if(_concurrentNumbering) return _getVertexNumberFromBlock();
     std::size_t _myVertexNum;
 #pragma omp atomic capture
     {
@@ -245,6 +278,7 @@ public:
   }
   std::size_t incrementAndGetMaxElementNumber()
   {
+    if(_concurrentNumbering) return _getElementNumberFromBlock();
     std::size_t _myElementNum;
 #pragma omp atomic capture
     {
@@ -261,6 +295,24 @@ public:
     --_maxVertexNum;
   }
 
+  // between these two calls, new vertices and elements take their numbers from
+  // blocks reserved by each thread instead of from the global counters; the
+  // vertices and elements created in between are then renumbered
+  // consecutively, in the order of the entities and of their meshes, so that
+  // the numbering does not depend on the scheduling of the threads (those that
+  // are not stored in an entity keep their number, which stays unique)
+  void beginConcurrentNumbering();
+  void endConcurrentNumbering();
+  // renumber the vertices and elements of a single entity that were created
+  // since beginConcurrentNumbering (e.g. as soon as it is meshed), while the
+  // concurrent numbering goes on for the other entities; the numbers given
+  // afterwards, in any thread, are larger. The entities get consecutive
+  // numbers in the order of the calls, so that calling it for the first
+  // entities in the order of endConcurrentNumbering() gives the numbers that
+  // endConcurrentNumbering() will give. Can be called concurrently with the
+  // creation of vertices and elements, but not for several entities at once
+  void endConcurrentNumbering(GEntity *ge);
+
   void checkPointMaxNumbers()
   {
     _checkPointedMaxVertexNum = _maxVertexNum;
@@ -301,6 +353,13 @@ public:
   // delete the vertex arrays used for efficient mesh drawing
   void deleteVertexArrays();
 
+  // get the mesh mapped from a binary MSH4 file, if any (when a mesh is
+  // mapped, the entities do not contain any nodes or elements)
+  MSH4MappedMesh *getMappedMesh() const { return _mappedMesh; }
+  // create the nodes and elements of the mapped mesh, if any, and release the
+  // mapping
+  void materializeMappedMesh();
+
   // remove all mesh vertex associations to geometrical entities and remove
   // vertices from geometrical entities, then _associateEntityWithMeshVertices
   // and _storeVerticesInEntities are called to rebuild the associations
@@ -528,11 +587,18 @@ public:
   // dimension and return the dimension
   std::size_t getNumMeshElements(unsigned c[6]);
 
-  // access a mesh element by coordinates (using an octree search)
+  // access a mesh element by coordinates (using a bounding volume hierarchy
+  // search); these functions can be called concurrently
   MElement *getMeshElementByCoord(SPoint3 &p, SPoint3 &param, int dim = -1,
                                   bool strict = true);
   std::vector<MElement *> getMeshElementsByCoord(SPoint3 &p, int dim = -1,
                                                  bool strict = true);
+  // access the mesh elements containing a batch of points, which are searched
+  // concurrently (elements[i] is null if no element is found for points[i])
+  void getMeshElementByCoord(const std::vector<SPoint3> &points,
+                             std::vector<MElement *> &elements,
+                             std::vector<SPoint3> &params, int dim = -1,
+                             bool strict = true);
 
   // access a mesh element by tag, using the element cache
   MElement *getMeshElementByTag(int n)
@@ -557,7 +623,8 @@ public:
   // _elementMapCache if not.
   void rebuildMeshElementCache(bool onlyIfNecessary = false);
 
-  // access a mesh vertex by tag, using the vertex cache
+  // access a mesh vertex by tag, using the vertex cache (can be called
+  // concurrently once the cache is built)
   MVertex *getMeshVertexByTag(int n);
 
   // add a mesh vertex to the global mesh vertex cache
@@ -7,6 +7,8 @@
 //   Anthony Royer
 
 #include <cstdio>
+#include <cstdarg>
+#include <cstring>
 #include <fstream>
 #include <vector>
 #include <map>
@@ -21,6 +23,7 @@
 #include "OS.h"
 #include "Context.h"
 #include "GModel.h"
+#include "GModelIO_MSH4.h"
 #include "GEntity.h"
 #include "partitionRegion.h"
 #include "partitionFace.h"
@@ -40,6 +43,7 @@
 #include "MPyramid.h"
 #include "MTrihedron.h"
 #include "StringUtils.h"
+#include "ElementType.h"
 
 static bool readMSH4Physicals(GModel *const model, FILE *fp,
                               GEntity *const entity, bool binary, char *str,
@@ -459,6 +463,93 @@ static bool readMSH4Entities(GModel *const model, FILE *fp, bool partition,
   return true;
 }
 
+// Read from fp the lines containing the next numTokens whitespace-separated
+// tokens. The (null-terminated) lines are stored in buf, with the offset of
+// each line in lines and the index of its first token in tokens, so that the
+// lines can then be parsed concurrently with parseMSH4Lines.
+static bool readMSH4Lines(FILE *fp, std::size_t numTokens,
+                          std::vector<char> &buf,
+                          std::vector<std::size_t> &lines,
+                          std::vector<std::size_t> &tokens)
+{
+  buf.clear();
+  lines.clear();
+  tokens.clear();
+  std::size_t numRead = 0;
+  bool newLine = true, inToken = false;
+  char str[1024];
+  while(!newLine || numRead < numTokens) {
+    if(!fgets(str, sizeof(str), fp)) return false;
+    if(newLine) {
+      lines.push_back(buf.size());
+      tokens.push_back(numRead);
+      newLine = false;
+    }
+    for(char *c = str; *c; c++) {
+      if(*c == '\n') {
+        newLine = true;
+        inToken = false;
+        break;
+      }
+      if(*c == ' ' || *c == '\t' || *c == '\r') { inToken = false; }
+      else if(!inToken) {
+        inToken = true;
+        numRead++;
+      }
+      buf.push_back(*c);
+    }
+    if(newLine || feof(fp)) {
+      buf.push_back('\0');
+      newLine = true;
+    }
+  }
+  // the format requires each block to start on a new line
+  return numRead == numTokens;
+}
+
+// Parse the lines read by readMSH4Lines concurrently, by calling parse(t, p)
+// for each token t, where p points to the token in the line (and should be
+// moved past the token by parse).
+template <class F>
+static bool parseMSH4Lines(const std::vector<char> &buf,
+                           const std::vector<std::size_t> &lines,
+                           const std::vector<std::size_t> &tokens,
+                           std::size_t numTokens, int nthreads, F parse)
+{
+  bool ok = true;
+#pragma omp parallel for num_threads(nthreads) if(lines.size() > 1000)
+  for(std::size_t i = 0; i < lines.size(); i++) {
+    if(!ok) continue;
+    const char *p = &buf[lines[i]];
+    std::size_t last = (i + 1 < lines.size()) ? tokens[i + 1] : numTokens;
+    for(std::size_t t = tokens[i]; t < last; t++) {
+      if(!parse(t, p)) {
+        ok = false;
+        break;
+      }
+    }
+  }
+  return ok;
+}
+
+static bool parseMSH4Token(const char *&p, std::size_t &val)
+{
+  char *end;
+  val = std::strtoull(p, &end, 10);
+  if(end == p) return false;
+  p = end;
+  return true;
+}
+
+static bool parseMSH4Token(const char *&p, double &val)
+{
+  char *end;
+  val = std::strtod(p, &end);
+  if(end == p) return false;
+  p = end;
+  return true;
+}
+
 static std::pair<std::size_t, MVertex *> *
 readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
               std::size_t &totalNumNodes, std::size_t &maxNodeNum, bool swap,
@@ -491,6 +582,9 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
     }
   }
 
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
   std::size_t nodeRead = 0;
   std::size_t minNodeNum = std::numeric_limits<std::size_t>::max();
 
@@ -500,6 +594,13 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
   Msg::Info("%lu node%s", totalNumNodes, totalNumNodes > 1 ? "s" : "");
   Msg::StartProgressMeter(totalNumNodes);
 
+  // the blocks are read sequentially, but the data in each block (ASCII
+  // parsing and node creation) is processed concurrently
+  std::vector<std::size_t> tags;
+  std::vector<double> coord;
+  std::vector<char> buf;
+  std::vector<std::size_t> lines, tokens;
+
   for(std::size_t i = 0; i < numBlock; i++) {
     int parametric = 0;
     int entityTag = 0, entityDim = 0;
@@ -539,6 +640,12 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
       }
     }
 
+    if(nodeRead + numNodes > totalNumNodes) {
+      Msg::Error("Number of nodes in blocks exceeds total number of nodes");
+      delete[] vertexCache;
+      return nullptr;
+    }
+
     GEntity *entity = model->getEntityByTag(entityDim, entityTag);
     if(!entity) {
       switch(entityDim) {
@@ -581,109 +688,81 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
     std::size_t n = 3;
     if(parametric) n += entityDim;
 
-    std::vector<std::size_t> tags(numNodes);
+    tags.resize(numNodes);
+    coord.resize(n * numNodes);
     if(binary) {
       if(fread(&tags[0], sizeof(std::size_t), numNodes, fp) != numNodes) {
         delete[] vertexCache;
         return nullptr;
       }
       if(swap) SwapBytes((char *)&tags[0], sizeof(std::size_t), numNodes);
-      std::vector<double> coord(n * numNodes);
       if(fread(&coord[0], sizeof(double), n * numNodes, fp) != n * numNodes) {
         delete[] vertexCache;
         return nullptr;
       }
       if(swap) SwapBytes((char *)&coord[0], sizeof(double), n * numNodes);
-      std::size_t k = 0;
-      for(std::size_t j = 0; j < numNodes; j++) {
-        MVertex *mv = nullptr;
-        std::size_t tagNode = tags[j];
-        if(n == 5) {
-          mv = new MFaceVertex(coord[k], coord[k + 1], coord[k + 2], entity,
-                               coord[k + 3], coord[k + 4], tagNode);
-        }
-        else if(n == 4) {
-          mv = new MEdgeVertex(coord[k], coord[k + 1], coord[k + 2], entity,
-                               coord[k + 3], tagNode);
-        }
-        else {
-          mv =
-            new MVertex(coord[k], coord[k + 1], coord[k + 2], entity, tagNode);
-        }
-        k += n;
-        entity->addMeshVertex(mv);
-        mv->setEntity(entity);
-        minNodeNum = std::min(minNodeNum, tagNode);
-        maxNodeNum = std::max(maxNodeNum, tagNode);
-        vertexCache[nodeRead] = std::make_pair(tagNode, mv);
-        nodeRead++;
-        if(totalNumNodes > 100000)
-          Msg::ProgressMeter(nodeRead, true, "Reading nodes");
-      }
     }
     else {
+      // MSH 4.1 stores all the tags of the block followed by all the
+      // coordinates, whereas MSH 4.0 stores the tag of each node followed by
+      // its coordinates
+      std::size_t numTokens = (n + 1) * numNodes;
+      if(!readMSH4Lines(fp, numTokens, buf, lines, tokens)) {
+        delete[] vertexCache;
+        return nullptr;
+      }
+      bool ok;
       if(version >= 4.1) {
-        for(std::size_t j = 0; j < numNodes; j++) {
-          if(fscanf(fp, "%lu", &tags[j]) != 1) {
-            delete[] vertexCache;
-            return nullptr;
-          }
-        }
+        ok = parseMSH4Lines(
+          buf, lines, tokens, numTokens, nthreads,
+          [&](std::size_t t, const char *&p) {
+            if(t < numNodes) return parseMSH4Token(p, tags[t]);
+            return parseMSH4Token(p, coord[t - numNodes]);
+          });
       }
-      for(std::size_t j = 0; j < numNodes; j++) {
-        std::size_t tagNode = 0;
-        if(version >= 4.1) { tagNode = tags[j]; }
-        else {
-          if(fscanf(fp, "%lu", &tagNode) != 1) {
-            delete[] vertexCache;
-            return nullptr;
-          }
-        }
-        MVertex *mv = nullptr;
-        if(n == 5) {
-          double x, y, z, u, v;
-          if(fscanf(fp, "%lf %lf %lf %lf %lf", &x, &y, &z, &u, &v) != 5) {
-            delete[] vertexCache;
-            return nullptr;
-          }
-          mv = new MFaceVertex(x, y, z, entity, u, v, tagNode);
-        }
-        else if(n == 4) {
-          double x, y, z, u;
-          if(fscanf(fp, "%lf %lf %lf %lf", &x, &y, &z, &u) != 4) {
-            delete[] vertexCache;
-            return nullptr;
-          }
-          mv = new MEdgeVertex(x, y, z, entity, u, tagNode);
-        }
-        else {
-          double x, y, z;
-          if(fscanf(fp, "%lf %lf %lf", &x, &y, &z) != 3) {
-            delete[] vertexCache;
-            return nullptr;
-          }
-          // discard extra parametric coordinates, as Gmsh does not use them
-          for(std::size_t k = 3; k < n; k++) {
-            double dummy;
-            if(fscanf(fp, "%lf", &dummy) != 1) {
-              delete[] vertexCache;
-              return nullptr;
-            }
-          }
-          mv = new MVertex(x, y, z, entity, tagNode);
-        }
-        entity->addMeshVertex(mv);
-        mv->setEntity(entity);
-        minNodeNum = std::min(minNodeNum, tagNode);
-        maxNodeNum = std::max(maxNodeNum, tagNode);
-        vertexCache[nodeRead] = std::make_pair(tagNode, mv);
-        nodeRead++;
-        if(totalNumNodes > 100000)
-          Msg::ProgressMeter(nodeRead, true, "Reading nodes");
+      else {
+        ok = parseMSH4Lines(
+          buf, lines, tokens, numTokens, nthreads,
+          [&](std::size_t t, const char *&p) {
+            std::size_t j = t / (n + 1), k = t % (n + 1);
+            if(!k) return parseMSH4Token(p, tags[j]);
+            return parseMSH4Token(p, coord[n * j + k - 1]);
+          });
+      }
+      if(!ok) {
+        delete[] vertexCache;
+        return nullptr;
       }
     }
+
+#pragma omp parallel for num_threads(nthreads) if(numNodes > 1000)
+    for(std::size_t j = 0; j < numNodes; j++) {
+      const double *c = &coord[n * j];
+      MVertex *mv = nullptr;
+      if(n == 5)
+        mv = new MFaceVertex(c[0], c[1], c[2], entity, c[3], c[4], tags[j]);
+      else if(n == 4)
+        mv = new MEdgeVertex(c[0], c[1], c[2], entity, c[3], tags[j]);
+      else // discard extra parametric coordinates, as Gmsh does not use them
+        mv = new MVertex(c[0], c[1], c[2], entity, tags[j]);
+      vertexCache[nodeRead + j] = std::make_pair(tags[j], mv);
+    }
+
+    entity->mesh_vertices.reserve(entity->mesh_vertices.size() + numNodes);
+    for(std::size_t j = 0; j < numNodes; j++) {
+      entity->addMeshVertex(vertexCache[nodeRead + j].second);
+      minNodeNum = std::min(minNodeNum, tags[j]);
+      maxNodeNum = std::max(maxNodeNum, tags[j]);
+    }
+    nodeRead += numNodes;
+    if(totalNumNodes > 100000)
+      Msg::ProgressMeter(nodeRead, true, "Reading nodes");
   }
 
+  // the maximum node tag is not reliably updated when nodes are created
+  // concurrently
+  GModel::current()->setMaxVertexNumber(maxNodeNum);
+
   if(version >= 4.1) { // consistency check
     if(minTag != minNodeNum || maxTag != maxNodeNum)
       Msg::Warning("Min/Max node tags reported in section header are wrong: "
@@ -710,12 +789,44 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
   return vertexCache;
 }
 
+// Elements that can be created concurrently (elements with parents or
+// children, e.g. polygons or border elements, set up shared data when they are
+// created)
+static bool canCreateMSH4ElementsConcurrently(int elmType)
+{
+  switch(elmType) {
+  case MSH_LIN_B:
+  case MSH_TRI_B:
+  case MSH_POLYG_B:
+  case MSH_LIN_C:
+  case MSH_PNT_SUB:
+  case MSH_LIN_SUB:
+  case MSH_TRI_SUB:
+  case MSH_TET_SUB: return false;
+  default: break;
+  }
+  int parentType = ElementType::getParentType(elmType);
+  return parentType != TYPE_POLYG && parentType != TYPE_POLYH;
+}
+
+static MElement *createMSH4Element(GModel *const model, int elmType,
+                                   const std::size_t *data,
+                                   std::vector<MVertex *> &vertices)
+{
+  for(std::size_t k = 0; k < vertices.size(); k++) {
+    vertices[k] = model->getMeshVertexByTag(data[k + 1]);
+    if(!vertices[k]) return nullptr;
+  }
+  MElementFactory elementFactory;
+  return elementFactory.create(elmType, vertices, data[0], 0, false, 0,
+                               nullptr, nullptr, nullptr);
+}
+
 static std::pair<std::size_t, std::pair<MElement *, int> > *
 readMSH4Elements(GModel *const model, FILE *fp, bool binary, bool &dense,
                  std::size_t &totalNumElements, std::size_t &maxElementNum,
                  bool swap, double version)
 {
-  char str[10000]; // 1000 nodes for order 9 hex, 10 digits each
   std::size_t numBlock = 0, minTag = 0, maxTag = 0;
   totalNumElements = 0;
   maxElementNum = 0;
@@ -743,6 +854,9 @@ readMSH4Elements(GModel *const model, FILE *fp, bool binary, bool &dense,
     }
   }
 
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
   std::size_t elementRead = 0;
   std::size_t minElementNum = std::numeric_limits<std::size_t>::max();
 
@@ -751,6 +865,12 @@ readMSH4Elements(GModel *const model, FILE *fp, bool binary, bool &dense,
   Msg::Info("%lu element%s", totalNumElements, totalNumElements > 1 ? "s" : "");
   Msg::StartProgressMeter(totalNumElements);
 
+  // the blocks are read sequentially, but the data in each block (ASCII
+  // parsing, node lookup and element creation) is processed concurrently
+  std::vector<std::size_t> data;
+  std::vector<char> buf;
+  std::vector<std::size_t> lines, tokens;
+
   for(std::size_t i = 0; i < numBlock; i++) {
     int entityTag = 0, entityDim = 0, elmType = 0;
     std::size_t numElements = 0;
@@ -789,26 +909,37 @@ readMSH4Elements(GModel *const model, FILE *fp, bool binary, bool &dense,
       }
     }
 
+    if(elementRead + numElements > totalNumElements) {
+      Msg::Error("Number of elements in blocks exceeds total number of "
+                 "elements");
+      delete[] elementCache;
+      return nullptr;
+    }
+
     GEntity *entity = model->getEntityByTag(entityDim, entityTag);
     if(!entity) {
       Msg::Error("Unknown entity %d of dimension %d", entityTag, entityDim);
       delete[] elementCache;
       return nullptr;
     }
+    bool ghost = false;
     if(entity->geomType() == GEntity::GhostCurve) {
       static_cast<ghostEdge *>(entity)->haveMesh(true);
+      ghost = true;
     }
     else if(entity->geomType() == GEntity::GhostSurface) {
       static_cast<ghostFace *>(entity)->haveMesh(true);
+      ghost = true;
     }
     else if(entity->geomType() == GEntity::GhostVolume) {
       static_cast<ghostRegion *>(entity)->haveMesh(true);
+      ghost = true;
     }
 
     const int numVertPerElm = MElement::getInfoMSH(elmType);
+    std::size_t n = 1 + numVertPerElm;
+    data.resize(numElements * n);
     if(binary) {
-      std::size_t n = 1 + numVertPerElm;
-      std::vector<std::size_t> data(numElements * n);
       if(fread(&data[0], sizeof(std::size_t), numElements * n, fp) !=
          numElements * n) {
         delete[] elementCache;
@@ -816,109 +947,106 @@ readMSH4Elements(GModel *const model, FILE *fp, bool binary, bool &dense,
       }
       if(swap)
         SwapBytes((char *)&data[0], sizeof(std::size_t), numElements * n);
-
-      std::vector<MVertex *> vertices(numVertPerElm, (MVertex *)nullptr);
-      for(std::size_t j = 0; j < numElements * n; j += n) {
-        for(int k = 0; k < numVertPerElm; k++) {
-          vertices[k] = model->getMeshVertexByTag(data[j + k + 1]);
-          if(!vertices[k]) {
-            Msg::Error("Unknown node %lu in element %lu", data[j + k + 1],
-                       data[j]);
-            delete[] elementCache;
-            return nullptr;
-          }
-        }
-
-        MElementFactory elementFactory;
-        MElement *element = elementFactory.create(
-          elmType, vertices, data[j], 0, false, 0, nullptr, nullptr, nullptr);
-        if(!element) {
-          Msg::Error("Could not create element %lu of type %d", data[j],
-                     elmType);
-          delete[] elementCache;
-          return nullptr;
-        }
-        if(entity->geomType() != GEntity::GhostCurve &&
-           entity->geomType() != GEntity::GhostSurface &&
-           entity->geomType() != GEntity::GhostVolume) {
-          entity->addElement(element->getType(), element);
-        }
-
-        minElementNum = std::min(minElementNum, data[j]);
-        maxElementNum = std::max(maxElementNum, data[j]);
-
-        elementCache[elementRead] =
-          std::make_pair(data[j], std::make_pair(element, entityTag));
-        elementRead++;
-
-        if(totalNumElements > 100000)
-          Msg::ProgressMeter(elementRead, true, "Reading elements");
-      }
     }
     else {
-      for(std::size_t j = 0; j < numElements; j++) {
-        std::size_t elmTag = 0;
-        if(fscanf(fp, "%lu", &elmTag) != 1) {
-          delete[] elementCache;
-          return nullptr;
-        }
-        if(!fgets(str, sizeof(str), fp)) {
-          delete[] elementCache;
-          return nullptr;
-        }
+      if(!readMSH4Lines(fp, numElements * n, buf, lines, tokens) ||
+         !parseMSH4Lines(buf, lines, tokens, numElements * n, nthreads,
+                         [&](std::size_t t, const char *&p) {
+                           return parseMSH4Token(p, data[t]);
+                         })) {
+        delete[] elementCache;
+        return nullptr;
+      }
+    }
 
-        std::vector<MVertex *> vertices(numVertPerElm, (MVertex *)nullptr);
+    // reset the cache of the block, so that all the elements created before
+    // an error can be deleted
+    for(std::size_t j = 0; j < numElements; j++)
+      elementCache[elementRead + j].second.first = nullptr;
 
-        for(int k = 0; k < numVertPerElm; k++) {
-          std::size_t vertexTag = 0;
-          if(k != numVertPerElm - 1) {
-            if(sscanf(str, "%lu %[0-9- ]", &vertexTag, str) != 2) {
-              delete[] elementCache;
-              return nullptr;
-            }
-          }
-          else {
-            if(sscanf(str, "%lu", &vertexTag) != 1) {
-              delete[] elementCache;
-              return nullptr;
+    // create the first element sequentially, as some elements initialize
+    // data shared by all the elements of the same type (e.g. function spaces)
+    // the first time they are created; failed is the index of the first
+    // element that could not be created (it is only written in the critical
+    // section, but read concurrently)
+    std::size_t failed = numElements;
+    std::size_t first =
+      canCreateMSH4ElementsConcurrently(elmType) ? 1 : numElements;
+#pragma omp parallel num_threads(nthreads) if(numElements > 1000 && first == 1)
+    {
+      std::vector<MVertex *> vertices(numVertPerElm, (MVertex *)nullptr);
+#pragma omp single
+      for(std::size_t j = 0; j < std::min(first, numElements); j++) {
+        MElement *e = createMSH4Element(model, elmType, &data[n * j], vertices);
+        if(!e) {
+          failed = j;
+          break;
+        }
+        elementCache[elementRead + j] =
+          std::make_pair(data[n * j], std::make_pair(e, entityTag));
+      }
+#pragma omp for
+      for(std::size_t j = first; j < numElements; j++) {
+        std::size_t f;
+#pragma omp atomic read
+        f = failed;
+        if(f < numElements) continue;
+        MElement *e = createMSH4Element(model, elmType, &data[n * j], vertices);
+        if(!e) {
+#pragma omp critical(readMSH4Elements)
+          {
+#pragma omp atomic read
+            f = failed;
+            if(j < f) {
+#pragma omp atomic write
+              failed = j;
             }
           }
-
-          vertices[k] = model->getMeshVertexByTag(vertexTag);
-          if(!vertices[k]) {
-            Msg::Error("Unknown node %lu in element %lu", vertexTag, elmTag);
-            delete[] elementCache;
-            return nullptr;
-          }
+          continue;
         }
+        elementCache[elementRead + j] =
+          std::make_pair(data[n * j], std::make_pair(e, entityTag));
+      }
+    }
 
-        MElementFactory elementFactory;
-        MElement *element = elementFactory.create(
-          elmType, vertices, elmTag, 0, false, 0, nullptr, nullptr, nullptr);
-        if(!element) {
-          Msg::Error("Could not create element %lu of type %d", elmTag,
-                     elmType);
-          delete[] elementCache;
-          return nullptr;
-        }
-        if(entity->geomType() != GEntity::GhostCurve &&
-           entity->geomType() != GEntity::GhostSurface &&
-           entity->geomType() != GEntity::GhostVolume) {
-          entity->addElement(element->getType(), element);
+    if(failed < numElements) {
+      const std::size_t *d = &data[n * failed];
+      bool unknownNode = false;
+      for(int k = 0; k < numVertPerElm; k++) {
+        if(!model->getMeshVertexByTag(d[k + 1])) {
+          Msg::Error("Unknown node %lu in element %lu", d[k + 1], d[0]);
+          unknownNode = true;
+          break;
         }
+      }
+      if(!unknownNode)
+        Msg::Error("Could not create element %lu of type %d", d[0], elmType);
+      // delete all the elements created for this block, including those
+      // created concurrently after the one that failed
+      for(std::size_t j = 0; j < numElements; j++)
+        delete elementCache[elementRead + j].second.first;
+      delete[] elementCache;
+      return nullptr;
+    }
 
-        minElementNum = std::min(minElementNum, elmTag);
-        maxElementNum = std::max(maxElementNum, elmTag);
-
-        elementCache[elementRead] =
-          std::make_pair(elmTag, std::make_pair(element, entityTag));
-        elementRead++;
-
-        if(totalNumElements > 100000)
-          Msg::ProgressMeter(elementRead, true, "Reading elements");
+    for(std::size_t j = 0; j < numElements; j++) {
+      std::size_t tag = data[n * j];
+      if(!ghost) {
+        MElement *e = elementCache[elementRead + j].second.first;
+        entity->addElement(e->getType(), e);
       }
+      minElementNum = std::min(minElementNum, tag);
+      maxElementNum = std::max(maxElementNum, tag);
     }
+    elementRead += numElements;
+    if(totalNumElements > 100000)
+      Msg::ProgressMeter(elementRead, true, "Reading elements");
   }
+
+  // the maximum element tag is not reliably updated when elements are created
+  // concurrently
+  GModel::current()->setMaxElementNumber(maxElementNum);
+
   // if the vertex numbering is dense, we fill the vector cache, otherwise we
   // fill the map cache
   if(minElementNum == 1 && maxElementNum == totalNumElements) {
@@ -1252,6 +1380,615 @@ static bool readMSH4Parametrizations(GModel *const model, FILE *fp, bool binary)
   return true;
 }
 
+MSH4MappedMesh::MSH4MappedMesh(const std::string &fileName, double version,
+                               bool binary, bool swap)
+  : _fileName(fileName), _version(version), _binary(binary), _swap(swap),
+    _data(nullptr), _size(0), _nodesOffset(0), _elementsOffset(0),
+    _numNodes(0), _maxNodeTag(0), _numElements(0), _maxElementTag(0),
+    _nodeIndexBuilt(false)
+{
+  if(binary && !swap) _data = MapFile(fileName, _size);
+}
+
+MSH4MappedMesh::~MSH4MappedMesh() { UnmapFile(_data, _size); }
+
+bool MSH4MappedMesh::_copy(std::size_t &offset, void *val,
+                           std::size_t size) const
+{
+  if(size > _size || offset > _size - size) return false;
+  memcpy(val, _data + offset, size);
+  offset += size;
+  return true;
+}
+
+bool MSH4MappedMesh::_readHeader(FILE *fp, std::size_t data[4])
+{
+  if(_binary) {
+    if(fread(data, sizeof(std::size_t), 4, fp) != 4) return false;
+    if(_swap) SwapBytes((char *)data, sizeof(std::size_t), 4);
+    return true;
+  }
+  return fscanf(fp, "%lu %lu %lu %lu", &data[0], &data[1], &data[2],
+                &data[3]) == 4;
+}
+
+bool MSH4MappedMesh::_readBlockHeader(FILE *fp, int info[3], std::size_t &num)
+{
+  if(_binary) {
+    if(fread(info, sizeof(int), 3, fp) != 3) return false;
+    if(_swap) SwapBytes((char *)info, sizeof(int), 3);
+    if(fread(&num, sizeof(std::size_t), 1, fp) != 1) return false;
+    if(_swap) SwapBytes((char *)&num, sizeof(std::size_t), 1);
+    return true;
+  }
+  return fscanf(fp, "%d %d %d %lu", &info[0], &info[1], &info[2], &num) == 4;
+}
+
+static bool isMSH4GhostEntity(GEntity *entity)
+{
+  return entity->geomType() == GEntity::GhostCurve ||
+         entity->geomType() == GEntity::GhostSurface ||
+         entity->geomType() == GEntity::GhostVolume;
+}
+
+std::size_t MSH4MappedMesh::indexNodes(GModel *model, std::size_t offset)
+{
+  std::size_t start = offset;
+  _nodeBlocks.clear();
+  _nodeBlocksOfEntity.clear();
+
+  std::size_t data[4];
+  if(!_copy(offset, data, sizeof(data))) return 0;
+  std::size_t numBlock = data[0];
+  _numNodes = data[1];
+  _maxNodeTag = data[3];
+
+  for(std::size_t i = 0; i < numBlock; i++) {
+    nodeBlock b;
+    int info[3];
+    if(!_copy(offset, info, sizeof(info)) ||
+       !_copy(offset, &b.numNodes, sizeof(std::size_t)))
+      return 0;
+    b.dim = info[0];
+    b.tag = info[1];
+    b.parametric = info[2];
+    // the discrete entities that would be created when reading the nodes are
+    // not created here
+    if(!model->getEntityByTag(b.dim, b.tag)) return 0;
+    std::size_t n = 3;
+    if(b.parametric) n += b.dim;
+    if(b.numNodes > _size) return 0;
+    std::size_t size = b.numNodes * (sizeof(std::size_t) + n * sizeof(double));
+    if(size > _size - offset) return 0;
+    b.tags = _data + offset;
+    b.coord = _data + offset + b.numNodes * sizeof(std::size_t);
+    offset += size;
+    _nodeBlocksOfEntity[std::make_pair(b.dim, b.tag)].push_back(
+      _nodeBlocks.size());
+    _nodeBlocks.push_back(b);
+  }
+
+  _nodesOffset = start;
+  return offset;
+}
+
+std::size_t MSH4MappedMesh::indexElements(GModel *model, std::size_t offset)
+{
+  std::size_t start = offset;
+  _elementBlocks.clear();
+  _elementBlocksOfEntity.clear();
+
+  std::size_t data[4];
+  if(!_copy(offset, data, sizeof(data))) return 0;
+  std::size_t numBlock = data[0];
+  _numElements = data[1];
+  _maxElementTag = data[3];
+
+  for(std::size_t i = 0; i < numBlock; i++) {
+    elementBlock b;
+    int info[3];
+    if(!_copy(offset, info, sizeof(info)) ||
+       !_copy(offset, &b.numElements, sizeof(std::size_t)))
+      return 0;
+    b.dim = info[0];
+    b.tag = info[1];
+    b.type = info[2];
+    b.numNodesPerElement = MElement::getInfoMSH(b.type);
+    if(!b.numNodesPerElement) return 0;
+    // ghost entities do not store their elements directly
+    GEntity *entity = model->getEntityByTag(b.dim, b.tag);
+    if(!entity || isMSH4GhostEntity(entity)) return 0;
+    if(b.numElements > _size) return 0;
+    std::size_t size =
+      b.numElements * (1 + b.numNodesPerElement) * sizeof(std::size_t);
+    if(size > _size - offset) return 0;
+    b.data = _data + offset;
+    offset += size;
+    _elementBlocksOfEntity[std::make_pair(b.dim, b.tag)].push_back(
+      _elementBlocks.size());
+    _elementBlocks.push_back(b);
+  }
+
+  _elementsOffset = start;
+  return offset;
+}
+
+bool MSH4MappedMesh::readNodes(GModel *model, FILE *fp)
+{
+  std::size_t start = ftell(fp);
+  _nodeBlocks.clear();
+  _nodeBlocksOfEntity.clear();
+
+  std::size_t data[4];
+  if(!_readHeader(fp, data)) return false;
+  std::size_t numBlock = data[0];
+  _numNodes = data[1];
+  _maxNodeTag = data[3];
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  std::vector<double> coord;
+  std::vector<char> buf;
+  std::vector<std::size_t> lines, tokens;
+
+  for(std::size_t i = 0; i < numBlock; i++) {
+    nodeBlock b;
+    int info[3];
+    if(!_readBlockHeader(fp, info, b.numNodes)) return false;
+    b.dim = info[0];
+    b.tag = info[1];
+    b.parametric = info[2];
+    b.tags = b.coord = nullptr;
+    if(!model->getEntityByTag(b.dim, b.tag)) return false;
+    std::size_t N = b.numNodes, n = 3;
+    if(b.parametric) n += b.dim;
+
+    b.compactTags.resize(N);
+    coord.resize(n * N);
+    if(_binary) {
+      if(N && (fread(&b.compactTags[0], sizeof(std::size_t), N, fp) != N ||
+               fread(&coord[0], sizeof(double), n * N, fp) != n * N))
+        return false;
+      if(N && _swap) {
+        SwapBytes((char *)&b.compactTags[0], sizeof(std::size_t), N);
+        SwapBytes((char *)&coord[0], sizeof(double), n * N);
+      }
+    }
+    else {
+      std::size_t numTokens = (n + 1) * N;
+      if(!readMSH4Lines(fp, numTokens, buf, lines, tokens) ||
+         !parseMSH4Lines(buf, lines, tokens, numTokens, nthreads,
+                         [&](std::size_t t, const char *&p) {
+                           if(t < N) return parseMSH4Token(p, b.compactTags[t]);
+                           return parseMSH4Token(p, coord[t - N]);
+                         }))
+        return false;
+    }
+
+    // Gmsh only stores parametric coordinates for dim 1 and 2
+    b.x.resize(N);
+    b.y.resize(N);
+    b.z.resize(N);
+    if(n > 3 && (b.dim == 1 || b.dim == 2)) b.u.resize(N);
+    if(n > 4 && b.dim == 2) b.v.resize(N);
+#pragma omp parallel for num_threads(nthreads) if(N > 1000)
+    for(std::size_t j = 0; j < N; j++) {
+      const double *c = &coord[n * j];
+      b.x[j] = c[0];
+      b.y[j] = c[1];
+      b.z[j] = c[2];
+      if(b.u.size()) b.u[j] = c[3];
+      if(b.v.size()) b.v[j] = c[4];
+    }
+
+    _nodeBlocksOfEntity[std::make_pair(b.dim, b.tag)].push_back(
+      _nodeBlocks.size());
+    _nodeBlocks.push_back(std::move(b));
+  }
+
+  _nodesOffset = start;
+  return true;
+}
+
+bool MSH4MappedMesh::readElements(GModel *model, FILE *fp)
+{
+  std::size_t start = ftell(fp);
+  _elementBlocks.clear();
+  _elementBlocksOfEntity.clear();
+
+  std::size_t data[4];
+  if(!_readHeader(fp, data)) return false;
+  std::size_t numBlock = data[0];
+  _numElements = data[1];
+  _maxElementTag = data[3];
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  std::vector<char> buf;
+  std::vector<std::size_t> lines, tokens;
+
+  for(std::size_t i = 0; i < numBlock; i++) {
+    elementBlock b;
+    int info[3];
+    if(!_readBlockHeader(fp, info, b.numElements)) return false;
+    b.dim = info[0];
+    b.tag = info[1];
+    b.type = info[2];
+    b.numNodesPerElement = MElement::getInfoMSH(b.type);
+    b.data = nullptr;
+    if(!b.numNodesPerElement) return false;
+    GEntity *entity = model->getEntityByTag(b.dim, b.tag);
+    if(!entity || isMSH4GhostEntity(entity)) return false;
+
+    std::size_t num = b.numElements * (1 + b.numNodesPerElement);
+    b.compactData.resize(num);
+    if(_binary) {
+      if(num && fread(&b.compactData[0], sizeof(std::size_t), num, fp) != num)
+        return false;
+      if(num && _swap)
+        SwapBytes((char *)&b.compactData[0], sizeof(std::size_t), num);
+    }
+    else {
+      if(!readMSH4Lines(fp, num, buf, lines, tokens) ||
+         !parseMSH4Lines(buf, lines, tokens, num, nthreads,
+                         [&](std::size_t t, const char *&p) {
+                           return parseMSH4Token(p, b.compactData[t]);
+                         }))
+        return false;
+    }
+
+    _elementBlocksOfEntity[std::make_pair(b.dim, b.tag)].push_back(
+      _elementBlocks.size());
+    _elementBlocks.push_back(std::move(b));
+  }
+
+  _elementsOffset = start;
+  return true;
+}
+
+std::size_t MSH4MappedMesh::_getNodeTag(const nodeBlock &b,
+                                        std::size_t i) const
+{
+  if(!b.tags) return b.compactTags[i];
+  std::size_t tag;
+  memcpy(&tag, b.tags + i * sizeof(std::size_t), sizeof(std::size_t));
+  return tag;
+}
+
+void MSH4MappedMesh::_getNodeCoord(const nodeBlock &b, std::size_t i,
+                                   double xyz[3],
+                                   std::vector<double> *parametricCoord) const
+{
+  if(!b.coord) {
+    xyz[0] = b.x[i];
+    xyz[1] = b.y[i];
+    xyz[2] = b.z[i];
+    if(parametricCoord) {
+      if(b.u.size()) parametricCoord->push_back(b.u[i]);
+      if(b.v.size()) parametricCoord->push_back(b.v[i]);
+    }
+    return;
+  }
+  std::size_t n = 3;
+  if(b.parametric) n += b.dim;
+  double c[6];
+  memcpy(c, b.coord + n * i * sizeof(double), n * sizeof(double));
+  for(int k = 0; k < 3; k++) xyz[k] = c[k];
+  // Gmsh only stores parametric coordinates for dim 1 and 2
+  if(parametricCoord && (b.dim == 1 || b.dim == 2)) {
+    for(std::size_t k = 3; k < n; k++) parametricCoord->push_back(c[k]);
+  }
+}
+
+void MSH4MappedMesh::getNodes(GEntity *ge, std::vector<std::size_t> &nodeTags,
+                              std::vector<double> &coord,
+                              std::vector<double> &parametricCoord,
+                              bool returnParametricCoord) const
+{
+  auto it = _nodeBlocksOfEntity.find(std::make_pair(ge->dim(), ge->tag()));
+  if(it == _nodeBlocksOfEntity.end()) return;
+  for(std::size_t i = 0; i < it->second.size(); i++) {
+    const nodeBlock &b = _nodeBlocks[it->second[i]];
+    if(!b.numNodes) continue;
+    std::size_t o = nodeTags.size();
+    nodeTags.resize(o + b.numNodes);
+    if(b.tags)
+      memcpy(&nodeTags[o], b.tags, b.numNodes * sizeof(std::size_t));
+    else
+      std::copy(b.compactTags.begin(), b.compactTags.end(), &nodeTags[o]);
+    o = coord.size();
+    coord.resize(o + 3 * b.numNodes);
+    for(std::size_t j = 0; j < b.numNodes; j++)
+      _getNodeCoord(b, j, &coord[o + 3 * j],
+                    returnParametricCoord ? &parametricCoord : nullptr);
+  }
+}
+
+void MSH4MappedMesh::_buildNodeIndex()
+{
+  _nodeBlockStart.resize(_nodeBlocks.size() + 1, 0);
+  std::size_t maxTag = 0;
+  for(std::size_t i = 0; i < _nodeBlocks.size(); i++) {
+    const nodeBlock &b = _nodeBlocks[i];
+    _nodeBlockStart[i + 1] = _nodeBlockStart[i] + b.numNodes;
+    for(std::size_t j = 0; j < b.numNodes; j++)
+      maxTag = std::max(maxTag, _getNodeTag(b, j));
+  }
+  std::size_t numNodes = _nodeBlockStart.back();
+  // same density criterion as for the node cache of the model; as when the
+  // nodes are created, the first node with a given tag is kept
+  if(maxTag < 10 * numNodes) {
+    _nodeIndex.assign(maxTag + 1, std::numeric_limits<std::size_t>::max());
+    for(std::size_t i = 0; i < _nodeBlocks.size(); i++) {
+      const nodeBlock &b = _nodeBlocks[i];
+      for(std::size_t j = 0; j < b.numNodes; j++) {
+        std::size_t &pos = _nodeIndex[_getNodeTag(b, j)];
+        if(pos == std::numeric_limits<std::size_t>::max())
+          pos = _nodeBlockStart[i] + j;
+      }
+    }
+  }
+  else {
+    _sparseNodeIndex.reserve(numNodes);
+    for(std::size_t i = 0; i < _nodeBlocks.size(); i++) {
+      const nodeBlock &b = _nodeBlocks[i];
+      for(std::size_t j = 0; j < b.numNodes; j++)
+        _sparseNodeIndex.push_back(
+          std::make_pair(_getNodeTag(b, j), _nodeBlockStart[i] + j));
+    }
+    std::stable_sort(
+      _sparseNodeIndex.begin(), _sparseNodeIndex.end(),
+      [](const std::pair<std::size_t, std::size_t> &a,
+         const std::pair<std::size_t, std::size_t> &b) {
+        return a.first < b.first;
+      });
+  }
+}
+
+bool MSH4MappedMesh::findNode(std::size_t tag, nodeHandle &h)
+{
+  // the index is built by the first caller; concurrent callers wait until it
+  // is available, and then only perform read-only lookups
+  if(!_nodeIndexBuilt.load(std::memory_order_acquire)) {
+#pragma omp critical(MSH4MappedMeshNodeIndex)
+    {
+      if(!_nodeIndexBuilt.load(std::memory_order_acquire)) {
+        _buildNodeIndex();
+        _nodeIndexBuilt.store(true, std::memory_order_release);
+      }
+    }
+  }
+  std::size_t pos = std::numeric_limits<std::size_t>::max();
+  if(_nodeIndex.size()) {
+    if(tag < _nodeIndex.size()) pos = _nodeIndex[tag];
+  }
+  else {
+    auto it = std::lower_bound(
+      _sparseNodeIndex.begin(), _sparseNodeIndex.end(), tag,
+      [](const std::pair<std::size_t, std::size_t> &a, std::size_t t) {
+        return a.first < t;
+      });
+    if(it != _sparseNodeIndex.end() && it->first == tag) pos = it->second;
+  }
+  if(pos == std::numeric_limits<std::size_t>::max()) return false;
+  h.block = std::upper_bound(_nodeBlockStart.begin(), _nodeBlockStart.end(),
+                             pos) - _nodeBlockStart.begin() - 1;
+  h.index = pos - _nodeBlockStart[h.block];
+  return true;
+}
+
+void MSH4MappedMesh::getNode(const nodeHandle &h, std::vector<double> &coord,
+                             std::vector<double> &parametricCoord, int &dim,
+                             int &tag) const
+{
+  const nodeBlock &b = _nodeBlocks[h.block];
+  coord.resize(3);
+  _getNodeCoord(b, h.index, &coord[0], &parametricCoord);
+  dim = b.dim;
+  tag = b.tag;
+}
+
+void MSH4MappedMesh::getElementTypes(GEntity *ge, std::vector<int> &types) const
+{
+  types.clear();
+  auto it = _elementBlocksOfEntity.find(std::make_pair(ge->dim(), ge->tag()));
+  if(it == _elementBlocksOfEntity.end()) return;
+  for(std::size_t i = 0; i < it->second.size(); i++) {
+    int type = _elementBlocks[it->second[i]].type;
+    if(std::find(types.begin(), types.end(), type) == types.end())
+      types.push_back(type);
+  }
+}
+
+std::size_t MSH4MappedMesh::getNumElementsByType(GEntity *ge,
+                                                 int familyType) const
+{
+  auto it = _elementBlocksOfEntity.find(std::make_pair(ge->dim(), ge->tag()));
+  if(it == _elementBlocksOfEntity.end()) return 0;
+  std::size_t num = 0;
+  for(std::size_t i = 0; i < it->second.size(); i++) {
+    const elementBlock &b = _elementBlocks[it->second[i]];
+    if(ElementType::getParentType(b.type) == familyType) num += b.numElements;
+  }
+  return num;
+}
+
+std::size_t MSH4MappedMesh::getElementsByType(GEntity *ge, int familyType,
+                                              std::size_t begin,
+                                              std::size_t end,
+                                              std::size_t *elementTags,
+                                              std::size_t *nodeTags) const
+{
+  auto it = _elementBlocksOfEntity.find(std::make_pair(ge->dim(), ge->tag()));
+  if(it == _elementBlocksOfEntity.end()) return 0;
+  std::size_t o = 0, idx = 0;
+  std::vector<std::size_t> data;
+  for(std::size_t i = 0; i < it->second.size() && o < end; i++) {
+    const elementBlock &b = _elementBlocks[it->second[i]];
+    if(ElementType::getParentType(b.type) != familyType) continue;
+    if(o + b.numElements > begin) {
+      std::size_t bb = std::max(begin, o) - o;
+      std::size_t ee = std::min(end, o + b.numElements) - o;
+      std::size_t n = 1 + b.numNodesPerElement;
+      const std::size_t *d = nullptr;
+      if(b.data) {
+        data.resize(n * (ee - bb));
+        memcpy(&data[0], b.data + n * bb * sizeof(std::size_t),
+               data.size() * sizeof(std::size_t));
+        d = &data[0];
+      }
+      else {
+        d = &b.compactData[n * bb];
+      }
+      std::size_t e0 = o + bb - begin;
+      for(std::size_t j = 0; j < ee - bb; j++) {
+        if(elementTags) elementTags[e0 + j] = d[n * j];
+        if(nodeTags) {
+          for(std::size_t k = 1; k < n; k++) nodeTags[idx++] = d[n * j + k];
+        }
+      }
+    }
+    o += b.numElements;
+  }
+  return idx;
+}
+
+void GModel::materializeMappedMesh()
+{
+  if(!_mappedMesh) return;
+  // reset the mapped mesh first, as the entities are now expected to contain
+  // the actual nodes and elements
+  MSH4MappedMesh *mapped = _mappedMesh;
+  _mappedMesh = nullptr;
+  Msg::Info("Creating nodes and elements from '%s'",
+            mapped->getFileName().c_str());
+  FILE *fp = Fopen(mapped->getFileName().c_str(), "rb");
+  bool ok = (fp != nullptr);
+  if(ok && mapped->getNodesOffset()) {
+    ok = !fseek(fp, mapped->getNodesOffset(), SEEK_SET) &&
+         _readMSH4Nodes(fp, mapped->isBinary(), mapped->isSwapped(),
+                        mapped->getVersion());
+  }
+  if(ok && mapped->getElementsOffset()) {
+    ok = !fseek(fp, mapped->getElementsOffset(), SEEK_SET) &&
+         _readMSH4Elements(fp, mapped->isBinary(), mapped->isSwapped(),
+                           mapped->getVersion());
+  }
+  if(fp) fclose(fp);
+  if(!ok)
+    Msg::Error("Could not create nodes and elements from '%s'",
+               mapped->getFileName().c_str());
+  delete mapped;
+}
+
+bool GModel::_readMSH4Nodes(FILE *fp, bool binary, bool swap, double version)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  _vertexVectorCache.clear();
+  _vertexMapCache.clear();
+  bool dense = false;
+  std::size_t totalNumNodes = 0, maxNodeNum;
+  std::pair<std::size_t, MVertex *> *vertexCache = readMSH4Nodes(
+    this, fp, binary, dense, totalNumNodes, maxNodeNum, swap, version);
+  Msg::StopProgressMeter();
+  if(!vertexCache) return false;
+  if(dense) {
+    _vertexVectorCache.resize(maxNodeNum + 1, nullptr);
+    // fill the cache concurrently, then check that there are no duplicate
+    // nodes; if there are, fill the cache again sequentially, so that the
+    // first node with a given tag is kept
+    bool duplicates = false;
+#pragma omp parallel for num_threads(nthreads)
+    for(std::size_t i = 0; i < totalNumNodes; i++)
+      _vertexVectorCache[vertexCache[i].first] = vertexCache[i].second;
+#pragma omp parallel for num_threads(nthreads)
+    for(std::size_t i = 0; i < totalNumNodes; i++) {
+      if(_vertexVectorCache[vertexCache[i].first] != vertexCache[i].second)
+        duplicates = true;
+    }
+    if(duplicates) {
+      std::fill(_vertexVectorCache.begin(), _vertexVectorCache.end(), nullptr);
+      for(std::size_t i = 0; i < totalNumNodes; i++) {
+        if(!_vertexVectorCache[vertexCache[i].first]) {
+          _vertexVectorCache[vertexCache[i].first] = vertexCache[i].second;
+        }
+        else {
+          Msg::Info("Skipping duplicate node %d", vertexCache[i].first);
+        }
+      }
+    }
+  }
+  else {
+    for(std::size_t i = 0; i < totalNumNodes; i++) {
+      if(_vertexMapCache.count(vertexCache[i].first) == 0) {
+        _vertexMapCache[vertexCache[i].first] = vertexCache[i].second;
+      }
+      else {
+        Msg::Info("Skipping duplicate node %d", vertexCache[i].first);
+      }
+    }
+  }
+  delete[] vertexCache;
+  return true;
+}
+
+bool GModel::_readMSH4Elements(FILE *fp, bool binary, bool swap,
+                               double version)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  bool dense = false;
+  std::size_t totalNumElements = 0, maxElementNum = 0;
+  std::pair<std::size_t, std::pair<MElement *, int> > *elementCache =
+    readMSH4Elements(this, fp, binary, dense, totalNumElements, maxElementNum,
+                     swap, version);
+  Msg::StopProgressMeter();
+  if(!elementCache) return false;
+  if(dense) {
+    _elementVectorCache.resize(maxElementNum + 1, std::make_pair(nullptr, 0));
+    // same strategy as for the nodes
+    bool duplicates = false;
+#pragma omp parallel for num_threads(nthreads)
+    for(std::size_t i = 0; i < totalNumElements; i++)
+      _elementVectorCache[elementCache[i].first] = elementCache[i].second;
+#pragma omp parallel for num_threads(nthreads)
+    for(std::size_t i = 0; i < totalNumElements; i++) {
+      if(_elementVectorCache[elementCache[i].first].first !=
+         elementCache[i].second.first)
+        duplicates = true;
+    }
+    if(duplicates) {
+      std::fill(_elementVectorCache.begin(), _elementVectorCache.end(),
+                std::make_pair((MElement *)nullptr, 0));
+      for(std::size_t i = 0; i < totalNumElements; i++) {
+        if(!_elementVectorCache[elementCache[i].first].first) {
+          _elementVectorCache[elementCache[i].first] = elementCache[i].second;
+        }
+        else {
+          Msg::Info("Skipping duplicate element %d", elementCache[i].first);
+        }
+      }
+    }
+  }
+  else {
+    for(std::size_t i = 0; i < totalNumElements; i++) {
+      if(_elementMapCache.count(elementCache[i].first) == 0) {
+        _elementMapCache[elementCache[i].first] = elementCache[i].second;
+      }
+      else {
+        Msg::Info("Skipping duplicate element %d", elementCache[i].first);
+      }
+    }
+  }
+  delete[] elementCache;
+  return true;
+}
+
 int GModel::_readMSH4(const std::string &name)
 {
   bool partitioned = false;
@@ -1357,77 +2094,78 @@ int GModel::_readMSH4(const std::string &name)
       partitioned = true;
     }
     else if(!strncmp(&str[1], "Nodes", 5)) {
-      _vertexVectorCache.clear();
-      _vertexMapCache.clear();
-      bool dense = false;
-      std::size_t totalNumNodes = 0, maxNodeNum;
-      std::pair<std::size_t, MVertex *> *vertexCache = readMSH4Nodes(
-        this, fp, binary, dense, totalNumNodes, maxNodeNum, swap, version);
-      Msg::StopProgressMeter();
-      if(!vertexCache) {
-        Msg::Error("Could not read nodes");
-        fclose(fp);
-        return false;
-      }
-      if(dense) {
-        _vertexVectorCache.resize(maxNodeNum + 1, nullptr);
-        for(std::size_t i = 0; i < totalNumNodes; i++) {
-          if(!_vertexVectorCache[vertexCache[i].first]) {
-            _vertexVectorCache[vertexCache[i].first] = vertexCache[i].second;
-          }
-          else {
-            Msg::Info("Skipping duplicate node %d", vertexCache[i].first);
+      // if requested, and if the model has no other mesh, only map (or read
+      // in compact arrays) the node blocks; the nodes are then only created
+      // when needed (see materializeMappedMesh)
+      materializeMappedMesh();
+      bool deferred = false;
+      if(CTX::instance()->mesh.mshFileMapping && version >= 4.1 &&
+         !getNumMeshVertices()) {
+        std::size_t offset = ftell(fp);
+        _mappedMesh = new MSH4MappedMesh(name, version, binary, swap);
+        if(_mappedMesh->isMapped()) {
+          std::size_t end = _mappedMesh->indexNodes(this, offset);
+          if(end) {
+            fseek(fp, end, SEEK_SET);
+            deferred = true;
           }
         }
-      }
-      else {
-        for(std::size_t i = 0; i < totalNumNodes; i++) {
-          if(_vertexMapCache.count(vertexCache[i].first) == 0) {
-            _vertexMapCache[vertexCache[i].first] = vertexCache[i].second;
-          }
-          else {
-            Msg::Info("Skipping duplicate node %d", vertexCache[i].first);
-          }
+        else {
+          deferred = _mappedMesh->readNodes(this, fp);
+        }
+        if(!deferred) {
+          delete _mappedMesh;
+          _mappedMesh = nullptr;
+          fseek(fp, offset, SEEK_SET);
         }
       }
-      delete[] vertexCache;
-    }
-    else if(!strncmp(&str[1], "Elements", 8)) {
-      bool dense = false;
-      std::size_t totalNumElements = 0, maxElementNum = 0;
-      std::pair<std::size_t, std::pair<MElement *, int> > *elementCache =
-        readMSH4Elements(this, fp, binary, dense, totalNumElements,
-                         maxElementNum, swap, version);
-      Msg::StopProgressMeter();
-      if(!elementCache) {
-        Msg::Error("Could not read elements");
+      if(deferred) {
+        Msg::Info("%lu node%s (%s)", _mappedMesh->getNumNodes(),
+                  _mappedMesh->getNumNodes() > 1 ? "s" : "",
+                  _mappedMesh->isMapped() ? "mapped" : "compact");
+        setMaxVertexNumber(_mappedMesh->getMaxNodeTag());
+      }
+      else if(!_readMSH4Nodes(fp, binary, swap, version)) {
+        Msg::Error("Could not read nodes");
         fclose(fp);
         return 0;
       }
-      if(dense) {
-        _elementVectorCache.resize(maxElementNum + 1, std::make_pair(nullptr, 0));
-        for(std::size_t i = 0; i < totalNumElements; i++) {
-          if(!_elementVectorCache[elementCache[i].first].first) {
-            _elementVectorCache[elementCache[i].first] = elementCache[i].second;
-          }
-          else {
-            Msg::Info("Skipping duplicate element %d", elementCache[i].first);
+    }
+    else if(!strncmp(&str[1], "Elements", 8)) {
+      bool deferred = false;
+      if(_mappedMesh) {
+        std::size_t offset = ftell(fp);
+        if(_mappedMesh->isMapped()) {
+          std::size_t end = _mappedMesh->indexElements(this, offset);
+          if(end) {
+            fseek(fp, end, SEEK_SET);
+            deferred = true;
           }
         }
-      }
-      else {
-        for(std::size_t i = 0; i < totalNumElements; i++) {
-          if(_elementMapCache.count(elementCache[i].first) == 0) {
-            _elementMapCache[elementCache[i].first] = elementCache[i].second;
-          }
-          else {
-            Msg::Info("Skipping duplicate element %d", elementCache[i].first);
-          }
+        else {
+          deferred = _mappedMesh->readElements(this, fp);
+        }
+        // the elements cannot be deferred: create the nodes, as the elements
+        // will be created from them
+        if(!deferred) {
+          fseek(fp, offset, SEEK_SET);
+          materializeMappedMesh();
         }
       }
-      delete[] elementCache;
+      if(deferred) {
+        Msg::Info("%lu element%s (%s)", _mappedMesh->getNumElements(),
+                  _mappedMesh->getNumElements() > 1 ? "s" : "",
+                  _mappedMesh->isMapped() ? "mapped" : "compact");
+        setMaxElementNumber(_mappedMesh->getMaxElementTag());
+      }
+      else if(!_readMSH4Elements(fp, binary, swap, version)) {
+        Msg::Error("Could not read elements");
+        fclose(fp);
+        return 0;
+      }
     }
     else if(!strncmp(&str[1], "Periodic", 8)) {
+      materializeMappedMesh();
       if(!readMSH4PeriodicNodes(this, fp, binary, swap, version)) {
         Msg::Error("Could not read periodic section");
         fclose(fp);
@@ -1435,6 +2173,7 @@ int GModel::_readMSH4(const std::string &name)
       }
     }
     else if(!strncmp(&str[1], "GhostElements", 13)) {
+      materializeMappedMesh();
       if(!readMSH4GhostElements(this, fp, binary, swap)) {
         Msg::Error("Could not read ghost elements");
         fclose(fp);
@@ -1479,6 +2218,9 @@ int GModel::_readMSH4(const std::string &name)
 
   fclose(fp);
 
+  // partitioned meshes and post-processing data require the actual elements
+  if(partitioned || postpro) materializeMappedMesh();
+
   if(partitioned) {
     // This part is added to ensure the compatibility between the new
     // partitioning and the old one.
@@ -1981,40 +2723,144 @@ static void writeMSH4Entities(GModel *const model, FILE *fp, bool partition,
     fprintf(fp, "$EndEntities\n");
 }
 
-static void writeMSH4EntityNodes(GEntity *ge, FILE *fp, bool binary,
-                                 int saveParametric, double scalingFactor,
-                                 double version)
+// The node and element blocks are formatted concurrently in memory, by chunks
+// of at most MSH4_CHUNK_SIZE nodes or elements, and the chunks are then written
+// in order. Only a limited window of formatted chunks is kept in memory.
+static const std::size_t MSH4_CHUNK_SIZE = 50000;
+
+template <class F>
+static void writeMSH4Chunks(FILE *fp, std::size_t numChunks, F format)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  std::size_t window = 4 * nthreads;
+  std::vector<std::string> buffers(std::min(window, numChunks));
+  for(std::size_t start = 0; start < numChunks; start += window) {
+    std::size_t end = std::min(start + window, numChunks);
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+    for(std::size_t i = start; i < end; i++) {
+      buffers[i - start].clear();
+      format(i, buffers[i - start]);
+    }
+    for(std::size_t i = start; i < end; i++)
+      fwrite(buffers[i - start].data(), 1, buffers[i - start].size(), fp);
+  }
+}
+
+static void appendMSH4(std::string &buf, const char *fmt, ...)
+{
+  char str[256];
+  va_list args, args2;
+  va_start(args, fmt);
+  va_copy(args2, args);
+  int n = vsnprintf(str, sizeof(str), fmt, args);
+  va_end(args);
+  if(n < 0) {
+    Msg::Error("Could not format MSH data '%s'", fmt);
+  }
+  else if(n < (int)sizeof(str)) {
+    buf.append(str, n);
+  }
+  else {
+    // the output was truncated: format it again, directly at the end of the
+    // buffer
+    std::size_t size = buf.size();
+    buf.resize(size + n + 1);
+    vsnprintf(&buf[size], n + 1, fmt, args2);
+    buf.resize(size + n);
+  }
+  va_end(args2);
+}
+
+template <class T>
+static void appendMSH4(std::string &buf, const T &val)
+{
+  buf.append((const char *)&val, sizeof(T));
+}
+
+template <class T>
+static void appendMSH4(std::string &buf, const std::vector<T> &val)
+{
+  if(val.size()) buf.append((const char *)&val[0], val.size() * sizeof(T));
+}
+
+struct MSH4NodeChunk {
+  GEntity *ge;
+  int parametric;
+  // header of the block, or tags or coordinates of nodes [begin, end)
+  enum { HEADER, TAGS, COORDS } type;
+  std::size_t begin, end;
+};
+
+static void getMSH4EntityNodeChunks(GEntity *ge, int saveParametric,
+                                    bool binary, double version,
+                                    std::vector<MSH4NodeChunk> &chunks)
 {
   int parametric = saveParametric;
   if(ge->dim() != 1 && ge->dim() != 2)
     parametric = 0; // Gmsh only stores parametric coordinates for dim 1 and 2
 
-  if(binary) {
-    int entityDim = ge->dim();
-    int entityTag = ge->tag();
-    std::size_t numVerts = ge->getNumMeshVertices();
-    fwrite(&entityDim, sizeof(int), 1, fp);
-    fwrite(&entityTag, sizeof(int), 1, fp);
-    fwrite(&parametric, sizeof(int), 1, fp);
-    fwrite(&numVerts, sizeof(std::size_t), 1, fp);
+  std::size_t N = ge->getNumMeshVertices();
+  MSH4NodeChunk c = {ge, parametric, MSH4NodeChunk::HEADER, 0, 0};
+  chunks.push_back(c);
+  // MSH 4.0 (ASCII) stores the tag of each node before its coordinates
+  if(binary || version >= 4.1) {
+    c.type = MSH4NodeChunk::TAGS;
+    for(c.begin = 0; c.begin < N; c.begin += MSH4_CHUNK_SIZE) {
+      c.end = std::min(c.begin + MSH4_CHUNK_SIZE, N);
+      chunks.push_back(c);
+    }
   }
-  else {
-    fprintf(fp, "%d %d %d %lu\n", (version >= 4.1) ? ge->dim() : ge->tag(),
-            (version >= 4.1) ? ge->tag() : ge->dim(), parametric,
-            ge->getNumMeshVertices());
+  c.type = MSH4NodeChunk::COORDS;
+  for(c.begin = 0; c.begin < N; c.begin += MSH4_CHUNK_SIZE) {
+    c.end = std::min(c.begin + MSH4_CHUNK_SIZE, N);
+    chunks.push_back(c);
+  }
+}
+
+static void formatMSH4NodeChunk(const MSH4NodeChunk &c, std::string &buf,
+                                bool binary, double scalingFactor,
+                                double version)
+{
+  GEntity *ge = c.ge;
+
+  if(c.type == MSH4NodeChunk::HEADER) {
+    if(binary) {
+      appendMSH4(buf, ge->dim());
+      appendMSH4(buf, ge->tag());
+      appendMSH4(buf, c.parametric);
+      appendMSH4(buf, ge->getNumMeshVertices());
+    }
+    else {
+      appendMSH4(buf, "%d %d %d %lu\n",
+                 (version >= 4.1) ? ge->dim() : ge->tag(),
+                 (version >= 4.1) ? ge->tag() : ge->dim(), c.parametric,
+                 ge->getNumMeshVertices());
+    }
+    return;
+  }
+
+  if(c.type == MSH4NodeChunk::TAGS) {
+    if(binary) {
+      std::vector<std::size_t> tags(c.end - c.begin);
+      for(std::size_t i = c.begin; i < c.end; i++)
+        tags[i - c.begin] = ge->getMeshVertex(i)->getNum();
+      appendMSH4(buf, tags);
+    }
+    else {
+      for(std::size_t i = c.begin; i < c.end; i++)
+        appendMSH4(buf, "%lu\n", ge->getMeshVertex(i)->getNum());
+    }
+    return;
   }
 
-  std::size_t N = ge->getNumMeshVertices();
   std::size_t n = 3;
-  if(parametric) n += ge->dim();
+  if(c.parametric) n += ge->dim();
 
   if(binary) {
-    std::vector<size_t> tags(N);
-    for(std::size_t i = 0; i < N; i++) tags[i] = ge->getMeshVertex(i)->getNum();
-    fwrite(&tags[0], sizeof(std::size_t), N, fp);
-    std::vector<double> coord(n * N);
+    std::vector<double> coord(n * (c.end - c.begin));
     std::size_t j = 0;
-    for(std::size_t i = 0; i < N; i++) {
+    for(std::size_t i = c.begin; i < c.end; i++) {
       MVertex *mv = ge->getMeshVertex(i);
       coord[j++] = mv->x() * scalingFactor;
       coord[j++] = mv->y() * scalingFactor;
@@ -2022,33 +2868,29 @@ static void writeMSH4EntityNodes(GEntity *ge, FILE *fp, bool binary,
       if(n >= 4) mv->getParameter(0, coord[j++]);
       if(n == 5) mv->getParameter(1, coord[j++]);
     }
-    fwrite(&coord[0], sizeof(double), n * N, fp);
+    appendMSH4(buf, coord);
+    return;
   }
-  else {
-    if(version >= 4.1) {
-      for(std::size_t i = 0; i < N; i++)
-        fprintf(fp, "%lu\n", ge->getMeshVertex(i)->getNum());
+
+  for(std::size_t i = c.begin; i < c.end; i++) {
+    MVertex *mv = ge->getMeshVertex(i);
+    double x = mv->x() * scalingFactor;
+    double y = mv->y() * scalingFactor;
+    double z = mv->z() * scalingFactor;
+    if(version < 4.1) appendMSH4(buf, "%lu ", mv->getNum());
+    if(n == 5) {
+      double u, v;
+      mv->getParameter(0, u);
+      mv->getParameter(1, v);
+      appendMSH4(buf, "%.16g %.16g %.16g %.16g %.16g\n", x, y, z, u, v);
     }
-    for(std::size_t i = 0; i < N; i++) {
-      MVertex *mv = ge->getMeshVertex(i);
-      double x = mv->x() * scalingFactor;
-      double y = mv->y() * scalingFactor;
-      double z = mv->z() * scalingFactor;
-      if(version < 4.1) fprintf(fp, "%lu ", mv->getNum());
-      if(n == 5) {
-        double u, v;
-        mv->getParameter(0, u);
-        mv->getParameter(1, v);
-        fprintf(fp, "%.16g %.16g %.16g %.16g %.16g\n", x, y, z, u, v);
-      }
-      else if(n == 4) {
-        double u;
-        mv->getParameter(0, u);
-        fprintf(fp, "%.16g %.16g %.16g %.16g\n", x, y, z, u);
-      }
-      else {
-        fprintf(fp, "%.16g %.16g %.16g\n", x, y, z);
-      }
+    else if(n == 4) {
+      double u;
+      mv->getParameter(0, u);
+      appendMSH4(buf, "%.16g %.16g %.16g %.16g\n", x, y, z, u);
+    }
+    else {
+      appendMSH4(buf, "%.16g %.16g %.16g\n", x, y, z);
     }
   }
 }
@@ -2341,22 +3183,22 @@ static void writeMSH4Nodes(GModel *const model, FILE *fp, bool partitioned,
     }
   }
 
+  std::vector<MSH4NodeChunk> chunks;
   for(auto it = vertices.begin(); it != vertices.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    getMSH4EntityNodeChunks(*it, saveParametric, binary, version, chunks);
   }
   for(auto it = edges.begin(); it != edges.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    getMSH4EntityNodeChunks(*it, saveParametric, binary, version, chunks);
   }
   for(auto it = faces.begin(); it != faces.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    getMSH4EntityNodeChunks(*it, saveParametric, binary, version, chunks);
   }
   for(auto it = regions.begin(); it != regions.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    getMSH4EntityNodeChunks(*it, saveParametric, binary, version, chunks);
   }
+  writeMSH4Chunks(fp, chunks.size(), [&](std::size_t i, std::string &buf) {
+    formatMSH4NodeChunk(chunks[i], buf, binary, scalingFactor, version);
+  });
 
   if(binary) fprintf(fp, "\n");
 
@@ -2481,51 +3323,67 @@ static void writeMSH4Elements(GModel *const model, FILE *fp, bool partitioned,
       fprintf(fp, "%lu %lu\n", numSection, numElements);
   }
 
+  // each chunk is made of elements [begin, end) of a block, preceded by the
+  // header of the block if begin == 0
+  struct chunk {
+    int dim, entityTag, elmType;
+    const std::vector<MElement *> *elements;
+    std::size_t begin, end;
+  };
+  std::vector<chunk> chunks;
   for(int dim = 0; dim <= 3; dim++) {
     for(auto it = elementsByType[dim].begin(); it != elementsByType[dim].end();
         ++it) {
-      int entityTag = it->first.first;
-      int elmType = it->first.second;
-      std::size_t numElm = it->second.size();
+      std::size_t N = it->second.size();
+      chunk c = {dim, it->first.first, it->first.second, &it->second, 0, 0};
+      do {
+        c.end = std::min(c.begin + MSH4_CHUNK_SIZE, N);
+        chunks.push_back(c);
+        c.begin = c.end;
+      } while(c.begin < N);
+    }
+  }
+
+  writeMSH4Chunks(fp, chunks.size(), [&](std::size_t k, std::string &buf) {
+    const chunk &c = chunks[k];
+    if(!c.begin) {
+      std::size_t numElm = c.elements->size();
       if(binary) {
-        fwrite(&dim, sizeof(int), 1, fp);
-        fwrite(&entityTag, sizeof(int), 1, fp);
-        fwrite(&elmType, sizeof(int), 1, fp);
-        fwrite(&numElm, sizeof(std::size_t), 1, fp);
+        appendMSH4(buf, c.dim);
+        appendMSH4(buf, c.entityTag);
+        appendMSH4(buf, c.elmType);
+        appendMSH4(buf, numElm);
       }
       else {
-        fprintf(fp, "%d %d %d %lu\n", (version >= 4.1) ? dim : entityTag,
-                (version >= 4.1) ? entityTag : dim, elmType, numElm);
+        appendMSH4(buf, "%d %d %d %lu\n",
+                   (version >= 4.1) ? c.dim : c.entityTag,
+                   (version >= 4.1) ? c.entityTag : c.dim, c.elmType, numElm);
       }
-
-      std::size_t N = it->second.size();
-      if(binary) {
-        const int numVertPerElm = MElement::getInfoMSH(elmType);
-        std::size_t n = 1 + numVertPerElm;
-        std::vector<std::size_t> tags(N * n);
-        std::size_t k = 0;
-        for(std::size_t i = 0; i < N; i++) {
-          MElement *e = it->second[i];
-          tags[k] = e->getNum();
-          for(int j = 0; j < numVertPerElm; j++) {
-            tags[k + 1 + j] = e->getVertex(j)->getNum();
-          }
-          k += n;
-        }
-        fwrite(&tags[0], sizeof(std::size_t), N * n, fp);
+    }
+    if(binary) {
+      const int numVertPerElm = MElement::getInfoMSH(c.elmType);
+      std::size_t n = 1 + numVertPerElm;
+      std::vector<std::size_t> tags(n * (c.end - c.begin));
+      std::size_t k = 0;
+      for(std::size_t i = c.begin; i < c.end; i++) {
+        MElement *e = (*c.elements)[i];
+        tags[k] = e->getNum();
+        for(int j = 0; j < numVertPerElm; j++)
+          tags[k + 1 + j] = e->getVertex(j)->getNum();
+        k += n;
       }
-      else {
-        for(std::size_t i = 0; i < N; i++) {
-          MElement *e = it->second[i];
-          fprintf(fp, "%lu ", e->getNum());
-          for(std::size_t i = 0; i < e->getNumVertices(); i++) {
-            fprintf(fp, "%lu ", e->getVertex(i)->getNum());
-          }
-          fprintf(fp, "\n");
-        }
+      appendMSH4(buf, tags);
+    }
+    else {
+      for(std::size_t i = c.begin; i < c.end; i++) {
+        MElement *e = (*c.elements)[i];
+        appendMSH4(buf, "%lu ", e->getNum());
+        for(std::size_t j = 0; j < e->getNumVertices(); j++)
+          appendMSH4(buf, "%lu ", e->getVertex(j)->getNum());
+        buf += "\n";
       }
     }
-  }
+  });
 
   if(binary) fprintf(fp, "\n");
 
@@ -0,0 +1,144 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef GMODELIO_MSH4_H
+#define GMODELIO_MSH4_H
+
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+class GModel;
+class GEntity;
+
+// The node and element blocks of an MSH4 file, from which nodes and elements
+// can be queried without creating the corresponding MVertex and MElement
+// objects.
+//
+// Binary files with the same endianness and size_t size as the machine are
+// mapped read-only in memory, and the blocks directly refer to the mapped
+// data. The data is not aligned in the file, and is thus always accessed
+// through memcpy. Other files (ASCII MSH 4.1 or byte-swapped binary files) are
+// read in compact per-block arrays: the node tags, the coordinates and the
+// parametric coordinates are stored in separate contiguous arrays (32 bytes
+// per node, plus the parametric coordinates, instead of about 80 bytes for an
+// individually allocated MVertex), and the element data in a single array.
+//
+// This is thus only a read-only store for the API functions listed in the help
+// of Mesh.MshFileMapping: all the other API functions first create all the
+// nodes and elements (see GModel::materializeMappedMesh), and the rest of Gmsh
+// (GModel::getMeshVertexByTag(), the mesh generators, the mesh I/O functions)
+// only works on the created MVertex and MElement objects.
+class MSH4MappedMesh {
+public:
+  // a lightweight reference to a node, i.e. its block and its index in the
+  // block
+  struct nodeHandle {
+    std::size_t block, index;
+  };
+
+private:
+  struct nodeBlock {
+    int dim, tag, parametric;
+    std::size_t numNodes;
+    // mapped data
+    const char *tags, *coord;
+    // compact data, for files that are not mapped
+    std::vector<std::size_t> compactTags;
+    std::vector<double> x, y, z, u, v;
+  };
+  struct elementBlock {
+    int dim, tag, type, numNodesPerElement;
+    std::size_t numElements;
+    // mapped data
+    const char *data;
+    // compact data, for files that are not mapped
+    std::vector<std::size_t> compactData;
+  };
+  std::string _fileName;
+  double _version;
+  bool _binary, _swap;
+  const char *_data;
+  std::size_t _size;
+  // offsets of the node and element sections in the file (0 if not available)
+  std::size_t _nodesOffset, _elementsOffset;
+  std::vector<nodeBlock> _nodeBlocks;
+  std::vector<elementBlock> _elementBlocks;
+  std::map<std::pair<int, int>, std::vector<std::size_t> > _nodeBlocksOfEntity;
+  std::map<std::pair<int, int>, std::vector<std::size_t> >
+    _elementBlocksOfEntity;
+  std::size_t _numNodes, _maxNodeTag, _numElements, _maxElementTag;
+  // index of the nodes by tag, built on the first lookup: position of the
+  // first node of each block in the list of all the nodes, and position of
+  // each node in this list, either by tag (if the numbering is dense) or as
+  // (tag, position) pairs sorted by tag
+  std::atomic<bool> _nodeIndexBuilt;
+  std::vector<std::size_t> _nodeBlockStart, _nodeIndex;
+  std::vector<std::pair<std::size_t, std::size_t> > _sparseNodeIndex;
+  bool _copy(std::size_t &offset, void *val, std::size_t size) const;
+  bool _readHeader(FILE *fp, std::size_t data[4]);
+  bool _readBlockHeader(FILE *fp, int info[3], std::size_t &num);
+  std::size_t _getNodeTag(const nodeBlock &b, std::size_t i) const;
+  void _getNodeCoord(const nodeBlock &b, std::size_t i, double xyz[3],
+                     std::vector<double> *parametricCoord) const;
+  void _buildNodeIndex();
+
+public:
+  MSH4MappedMesh(const std::string &fileName, double version, bool binary,
+                 bool swap);
+  ~MSH4MappedMesh();
+  bool isMapped() const { return _data != nullptr; }
+  const std::string &getFileName() const { return _fileName; }
+  double getVersion() const { return _version; }
+  bool isBinary() const { return _binary; }
+  bool isSwapped() const { return _swap; }
+  std::size_t getNodesOffset() const { return _nodesOffset; }
+  std::size_t getElementsOffset() const { return _elementsOffset; }
+  std::size_t getNumNodes() const { return _numNodes; }
+  std::size_t getMaxNodeTag() const { return _maxNodeTag; }
+  std::size_t getNumElements() const { return _numElements; }
+  std::size_t getMaxElementTag() const { return _maxElementTag; }
+  // index the blocks of the $Nodes (resp. $Elements) section of a mapped
+  // file, whose data starts at the given offset in the file, without reading
+  // the nodes (resp. elements) themselves; returns the offset of the end of
+  // the data, or 0 if the section cannot be mapped (e.g. if it refers to
+  // entities that do not exist in the model)
+  std::size_t indexNodes(GModel *model, std::size_t offset);
+  std::size_t indexElements(GModel *model, std::size_t offset);
+  // read the blocks of the $Nodes (resp. $Elements) section of a file that is
+  // not mapped in compact arrays, starting at the current position of fp;
+  // returns false if the section cannot be read this way
+  bool readNodes(GModel *model, FILE *fp);
+  bool readElements(GModel *model, FILE *fp);
+  // append the tags, coordinates and (if requested) parametric coordinates of
+  // the nodes classified on the given entity
+  void getNodes(GEntity *ge, std::vector<std::size_t> &nodeTags,
+                std::vector<double> &coord,
+                std::vector<double> &parametricCoord,
+                bool returnParametricCoord) const;
+  // find the node with the given tag; returns false if it does not exist (can
+  // be called concurrently)
+  bool findNode(std::size_t tag, nodeHandle &h);
+  // get the coordinates, the parametric coordinates and the classification of
+  // a node
+  void getNode(const nodeHandle &h, std::vector<double> &coord,
+               std::vector<double> &parametricCoord, int &dim, int &tag) const;
+  // get the (MSH) types of the elements classified on the given entity
+  void getElementTypes(GEntity *ge, std::vector<int> &types) const;
+  // get the number of elements of the given family (TYPE_TRI, ...) classified
+  // on the given entity
+  std::size_t getNumElementsByType(GEntity *ge, int familyType) const;
+  // copy the tags and the node tags of the elements [begin, end[ of the given
+  // family classified on the given entity (elementTags and/or nodeTags can be
+  // null); returns the number of node tags
+  std::size_t getElementsByType(GEntity *ge, int familyType, std::size_t begin,
+                                std::size_t end, std::size_t *elementTags,
+                                std::size_t *nodeTags) const;
+};
+
+#endif
@@ -484,6 +484,7 @@ public:
   void reset() {}
   void setMaxTag(int dim, int val) {}
   int getMaxTag(int dim) const { return 0; }
+  void *find(int dim, int tag) { return nullptr; }
   bool addVertex(int &tag, double x, double y, double z,
                  double meshSize = MAX_LC)
   {
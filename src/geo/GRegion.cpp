@@ -38,6 +38,7 @@ GRegion::~GRegion()
 
 void GRegion::deleteMesh()
 {
+  meshSignature = 0;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   transfinite_vertices.clear();
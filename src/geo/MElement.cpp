@@ -58,11 +58,21 @@ void MElement::forceNum(std::size_t num)
   m->setMaxElementNumber(_num);
 }
 
+thread_local double MElement::_isInsideTolerance = 0.;
+
 double MElement::getTolerance() const
 {
+  if(_isInsideTolerance) return _isInsideTolerance;
   return CTX::instance()->mesh.toleranceReferenceElement;
 }
 
+double MElement::overrideTolerance(double tol)
+{
+  double old = _isInsideTolerance;
+  _isInsideTolerance = tol;
+  return old;
+}
+
 bool MElement::_getFaceInfo(const MFace &face, const MFace &other, int &sign,
                             int &rot)
 {
@@ -40,8 +40,9 @@ private:
 
 protected:
   // the tolerance used to determine if a point is inside an element, in
-  // parametric coordinates
-  static double _isInsideTolerance;
+  // parametric coordinates, if it is overridden for the calling thread (0
+  // otherwise)
+  static thread_local double _isInsideTolerance;
 
 protected:
   void _getEdgeRep(MVertex *v0, MVertex *v1, double *x, double *y, double *z,
@@ -64,6 +65,11 @@ public:
   // element
   double getTolerance() const;
 
+  // override the tolerance for the calling thread (tol = 0 restores the
+  // default tolerance, i.e. Mesh.ToleranceReferenceElement); returns the
+  // previous override
+  static double overrideTolerance(double tol);
+
   // return the tag of the element
   virtual std::size_t getNum() const { return _num; }
 
@@ -3,16 +3,17 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
+#include <set>
 #include "GModel.h"
 #include "MElement.h"
 #include "MElementOctree.h"
-#include "Octree.h"
 #include "Context.h"
+#include "GmshMessage.h"
 #include "fullMatrix.h"
 #include "bezierBasis.h"
 #include "BasisFactory.h"
 #include "SBoundingBox3d.h"
-#include "Context.h"
 
 void MElementBB(void *a, double *min, double *max)
 {
@@ -61,26 +62,6 @@ void MElementBB(void *a, double *min, double *max)
   min[2] = bb.min().z();
 }
 
-static void MElementCentroid(void *a, double *x)
-{
-  MElement *e = (MElement *)a;
-  MVertex *v = e->getVertex(0);
-  int n = e->getNumVertices();
-  x[0] = v->x();
-  x[1] = v->y();
-  x[2] = v->z();
-  for(int i = 1; i < n; i++) {
-    v = e->getVertex(i);
-    x[0] += v->x();
-    x[1] += v->y();
-    x[2] += v->z();
-  }
-  double oc = 1. / (double)n;
-  x[0] *= oc;
-  x[1] *= oc;
-  x[2] *= oc;
-}
-
 int MElementInEle(void *a, double *x)
 {
   MElement *e = (MElement *)a;
@@ -89,59 +70,159 @@ int MElementInEle(void *a, double *x)
   return e->isInside(uvw[0], uvw[1], uvw[2]) ? 1 : 0;
 }
 
+// maximum number of elements in a leaf of the hierarchy
+static const std::size_t MELEMENT_OCTREE_LEAF_SIZE = 8;
+
+static std::size_t numNodes(std::size_t n)
+{
+  if(n <= MELEMENT_OCTREE_LEAF_SIZE) return 1;
+  return 1 + numNodes(n / 2) + numNodes(n - n / 2);
+}
+
+template <class N>
+static void buildNodes(std::vector<N> &nodes, std::size_t index,
+                       std::size_t *idx, std::size_t b, std::size_t e,
+                       const std::vector<double> &bbox)
+{
+  N &n = nodes[index];
+  for(int k = 0; k < 3; k++) {
+    n.min[k] = bbox[6 * idx[b] + k];
+    n.max[k] = bbox[6 * idx[b] + 3 + k];
+  }
+  double cmin[3] = {1e200, 1e200, 1e200}, cmax[3] = {-1e200, -1e200, -1e200};
+  for(std::size_t i = b; i < e; i++) {
+    const double *bb = &bbox[6 * idx[i]];
+    for(int k = 0; k < 3; k++) {
+      n.min[k] = std::min(n.min[k], bb[k]);
+      n.max[k] = std::max(n.max[k], bb[3 + k]);
+      double c = 0.5 * (bb[k] + bb[3 + k]);
+      cmin[k] = std::min(cmin[k], c);
+      cmax[k] = std::max(cmax[k], c);
+    }
+  }
+  if(e - b <= MELEMENT_OCTREE_LEAF_SIZE) {
+    n.first = b;
+    n.num = e - b;
+    return;
+  }
+  // split at the median of the centers of the boxes, along the largest
+  // dimension of their bounding box
+  int axis = 0;
+  for(int k = 1; k < 3; k++)
+    if(cmax[k] - cmin[k] > cmax[axis] - cmin[axis]) axis = k;
+  std::size_t m = b + (e - b) / 2;
+  std::nth_element(idx + b, idx + m, idx + e,
+                   [&bbox, axis](std::size_t i, std::size_t j) {
+                     return bbox[6 * i + axis] + bbox[6 * i + 3 + axis] <
+                            bbox[6 * j + axis] + bbox[6 * j + 3 + axis];
+                   });
+  std::size_t right = index + 1 + numNodes(m - b);
+  n.first = right;
+  n.num = 0;
+  // reference arguments must be explicitly shared, as they would otherwise be
+  // firstprivate, i.e. copied, in the tasks
+#pragma omp task if(e - b > 10000) shared(nodes, bbox)
+  buildNodes(nodes, index + 1, idx, b, m, bbox);
+#pragma omp task if(e - b > 10000) shared(nodes, bbox)
+  buildNodes(nodes, right, idx, m, e, bbox);
+#pragma omp taskwait
+}
+
+void MElementOctree::_build()
+{
+  std::size_t N = _elems.size();
+  _nodes.clear();
+  _bbox.clear();
+  if(!N) return;
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // the bounding boxes of first order elements are computed concurrently;
+  // those of high-order elements require Bezier bases, which are created
+  // sequentially (as are the function spaces of all the element types, which
+  // are used by the queries)
+  std::vector<double> bbox(6 * N);
+#pragma omp parallel for num_threads(nthreads) if(N > 1000)
+  for(std::size_t i = 0; i < N; i++) {
+    if(_elems[i]->getPolynomialOrder() == 1)
+      MElementBB(_elems[i], &bbox[6 * i], &bbox[6 * i + 3]);
+  }
+  std::set<int> types;
+  for(std::size_t i = 0; i < N; i++) {
+    if(_elems[i]->getPolynomialOrder() != 1)
+      MElementBB(_elems[i], &bbox[6 * i], &bbox[6 * i + 3]);
+    if(types.insert(_elems[i]->getTypeForMSH()).second)
+      _elems[i]->getFunctionSpace();
+  }
+
+  std::vector<std::size_t> idx(N);
+  for(std::size_t i = 0; i < N; i++) idx[i] = i;
+  _nodes.resize(numNodes(N));
+#pragma omp parallel num_threads(nthreads) if(N > 10000)
+#pragma omp single
+  buildNodes(_nodes, 0, &idx[0], 0, N, bbox);
+
+  std::vector<MElement *> elems(N);
+  _bbox.resize(6 * N);
+  for(std::size_t i = 0; i < N; i++) {
+    elems[i] = _elems[idx[i]];
+    for(int k = 0; k < 6; k++) _bbox[6 * i + k] = bbox[6 * idx[i] + k];
+  }
+  _elems.swap(elems);
+}
+
 MElementOctree::MElementOctree(GModel *m) : _gm(m)
 {
-  SBoundingBox3d bb = m->bounds();
-  bb.thicken(0.01); // make 1% thicker
-  SPoint3 bbmin = bb.min(), bbmax = bb.max();
-  double min[3] = {bbmin.x(), bbmin.y(), bbmin.z()};
-  double size[3] = {bbmax.x() - bbmin.x(), bbmax.y() - bbmin.y(),
-                    bbmax.z() - bbmin.z()};
-  const int maxElePerBucket = 100; // memory vs. speed trade-off
-  _octree = Octree_Create(maxElePerBucket, min, size, MElementBB,
-                          MElementCentroid, MElementInEle);
   std::vector<GEntity *> entities;
   m->getEntities(entities);
   // do not add Gvertex non-associated to any GEdge
   for(std::size_t i = 0; i < entities.size(); i++) {
-    for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-      if(entities[i]->dim() == 0) {
-        GVertex *gv = dynamic_cast<GVertex *>(entities[i]);
-        if(gv && gv->edges().size() > 0) {
-          Octree_Insert(entities[i]->getMeshElement(j), _octree);
-        }
-      }
-      else
-        Octree_Insert(entities[i]->getMeshElement(j), _octree);
+    if(entities[i]->dim() == 0) {
+      GVertex *gv = dynamic_cast<GVertex *>(entities[i]);
+      if(!gv || gv->edges().empty()) continue;
     }
+    for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++)
+      _elems.push_back(entities[i]->getMeshElement(j));
   }
-  Octree_Arrange(_octree);
+  _build();
 }
 
 MElementOctree::MElementOctree(const std::vector<MElement *> &v)
   : _gm(nullptr), _elems(v)
 {
-  SBoundingBox3d bb;
-  for(std::size_t i = 0; i < v.size(); i++) {
-    for(std::size_t j = 0; j < v[i]->getNumVertices(); j++) {
-      bb += SPoint3(v[i]->getVertex(j)->x(), v[i]->getVertex(j)->y(),
-                    v[i]->getVertex(j)->z());
+  _build();
+}
+
+// call f(e) for each element e whose bounding box contains P, until f returns
+// true
+template <class F> void MElementOctree::_search(const double P[3], F f) const
+{
+  if(_nodes.empty()) return;
+  // the depth of the hierarchy is at most log2(number of elements) + 1
+  std::size_t stack[128];
+  int top = 0;
+  stack[top++] = 0;
+  while(top) {
+    const node &n = _nodes[stack[--top]];
+    if(P[0] < n.min[0] || P[0] > n.max[0] || P[1] < n.min[1] ||
+       P[1] > n.max[1] || P[2] < n.min[2] || P[2] > n.max[2])
+      continue;
+    if(!n.num) {
+      stack[top++] = n.first;
+      stack[top++] = &n - &_nodes[0] + 1;
+      continue;
+    }
+    for(std::size_t i = n.first; i < n.first + n.num; i++) {
+      const double *bb = &_bbox[6 * i];
+      if(P[0] < bb[0] || P[0] > bb[3] || P[1] < bb[1] || P[1] > bb[4] ||
+         P[2] < bb[2] || P[2] > bb[5])
+        continue;
+      if(f(_elems[i])) return;
     }
   }
-  bb.thicken(0.01); // make 1% thicker
-  SPoint3 bbmin = bb.min(), bbmax = bb.max();
-  double min[3] = {bbmin.x(), bbmin.y(), bbmin.z()};
-  double size[3] = {bbmax.x() - bbmin.x(), bbmax.y() - bbmin.y(),
-                    bbmax.z() - bbmin.z()};
-  const int maxElePerBucket = 100; // memory vs. speed trade-off
-  _octree = Octree_Create(maxElePerBucket, min, size, MElementBB,
-                          MElementCentroid, MElementInEle);
-  for(std::size_t i = 0; i < v.size(); i++) Octree_Insert(v[i], _octree);
-  Octree_Arrange(_octree);
 }
 
-MElementOctree::~MElementOctree() { Octree_Delete(_octree); }
-
 std::vector<MElement *> MElementOctree::findAll(double x, double y, double z,
                                                 int dim, bool strict) const
 {
@@ -149,19 +230,20 @@ std::vector<MElement *> MElementOctree::findAll(double x, double y, double z,
   double tolIncr = 10.;
 
   double P[3] = {x, y, z};
-  std::vector<void *> v;
   std::vector<MElement *> e;
-  Octree_SearchAll(P, _octree, &v);
-  for(auto it = v.begin(); it != v.end(); ++it) {
-    MElement *el = (MElement *)*it;
-    if(dim == -1 || el->getDim() == dim) e.push_back(el);
-  }
+  _search(P, [&](MElement *el) {
+    if((dim == -1 || el->getDim() == dim) && MElementInEle(el, P))
+      e.push_back(el);
+    return false;
+  });
   if(e.empty() && !strict && _gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
+    // the tolerance is only modified for the calling thread
+    double initialTol = MElement::overrideTolerance(0.);
+    double tol = initialTol ? initialTol :
+                              CTX::instance()->mesh.toleranceReferenceElement;
     while(tol < maxTol) {
       tol *= tolIncr;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
+      MElement::overrideTolerance(tol);
       std::vector<GEntity *> entities;
       _gm->getEntities(entities);
       for(std::size_t i = 0; i < entities.size(); i++) {
@@ -173,18 +255,19 @@ std::vector<MElement *> MElementOctree::findAll(double x, double y, double z,
         }
       }
       if(!e.empty()) {
-        CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+        MElement::overrideTolerance(initialTol);
         return e;
       }
     }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+    MElement::overrideTolerance(initialTol);
   }
   else if(e.empty() && !strict && !_gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
+    double initialTol = MElement::overrideTolerance(0.);
+    double tol = initialTol ? initialTol :
+                              CTX::instance()->mesh.toleranceReferenceElement;
     while(tol < maxTol) {
       tol *= tolIncr;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
+      MElement::overrideTolerance(tol);
       for(std::size_t i = 0; i < _elems.size(); i++) {
         MElement *el = _elems[i];
         if(dim == -1 || el->getDim() == dim) {
@@ -192,11 +275,11 @@ std::vector<MElement *> MElementOctree::findAll(double x, double y, double z,
         }
       }
       if(!e.empty()) {
-        CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+        MElement::overrideTolerance(initialTol);
         return e;
       }
     }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+    MElement::overrideTolerance(initialTol);
     // Msg::Warning("Point %g %g %g not found",x,y,z);
   }
   return e;
@@ -206,22 +289,23 @@ MElement *MElementOctree::find(double x, double y, double z, int dim,
                                bool strict) const
 {
   double P[3] = {x, y, z};
-  MElement *e = (MElement *)Octree_Search(P, _octree);
-  if(e && (dim == -1 || e->getDim() == dim)) return e;
-  std::vector<void *> l;
-  if(e && e->getDim() != dim) {
-    Octree_SearchAll(P, _octree, &l);
-    for(auto it = l.begin(); it != l.end(); it++) {
-      MElement *el = (MElement *)*it;
-      if(el->getDim() == dim) { return el; }
+  MElement *e = nullptr;
+  _search(P, [&](MElement *el) {
+    if((dim == -1 || el->getDim() == dim) && MElementInEle(el, P)) {
+      e = el;
+      return true;
     }
-  }
+    return false;
+  });
+  if(e) return e;
   if(!strict && _gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
+    // the tolerance is only modified for the calling thread
+    double initialTol = MElement::overrideTolerance(0.);
+    double tol = initialTol ? initialTol :
+                              CTX::instance()->mesh.toleranceReferenceElement;
     while(tol < 1.) {
       tol *= 10;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
+      MElement::overrideTolerance(tol);
       std::vector<GEntity *> entities;
       _gm->getEntities(entities);
       for(std::size_t i = 0; i < entities.size(); i++) {
@@ -229,33 +313,34 @@ MElement *MElementOctree::find(double x, double y, double z, int dim,
           e = entities[i]->getMeshElement(j);
           if(dim == -1 || e->getDim() == dim) {
             if(MElementInEle(e, P)) {
-              CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+              MElement::overrideTolerance(initialTol);
               return e;
             }
           }
         }
       }
     }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+    MElement::overrideTolerance(initialTol);
     // Msg::Warning("Point %g %g %g not found",x,y,z);
   }
   else if(!strict && !_gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
+    double initialTol = MElement::overrideTolerance(0.);
+    double tol = initialTol ? initialTol :
+                              CTX::instance()->mesh.toleranceReferenceElement;
     while(tol < 0.1) {
       tol *= 10.0;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
+      MElement::overrideTolerance(tol);
       for(std::size_t i = 0; i < _elems.size(); i++) {
         e = _elems[i];
         if(dim == -1 || e->getDim() == dim) {
           if(MElementInEle(e, P)) {
-            CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+            MElement::overrideTolerance(initialTol);
             return e;
           }
         }
       }
     }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
+    MElement::overrideTolerance(initialTol);
     // Msg::Warning("Point %g %g %g not found",x,y,z);
   }
   return nullptr;
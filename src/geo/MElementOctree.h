@@ -8,20 +8,36 @@
 
 #include <vector>
 
-class Octree;
 class GModel;
 class MElement;
 
+// A spatial search structure for mesh elements: a bounding volume hierarchy
+// over the (slightly enlarged) bounding boxes of the elements, stored as a
+// packed array of nodes. The hierarchy is built (concurrently) when the object
+// is created and is never modified afterwards, so that find() and findAll()
+// can be called concurrently.
 class MElementOctree {
 private:
-  Octree *_octree;
+  struct node {
+    double min[3], max[3];
+    // leaf nodes (num > 0) contain the elements [first, first + num[ of
+    // _elems; the children of internal nodes (num == 0) are the next node and
+    // the node first
+    std::size_t first, num;
+  };
   GModel *_gm;
+  // the elements, sorted so that the elements of each leaf are contiguous, and
+  // their bounding boxes (min[3], max[3])
   std::vector<MElement *> _elems;
+  std::vector<double> _bbox;
+  std::vector<node> _nodes;
+  void _build();
+  template <class F> void _search(const double P[3], F f) const;
 
 public:
   MElementOctree(GModel *);
   MElementOctree(const std::vector<MElement *> &);
-  ~MElementOctree();
+  ~MElementOctree() {}
   MElement *find(double x, double y, double z, int dim = -1,
                  bool strict = false) const;
   std::vector<MElement *> findAll(double x, double y, double z, int dim,
@@ -257,7 +257,7 @@ std::vector<BDS_Face *> BDS_Point::getTriangles() const
 BDS_Point *BDS_Mesh::add_point(int const num, double const x, double const y,
                                double const z)
 {
-  BDS_Point *pp = new BDS_Point(num, x, y, z);
+  BDS_Point *pp = _pointPool.create(num, x, y, z);
   points.insert(pp);
   MAXPOINTNUMBER = std::max(MAXPOINTNUMBER, num);
   return pp;
@@ -266,7 +266,7 @@ BDS_Point *BDS_Mesh::add_point(int const num, double const x, double const y,
 BDS_Point *BDS_Mesh::add_point(int num, double u, double v, GFace *gf)
 {
   GPoint gp = gf->point(u, v);
-  BDS_Point *pp = new BDS_Point(num, gp.x(), gp.y(), gp.z());
+  BDS_Point *pp = _pointPool.create(num, gp.x(), gp.y(), gp.z());
   pp->u = u;
   pp->v = v;
   points.insert(pp);
@@ -488,7 +488,7 @@ BDS_Edge *BDS_Mesh::add_edge(int const p1, int const p2)
     Msg::Error("Could not find points %d or %d", p1, p2);
     return nullptr;
   }
-  edges.push_back(new BDS_Edge(pp1, pp2));
+  edges.push_back(_edgePool.create(pp1, pp2));
 
   return edges.back();
 }
@@ -505,7 +505,7 @@ BDS_Face *BDS_Mesh::add_triangle(int p1, int p2, int p3)
 BDS_Face *BDS_Mesh::add_triangle(BDS_Edge *e1, BDS_Edge *e2, BDS_Edge *e3)
 {
   if(e1 && e2 && e3) {
-    BDS_Face *t = new BDS_Face(e1, e2, e3);
+    BDS_Face *t = _facePool.create(e1, e2, e3);
     triangles.push_back(t);
     return t;
   }
@@ -533,7 +533,7 @@ void BDS_Mesh::del_edge(BDS_Edge *e)
 void BDS_Mesh::del_point(BDS_Point *p)
 {
   if(!p) return;
-  if(points.erase(p)) delete p;
+  if(points.erase(p)) _pointPool.destroy(p);
 }
 
 void BDS_Mesh::add_geom(int p1, int p2)
@@ -646,7 +646,7 @@ void BDS_Mesh::cleanup()
       std::partition(triangles.begin(), triangles.end(), is_not_deleted());
     auto it = last;
     while(it != triangles.end()) {
-      delete *it;
+      _facePool.destroy(*it);
       ++it;
     }
     triangles.erase(last, triangles.end());
@@ -655,7 +655,7 @@ void BDS_Mesh::cleanup()
     auto last = std::partition(edges.begin(), edges.end(), is_not_deleted());
     auto it = last;
     while(it != edges.end()) {
-      delete *it;
+      _edgePool.destroy(*it);
       ++it;
     }
     edges.erase(last, edges.end());
@@ -665,10 +665,20 @@ void BDS_Mesh::cleanup()
 BDS_Mesh::~BDS_Mesh()
 {
   DESTROOOY(geom.begin(), geom.end());
-  DESTROOOY(points.begin(), points.end());
-  cleanup();
-  DESTROOOY(edges.begin(), edges.end());
-  DESTROOOY(triangles.begin(), triangles.end());
+  // the points and edges own their adjacency vectors, and must thus be
+  // destroyed explicitly; the memory of the pools is then released at once
+  for(auto it = points.begin(); it != points.end(); ++it)
+    _pointPool.destroy(*it);
+  for(std::size_t i = 0; i < edges.size(); i++) _edgePool.destroy(edges[i]);
+  for(std::size_t i = 0; i < triangles.size(); i++)
+    _facePool.destroy(triangles[i]);
+  Msg::Debug("Peak BDS pool usage: %d points, %d edges, %d faces (%g Mb)",
+             (int)_pointPool.getPeakNumObjects(),
+             (int)_edgePool.getPeakNumObjects(),
+             (int)_facePool.getPeakNumObjects(),
+             (_pointPool.getMemoryUsage() + _edgePool.getMemoryUsage() +
+              _facePool.getMemoryUsage()) /
+               1024. / 1024.);
 }
 
 bool BDS_Mesh::split_edge(BDS_Edge *e, BDS_Point *mid, bool check_area_param)
@@ -744,27 +754,27 @@ bool BDS_Mesh::split_edge(BDS_Edge *e, BDS_Point *mid, bool check_area_param)
 
   del_edge(e);
 
-  BDS_Edge *p1_mid = new BDS_Edge(p1, mid);
+  BDS_Edge *p1_mid = _edgePool.create(p1, mid);
   edges.push_back(p1_mid);
-  BDS_Edge *mid_p2 = new BDS_Edge(mid, p2);
+  BDS_Edge *mid_p2 = _edgePool.create(mid, p2);
   edges.push_back(mid_p2);
-  BDS_Edge *op1_mid = new BDS_Edge(op[0], mid);
+  BDS_Edge *op1_mid = _edgePool.create(op[0], mid);
   edges.push_back(op1_mid);
-  BDS_Edge *mid_op2 = new BDS_Edge(mid, op[1]);
+  BDS_Edge *mid_op2 = _edgePool.create(mid, op[1]);
   edges.push_back(mid_op2);
 
   BDS_Face *t1, *t2, *t3, *t4;
   if(orientation == 1) {
-    t1 = new BDS_Face(op1_mid, p1_op1, p1_mid);
-    t2 = new BDS_Face(mid_op2, op2_p2, mid_p2);
-    t3 = new BDS_Face(op1_p2, op1_mid, mid_p2);
-    t4 = new BDS_Face(p1_op2, mid_op2, p1_mid);
+    t1 = _facePool.create(op1_mid, p1_op1, p1_mid);
+    t2 = _facePool.create(mid_op2, op2_p2, mid_p2);
+    t3 = _facePool.create(op1_p2, op1_mid, mid_p2);
+    t4 = _facePool.create(p1_op2, mid_op2, p1_mid);
   }
   else {
-    t1 = new BDS_Face(p1_op1, op1_mid, p1_mid);
-    t2 = new BDS_Face(op2_p2, mid_op2, mid_p2);
-    t3 = new BDS_Face(op1_mid, op1_p2, mid_p2);
-    t4 = new BDS_Face(mid_op2, p1_op2, p1_mid);
+    t1 = _facePool.create(p1_op1, op1_mid, p1_mid);
+    t2 = _facePool.create(op2_p2, mid_op2, mid_p2);
+    t3 = _facePool.create(op1_mid, op1_p2, mid_p2);
+    t4 = _facePool.create(mid_op2, p1_op2, p1_mid);
   }
   t1->g = g1;
   t2->g = g2;
@@ -1020,16 +1030,16 @@ bool BDS_Mesh::swap_edge(BDS_Edge *e, const BDS_SwapEdgeTest &theTest,
   }
   del_edge(e);
 
-  edges.push_back(new BDS_Edge(op[0], op[1]));
+  edges.push_back(_edgePool.create(op[0], op[1]));
 
   BDS_Face *t1, *t2;
   if(orientation == 1) {
-    t1 = new BDS_Face(p1_op1, p1_op2, edges.back());
-    t2 = new BDS_Face(edges.back(), op2_p2, op1_p2);
+    t1 = _facePool.create(p1_op1, p1_op2, edges.back());
+    t2 = _facePool.create(edges.back(), op2_p2, op1_p2);
   }
   else {
-    t1 = new BDS_Face(p1_op2, p1_op1, edges.back());
-    t2 = new BDS_Face(op2_p2, edges.back(), op1_p2);
+    t1 = _facePool.create(p1_op2, p1_op1, edges.back());
+    t2 = _facePool.create(op2_p2, edges.back(), op1_p2);
   }
 
   t1->g = g1;
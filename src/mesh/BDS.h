@@ -18,6 +18,7 @@
 #include <cmath>
 
 #include "GmshMessage.h"
+#include "objectPool.h"
 
 class BDS_Edge;
 class BDS_Face;
@@ -336,7 +337,14 @@ struct EdgeToRecover {
   }
 };
 
+// The points, edges and faces of the mesh are allocated in pools owned by the
+// mesh, whose memory is released in bulk when the mesh is deleted.
 class BDS_Mesh {
+private:
+  objectPool<BDS_Point> _pointPool;
+  objectPool<BDS_Edge> _edgePool;
+  objectPool<BDS_Face> _facePool;
+
 public:
   int MAXPOINTNUMBER;
   double Min[3], Max[3], LC;
@@ -15,11 +15,7 @@
 #include "BackgroundMeshTools.h"
 #include "MLine.h"
 #include "MTriangle.h"
-
-#if defined(HAVE_ANN)
-#include "ANN/ANN.h"
-class ANNkd_tree;
-#endif
+#include "SPoint3KDTree.h"
 
 class GEntity;
 class GModel;
@@ -55,15 +51,16 @@ class backgroundMesh : public simpleFunction<double> {
   static std::vector<backgroundMesh *> _current;
   backgroundMesh(GFace *, bool dist = false);
   ~backgroundMesh();
-#if defined(HAVE_ANN)
-  mutable ANNkd_tree *uv_kdtree;
-  mutable ANNpointArray nodes;
-  ANNidxArray index;
-  ANNdistArray dist;
-  mutable ANNpointArray angle_nodes;
-  mutable ANNkd_tree *angle_kdtree;
+  // kd-trees for the closest boundary nodes and the closest cross field
+  // nodes (nanoflann searches are reentrant)
+  SPoint3Cloud _uvNodes;
+  SPoint3CloudAdaptor<SPoint3Cloud> _uvAdaptor;
+  SPoint3KDTree *_uvKdtree;
+  SPoint3Cloud _angleNodes;
+  SPoint3CloudAdaptor<SPoint3Cloud> _angleAdaptor;
+  SPoint3KDTree *_angleKdtree;
   std::vector<double> _cos, _sin;
-#endif
+  bool _closestOnBoundary(double u, double v, SPoint3 &p) const;
 public:
   static void set(GFace *);
   static void setCrossFieldsByDistance(GFace *);
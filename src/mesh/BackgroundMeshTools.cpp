@@ -11,6 +11,7 @@
 #include "Context.h"
 #include "Field.h"
 #include "GModel.h"
+#include "MVertex.h"
 
 static double max_surf_curvature(const GEdge *ge, double u)
 {
@@ -336,6 +337,128 @@ SMetric3 BGM_MeshMetric(GEntity *ge, double U, double V, double X, double Y,
   return m;
 }
 
+// Cache of the mesh sizes and metrics evaluated at mesh vertices. Each thread
+// has its own cache (no locking is thus required during parallel meshing), in
+// which the values are stored per (vertex, entity) pair, since the size depends
+// on the entity on which it is evaluated. An entry is only reused if the
+// vertex has not moved and if it is evaluated with the same parameters. The
+// whole cache is cleared before each meshing step (see
+// FieldManager::initialize), so that changes to the fields or to the mesh size
+// options are taken into account. Only the evaluations at existing vertices
+// (boundary and embedded vertices, background mesh update, statistics) use the
+// cache: the 2D and 3D refinement and optimization loops already store the
+// size at each of their vertices (lcBGM, vSizesBGM).
+
+class meshSizeCache {
+private:
+  struct entry {
+    const GEntity *ge;
+    double u, v, x, y, z;
+    bool hasSize, hasMetric;
+    double lc;
+    SMetric3 metric;
+  };
+  std::unordered_map<const MVertex *, std::vector<entry> > _entries;
+  std::size_t _hits, _misses;
+
+public:
+  meshSizeCache() : _hits(0), _misses(0) {}
+  entry &get(const MVertex *mv, const GEntity *ge, double u, double v)
+  {
+    std::vector<entry> &entries = _entries[mv];
+    for(std::size_t i = 0; i < entries.size(); i++) {
+      entry &e = entries[i];
+      if(e.ge == ge) {
+        if(e.u != u || e.v != v || e.x != mv->x() || e.y != mv->y() ||
+           e.z != mv->z()) {
+          // the vertex has moved: invalidate the entry
+          e.u = u;
+          e.v = v;
+          e.x = mv->x();
+          e.y = mv->y();
+          e.z = mv->z();
+          e.hasSize = e.hasMetric = false;
+        }
+        return e;
+      }
+    }
+    entry e = {ge, u, v, mv->x(), mv->y(), mv->z(), false, false, 0.,
+               SMetric3()};
+    entries.push_back(e);
+    return entries.back();
+  }
+  void hit() { _hits++; }
+  void miss() { _misses++; }
+  std::size_t hits() const { return _hits; }
+  std::size_t misses() const { return _misses; }
+  void clear()
+  {
+    _entries.clear();
+    _hits = _misses = 0;
+  }
+};
+
+// the caches of all the threads; the cache of a thread is created the first
+// time it evaluates a size at a vertex, and is found through a thread-local
+// pointer (thread numbers are not unique across nested parallel regions)
+static std::vector<meshSizeCache *> _meshSizeCaches;
+
+static meshSizeCache *getMeshSizeCache()
+{
+  if(!CTX::instance()->mesh.lcCache) return nullptr;
+  static thread_local meshSizeCache *cache = nullptr;
+  if(!cache) {
+    cache = new meshSizeCache();
+#pragma omp critical(MeshSizeCache)
+    _meshSizeCaches.push_back(cache);
+  }
+  return cache;
+}
+
+double BGM_MeshSize(GEntity *ge, double U, double V, const MVertex *mv)
+{
+  meshSizeCache *cache = getMeshSizeCache();
+  if(!cache)
+    return BGM_MeshSize(ge, U, V, mv->x(), mv->y(), mv->z());
+  auto &e = cache->get(mv, ge, U, V);
+  if(e.hasSize) {
+    cache->hit();
+    return e.lc;
+  }
+  cache->miss();
+  e.lc = BGM_MeshSize(ge, U, V, mv->x(), mv->y(), mv->z());
+  e.hasSize = true;
+  return e.lc;
+}
+
+SMetric3 BGM_MeshMetric(GEntity *ge, double U, double V, const MVertex *mv)
+{
+  meshSizeCache *cache = getMeshSizeCache();
+  if(!cache)
+    return BGM_MeshMetric(ge, U, V, mv->x(), mv->y(), mv->z());
+  auto &e = cache->get(mv, ge, U, V);
+  if(e.hasMetric) {
+    cache->hit();
+    return e.metric;
+  }
+  cache->miss();
+  e.metric = BGM_MeshMetric(ge, U, V, mv->x(), mv->y(), mv->z());
+  e.hasMetric = true;
+  return e.metric;
+}
+
+void BGM_ClearMeshSizeCache()
+{
+  std::size_t hits = 0, misses = 0;
+  for(std::size_t i = 0; i < _meshSizeCaches.size(); i++) {
+    hits += _meshSizeCaches[i]->hits();
+    misses += _meshSizeCaches[i]->misses();
+    _meshSizeCaches[i]->clear();
+  }
+  if(hits || misses)
+    Msg::Debug("Mesh size cache: %lu hits, %lu misses", hits, misses);
+}
+
 bool Extend1dMeshIn2dSurfaces(GFace *gf)
 {
   int val = gf->getMeshSizeFromBoundary();
@@ -12,6 +12,7 @@ class GFace;
 class GVertex;
 class GEdge;
 class GEntity;
+class MVertex;
 
 SMetric3 buildMetricTangentToCurve(SVector3 &t, double l_t, double l_n);
 SMetric3 buildMetricTangentToSurface(SVector3 &t1, SVector3 &t2, double l_t1,
@@ -22,6 +23,11 @@ double BGM_MeshSizeWithoutScaling(GEntity *ge, double U, double V, double X,
                                   double Y, double Z);
 SMetric3 BGM_MeshMetric(GEntity *ge, double U, double V, double X, double Y,
                         double Z);
+// same as above, but evaluated at the mesh vertex mv; if Mesh.MeshSizeCache is
+// set, the values are memoized until the next call to BGM_ClearMeshSizeCache()
+double BGM_MeshSize(GEntity *ge, double U, double V, const MVertex *mv);
+SMetric3 BGM_MeshMetric(GEntity *ge, double U, double V, const MVertex *mv);
+void BGM_ClearMeshSizeCache();
 bool Extend1dMeshIn2dSurfaces(GFace *gf);
 bool Extend2dMeshIn3dVolumes();
 SMetric3 max_edge_curvature_metric(const GVertex *gv);
@@ -44,10 +44,6 @@
 #include <unistd.h>
 #endif
 
-#if defined(HAVE_ANN)
-#include "ANN/ANN.h"
-#endif
-
 Field::~Field()
 {
   for(auto it = options.begin(); it != options.end(); ++it) delete it->second;
@@ -55,6 +51,12 @@ Field::~Field()
     delete it->second;
 }
 
+void Field::evaluate(std::size_t n, const double *x, const double *y,
+                     const double *z, double *val, GEntity *ge)
+{
+  for(std::size_t i = 0; i < n; i++) val[i] = (*this)(x[i], y[i], z[i], ge);
+}
+
 FieldOption *Field::getOption(const std::string &optionName)
 {
   auto it = options.find(optionName);
@@ -182,66 +184,72 @@ public:
   {
     if(_data) delete[] _data;
   }
-  using Field::operator();
-  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  void update()
   {
-    if(updateNeeded) {
-      _errorStatus = false;
-      try {
-        std::ifstream input;
-        if(_textFormat)
-          input.open(_fileName.c_str());
-        else
-          input.open(_fileName.c_str(), std::ios::binary);
-        if(!input.is_open()) {
-          Msg::Error("Could not open file '%s'", _fileName.c_str());
-          return MAX_LC;
-        }
-        input.exceptions(std::ifstream::eofbit | std::ifstream::failbit |
-                         std::ifstream::badbit);
-        if(!_textFormat) {
-          input.read((char *)_o, 3 * sizeof(double));
-          input.read((char *)_d, 3 * sizeof(double));
-          input.read((char *)_n, 3 * sizeof(int));
-          int nt = _n[0] * _n[1] * _n[2];
-          if(nt <= 0) {
-            Msg::Error("Field %i: invalid number of data points %d x %d x %d",
-                       this->id, _n[0], _n[1], _n[2]);
-            return MAX_LC;
-          }
-          if(_data) delete[] _data;
-          _data = new double[nt];
-          input.read((char *)_data, nt * sizeof(double));
-        }
-        else {
-          input >> _o[0] >> _o[1] >> _o[2] >> _d[0] >> _d[1] >> _d[2] >>
-            _n[0] >> _n[1] >> _n[2];
-          int nt = _n[0] * _n[1] * _n[2];
-          if(nt <= 0) {
-            Msg::Error("Field %i: invalid number of data points %d x %d x %d",
-                       this->id, _n[0], _n[1], _n[2]);
-            return MAX_LC;
-          }
-          if(_data) delete[] _data;
-          _data = new double[nt];
-          for(int i = 0; i < nt; i++) input >> _data[i];
-        }
-        input.close();
-      } catch(...) {
+    if(!updateNeeded) return;
+    updateNeeded = false;
+    _errorStatus = false;
+    try {
+      std::ifstream input;
+      if(_textFormat)
+        input.open(_fileName.c_str());
+      else
+        input.open(_fileName.c_str(), std::ios::binary);
+      if(!input.is_open()) {
+        Msg::Error("Could not open file '%s'", _fileName.c_str());
         _errorStatus = true;
-        Msg::Error("Field %i: error reading file '%s'", this->id,
-                   _fileName.c_str());
+        return;
       }
-      for(int i = 0; i < 3; i++) {
-        // if there is a single point, make sure _d[i] != 0
-        if(_n[i] == 1 && !_d[i]) _d[i] = 1.;
+      input.exceptions(std::ifstream::eofbit | std::ifstream::failbit |
+                       std::ifstream::badbit);
+      if(!_textFormat) {
+        input.read((char *)_o, 3 * sizeof(double));
+        input.read((char *)_d, 3 * sizeof(double));
+        input.read((char *)_n, 3 * sizeof(int));
+        int nt = _n[0] * _n[1] * _n[2];
+        if(nt <= 0) {
+          Msg::Error("Field %i: invalid number of data points %d x %d x %d",
+                     this->id, _n[0], _n[1], _n[2]);
+          _errorStatus = true;
+          return;
+        }
+        if(_data) delete[] _data;
+        _data = new double[nt];
+        input.read((char *)_data, nt * sizeof(double));
       }
-      if(!_d[0] || !_d[1] || !_d[2]) {
-        Msg::Error("Field %i: Dx, Dy and Dz should be non zero", this->id);
-        return MAX_LC;
+      else {
+        input >> _o[0] >> _o[1] >> _o[2] >> _d[0] >> _d[1] >> _d[2] >> _n[0] >>
+          _n[1] >> _n[2];
+        int nt = _n[0] * _n[1] * _n[2];
+        if(nt <= 0) {
+          Msg::Error("Field %i: invalid number of data points %d x %d x %d",
+                     this->id, _n[0], _n[1], _n[2]);
+          _errorStatus = true;
+          return;
+        }
+        if(_data) delete[] _data;
+        _data = new double[nt];
+        for(int i = 0; i < nt; i++) input >> _data[i];
       }
-      updateNeeded = false;
+      input.close();
+    } catch(...) {
+      _errorStatus = true;
+      Msg::Error("Field %i: error reading file '%s'", this->id,
+                 _fileName.c_str());
+    }
+    for(int i = 0; i < 3; i++) {
+      // if there is a single point, make sure _d[i] != 0
+      if(_n[i] == 1 && !_d[i]) _d[i] = 1.;
+    }
+    if(!_d[0] || !_d[1] || !_d[2]) {
+      Msg::Error("Field %i: Dx, Dy and Dz should be non zero", this->id);
+      _errorStatus = true;
     }
+  }
+  using Field::operator();
+  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
     if(_errorStatus) return MAX_LC;
     // tri-linear
     int id[2][3];
@@ -410,6 +418,26 @@ public:
     }
     return _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    // the projection in computeDistance() amounts to clamping the point
+    // coordinates on the (axis-aligned) box, which we do here directly
+    const double xl = std::min(_xMin, _xMax), xh = std::max(_xMin, _xMax);
+    const double yl = std::min(_yMin, _yMax), yh = std::max(_yMin, _yMax);
+    const double zl = std::min(_zMin, _zMax), zh = std::max(_zMin, _zMax);
+    const double s = (_thick > 0) ? (_vOut - _vIn) / _thick : 0.;
+    for(std::size_t i = 0; i < n; i++) {
+      const double dx = x[i] - std::min(std::max(x[i], xl), xh);
+      const double dy = y[i] - std::min(std::max(y[i], yl), yh);
+      const double dz = z[i] - std::min(std::max(z[i], zl), zh);
+      const double dist = sqrt(dx * dx + dy * dy + dz * dz);
+      const bool in = (x[i] >= _xMin && x[i] <= _xMax && y[i] >= _yMin &&
+                       y[i] <= _yMax && z[i] >= _zMin && z[i] <= _zMax);
+      const bool layer = (_thick > 0 && dist <= _thick);
+      val[i] = in ? _vIn : (layer ? _vIn + dist * s : _vOut);
+    }
+  }
 };
 
 class CylinderField : public Field {
@@ -469,6 +497,23 @@ public:
     return ((dx * dx + dy * dy + dz * dz < _r * _r) && fabs(adx) < 1) ? _vIn :
                                                                         _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    const double a2 = _xa * _xa + _ya * _ya + _za * _za;
+    const double r2 = _r * _r;
+    for(std::size_t i = 0; i < n; i++) {
+      double dx = x[i] - _xc;
+      double dy = y[i] - _yc;
+      double dz = z[i] - _zc;
+      const double adx = (_xa * dx + _ya * dy + _za * dz) / a2;
+      dx -= adx * _xa;
+      dy -= adx * _ya;
+      dz -= adx * _za;
+      val[i] =
+        ((dx * dx + dy * dy + dz * dz < r2) && fabs(adx) < 1) ? _vIn : _vOut;
+    }
+  }
 };
 
 class BallField : public Field {
@@ -520,6 +565,19 @@ public:
     }
     return _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    const double s = (_thick > 0) ? (_vOut - _vIn) / _thick : 0.;
+    for(std::size_t i = 0; i < n; i++) {
+      const double dx = x[i] - _xc;
+      const double dy = y[i] - _yc;
+      const double dz = z[i] - _zc;
+      const double dist = sqrt(dx * dx + dy * dy + dz * dz) - _r;
+      const bool layer = (_thick > 0 && dist <= _thick);
+      val[i] = (dist < 0) ? _vIn : (layer ? _vIn + dist * s : _vOut);
+    }
+  }
 };
 
 class FrustumField : public Field {
@@ -623,6 +681,29 @@ public:
     }
     return lc;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    const double x12 = _x2 - _x1;
+    const double y12 = _y2 - _y1;
+    const double z12 = _z2 - _z1;
+    const double l12 = sqrt(x12 * x12 + y12 * y12 + z12 * z12);
+    for(std::size_t i = 0; i < n; i++) {
+      const double dx = x[i] - _x1;
+      const double dy = y[i] - _y1;
+      const double dz = z[i] - _z1;
+      const double l = (dx * x12 + dy * y12 + dz * z12) / l12;
+      const double r = sqrt(dx * dx + dy * dy + dz * dz - l * l);
+      const double u = l / l12;
+      const double ri = (1 - u) * _r1i + u * _r2i;
+      const double ro = (1 - u) * _r1o + u * _r2o;
+      const double v = (r - ri) / (ro - ri);
+      val[i] = (u >= 0 && u <= 1 && v >= 0 && v <= 1) ?
+                 (1 - v) * ((1 - u) * _v1i + u * _v2i) +
+                   v * ((1 - u) * _v1o + u * _v2o) :
+                 MAX_LC;
+    }
+  }
 };
 
 class ThresholdField : public Field {
@@ -700,6 +781,35 @@ public:
     }
     return lc;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    Field *field = nullptr;
+    if(_inField != id) {
+      field = GModel::current()->getFields()->get(_inField);
+      if(!field) Msg::Warning("Unknown Field %i", _inField);
+    }
+    if(!field) {
+      for(std::size_t i = 0; i < n; i++) val[i] = MAX_LC;
+      return;
+    }
+    // evaluate the input field on all the points, then threshold in place
+    field->evaluate(n, x, y, z, val);
+    for(std::size_t i = 0; i < n; i++) {
+      const double d = val[i];
+      double r = (d - _dMin) / (_dMax - _dMin);
+      r = std::max(std::min(r, 1.), 0.);
+      double lc;
+      if(_sigmoid) {
+        double s = exp(12. * r - 6.) / (1. + exp(12. * r - 6.));
+        lc = _lcMin * (1. - s) + _lcMax * s;
+      }
+      else { // linear
+        lc = _lcMin * (1 - r) + _lcMax * r;
+      }
+      val[i] = (_stopAtDistMax && d >= _dMax) ? MAX_LC : lc;
+    }
+  }
 };
 
 class GradientField : public Field {
@@ -972,17 +1082,48 @@ public:
   }
 };
 
+// identifier of the last parsed MathEval expression
+static std::size_t lastMathEvalExpression = 0;
+
 class MathEvalExpression {
 private:
-  mathEvaluator *_f;
+  std::string _function;
+  std::vector<std::string> _variables;
   std::set<int> _fields;
+  // mathex evaluators are not reentrant: each thread uses its own evaluator,
+  // created the first time the thread evaluates the expression, and found
+  // through a thread-local map indexed by the identifier of the expression
+  // (thread numbers are not unique across nested parallel regions)
+  std::size_t _id;
+  std::vector<mathEvaluator *> _f;
+  void _clear()
+  {
+    for(std::size_t i = 0; i < _f.size(); i++) delete _f[i];
+    _f.clear();
+    _id = 0;
+  }
+  static std::map<std::size_t, mathEvaluator *> &_threadEvaluators()
+  {
+    static thread_local std::map<std::size_t, mathEvaluator *> evaluators;
+    return evaluators;
+  }
+  mathEvaluator *_evaluator()
+  {
+    if(!_id) return nullptr;
+    std::map<std::size_t, mathEvaluator *> &evaluators = _threadEvaluators();
+    auto it = evaluators.find(_id);
+    if(it != evaluators.end()) return it->second;
+    std::vector<std::string> expressions(1, _function);
+    mathEvaluator *f = new mathEvaluator(expressions, _variables);
+#pragma omp critical(MathEvalExpression)
+    _f.push_back(f);
+    evaluators[_id] = f;
+    return f;
+  }
 
 public:
-  MathEvalExpression() : _f(nullptr) {}
-  ~MathEvalExpression()
-  {
-    if(_f) delete _f;
-  }
+  MathEvalExpression() : _id(0) {}
+  ~MathEvalExpression() { _clear(); }
   bool set_function(const std::string &f)
   {
     // get id numbers of fields appearing in the function
@@ -1003,29 +1144,35 @@ public:
       }
       i += j + 1;
     }
-    std::vector<std::string> expressions(1), variables(3 + _fields.size());
+    std::vector<std::string> expressions(1);
     expressions[0] = f;
-    variables[0] = "x";
-    variables[1] = "y";
-    variables[2] = "z";
+    _variables.resize(3 + _fields.size());
+    _variables[0] = "x";
+    _variables[1] = "y";
+    _variables[2] = "z";
     i = 3;
     for(auto it = _fields.begin(); it != _fields.end(); it++) {
       std::ostringstream sstream;
       sstream << "F" << *it;
-      variables[i++] = sstream.str();
+      _variables[i++] = sstream.str();
     }
-    if(_f) delete _f;
-    _f = new mathEvaluator(expressions, variables);
+    _clear();
+    // parse the expression once here to report errors
+    mathEvaluator *e = new mathEvaluator(expressions, _variables);
     if(expressions.empty()) {
-      delete _f;
-      _f = nullptr;
+      delete e;
       return false;
     }
+    _function = f;
+    _id = ++lastMathEvalExpression;
+    _f.push_back(e);
+    _threadEvaluators()[_id] = e;
     return true;
   }
   double evaluate(double x, double y, double z)
   {
-    if(!_f) return MAX_LC;
+    mathEvaluator *f = _evaluator();
+    if(!f) return MAX_LC;
     std::vector<double> values(3 + _fields.size()), res(1);
     values[0] = x;
     values[1] = y;
@@ -1041,97 +1188,40 @@ public:
         values[i++] = MAX_LC;
       }
     }
-    if(_f->eval(values, res))
+    if(f->eval(values, res))
       return res[0];
     else
       return MAX_LC;
   }
-};
-
-class MathEvalExpressionAniso {
-private:
-  mathEvaluator *_f[6];
-  std::set<int> _fields[6];
-
-public:
-  MathEvalExpressionAniso()
-  {
-    for(int i = 0; i < 6; i++) _f[i] = nullptr;
-  }
-  ~MathEvalExpressionAniso()
-  {
-    for(int i = 0; i < 6; i++)
-      if(_f[i]) delete _f[i];
-  }
-  bool set_function(int iFunction, const std::string &f)
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val)
   {
-    // get id numbers of fields appearing in the function
-    _fields[iFunction].clear();
-    std::size_t i = 0;
-    while(i < f.size()) {
-      std::size_t j = 0;
-      if(f[i] == 'F') {
-        std::string id("");
-        while(i + 1 + j < f.size() && f[i + 1 + j] >= '0' &&
-              f[i + 1 + j] <= '9') {
-          id += f[i + 1 + j];
-          j++;
-        }
-        _fields[iFunction].insert(atoi(id.c_str()));
-      }
-      i += j + 1;
-    }
-    std::vector<std::string> expressions(1),
-      variables(3 + _fields[iFunction].size());
-    expressions[0] = f;
-    variables[0] = "x";
-    variables[1] = "y";
-    variables[2] = "z";
-    i = 3;
-    for(auto it = _fields[iFunction].begin(); it != _fields[iFunction].end();
-        it++) {
-      std::ostringstream sstream;
-      sstream << "F" << *it;
-      variables[i++] = sstream.str();
-    }
-    if(_f[iFunction]) delete _f[iFunction];
-    _f[iFunction] = new mathEvaluator(expressions, variables);
-    if(expressions.empty()) {
-      delete _f[iFunction];
-      _f[iFunction] = nullptr;
-      return false;
+    if(!n) return;
+    mathEvaluator *f = _evaluator();
+    if(!f) {
+      for(std::size_t i = 0; i < n; i++) val[i] = MAX_LC;
+      return;
     }
-    return true;
-  }
-  void evaluate(double x, double y, double z, SMetric3 &metr)
-  {
-    const int index[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
-    for(int iFunction = 0; iFunction < 6; iFunction++) {
-      if(!_f[iFunction])
-        metr(index[iFunction][0], index[iFunction][1]) = MAX_LC;
+    // evaluate the fields appearing in the expression on all the points first
+    std::vector<std::vector<double> > fv(_fields.size());
+    int j = 0;
+    for(auto it = _fields.begin(); it != _fields.end(); it++, j++) {
+      fv[j].resize(n);
+      Field *field = GModel::current()->getFields()->get(*it);
+      if(field) { field->evaluate(n, x, y, z, &fv[j][0]); }
       else {
-        std::vector<double> values(3 + _fields[iFunction].size()), res(1);
-        values[0] = x;
-        values[1] = y;
-        values[2] = z;
-        int i = 3;
-        for(auto it = _fields[iFunction].begin();
-            it != _fields[iFunction].end(); it++) {
-          Field *field = GModel::current()->getFields()->get(*it);
-          if(field) {
-            values[i++] = (*field)(x, y, z);
-          }
-          else {
-            Msg::Warning("Unknown Field %i", *it);
-            values[i++] = MAX_LC;
-          }
-        }
-        if(_f[iFunction]->eval(values, res))
-          metr(index[iFunction][0], index[iFunction][1]) = res[0];
-        else
-          metr(index[iFunction][0], index[iFunction][1]) = MAX_LC;
+        Msg::Warning("Unknown Field %i in MathEval", *it);
+        std::fill(fv[j].begin(), fv[j].end(), MAX_LC);
       }
     }
+    std::vector<double> values(3 + _fields.size()), res(1);
+    for(std::size_t i = 0; i < n; i++) {
+      values[0] = x[i];
+      values[1] = y[i];
+      values[2] = z[i];
+      for(std::size_t k = 0; k < fv.size(); k++) values[3 + k] = fv[k][i];
+      val[i] = f->eval(values, res) ? res[0] : MAX_LC;
+    }
   }
 };
 
@@ -1147,21 +1237,26 @@ public:
     options["F"] = new FieldOptionString(
       _f, "Mathematical function to evaluate.", &updateNeeded);
   }
+  void update()
+  {
+    if(updateNeeded) {
+      if(!_expr.set_function(_f))
+        Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
+                   _f.c_str());
+      updateNeeded = false;
+    }
+  }
   using Field::operator();
   double operator()(double x, double y, double z, GEntity *ge = nullptr)
   {
-    double ret = 0;
-#pragma omp critical
-    {
-      if(updateNeeded) {
-        if(!_expr.set_function(_f))
-          Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
-                     _f.c_str());
-        updateNeeded = false;
-      }
-      ret = _expr.evaluate(x, y, z);
-    }
-    return ret;
+    if(updateNeeded) update();
+    return _expr.evaluate(x, y, z);
+  }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
+    _expr.evaluate(n, x, y, z, val);
   }
   const char *getName() { return "MathEval"; }
   std::string getDescription()
@@ -1174,7 +1269,7 @@ public:
 
 class MathEvalFieldAniso : public Field {
 private:
-  MathEvalExpressionAniso _expr;
+  MathEvalExpression _expr[6];
   std::string _f[6];
 
 public:
@@ -1215,37 +1310,29 @@ public:
     options["m23"] =
       new FieldOptionString(_f[5], "[Deprecated]", &updateNeeded, true);
   }
-  void operator()(double x, double y, double z, SMetric3 &metr,
-                  GEntity *ge = nullptr)
+  void update()
   {
-#pragma omp critical
-    {
-      if(updateNeeded) {
-        for(int i = 0; i < 6; i++) {
-          if(!_expr.set_function(i, _f[i]))
-            Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
-                       _f[i].c_str());
-        }
-        updateNeeded = false;
+    if(updateNeeded) {
+      for(int i = 0; i < 6; i++) {
+        if(!_expr[i].set_function(_f[i]))
+          Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
+                     _f[i].c_str());
       }
-      _expr.evaluate(x, y, z, metr);
+      updateNeeded = false;
     }
   }
+  void operator()(double x, double y, double z, SMetric3 &metr,
+                  GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
+    const int index[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+    for(int i = 0; i < 6; i++)
+      metr(index[i][0], index[i][1]) = _expr[i].evaluate(x, y, z);
+  }
   double operator()(double x, double y, double z, GEntity *ge = nullptr)
   {
     SMetric3 metr;
-#pragma omp critical
-    {
-      if(updateNeeded) {
-        for(int i = 0; i < 6; i++) {
-          if(!_expr.set_function(i, _f[i]))
-            Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
-                       _f[i].c_str());
-        }
-        updateNeeded = false;
-      }
-      _expr.evaluate(x, y, z, metr);
-    }
+    (*this)(x, y, z, metr, ge);
     return metr(0, 0);
   }
   const char *getName() { return "MathEvalAniso"; }
@@ -1524,8 +1611,7 @@ public:
            "See the MathEval Field help to get a description of valid FX, FY "
            "and FZ expressions.";
   }
-  using Field::operator();
-  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  void update()
   {
     if(updateNeeded) {
       for(int i = 0; i < 3; i++) {
@@ -1535,6 +1621,11 @@ public:
       }
       updateNeeded = false;
     }
+  }
+  using Field::operator();
+  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
     if(_inField == id) return MAX_LC;
     Field *field = GModel::current()->getFields()->get(_inField);
     if(!field) {
@@ -1851,21 +1942,22 @@ public:
   {
     return "Take the minimum value of a list of fields.";
   }
-  using Field::operator();
-  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  void update()
   {
-#pragma omp critical
-    {
-      if(updateNeeded) {
-        _fields.clear();
-        for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
-          Field *f = (GModel::current()->getFields()->get(*it));
-          if(!f) Msg::Warning("Unknown Field %i", *it);
-          if(f && *it != id) _fields.push_back(f);
-        }
-        updateNeeded = false;
+    if(updateNeeded) {
+      _fields.clear();
+      for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
+        Field *f = (GModel::current()->getFields()->get(*it));
+        if(!f) Msg::Warning("Unknown Field %i", *it);
+        if(f && *it != id) _fields.push_back(f);
       }
+      updateNeeded = false;
     }
+  }
+  using Field::operator();
+  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
 
     double v = MAX_LC;
     for(auto f : _fields) {
@@ -1882,6 +1974,31 @@ public:
     }
     return v;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
+
+    if(!n) return;
+    std::fill(val, val + n, MAX_LC);
+    std::vector<double> tmp(n);
+    for(auto f : _fields) {
+      if(f->isotropic()) {
+        f->evaluate(n, x, y, z, &tmp[0], ge);
+        for(std::size_t i = 0; i < n; i++) val[i] = std::min(val[i], tmp[i]);
+      }
+      else {
+        SMetric3 ff;
+        fullMatrix<double> V(3, 3);
+        fullVector<double> S(3);
+        for(std::size_t i = 0; i < n; i++) {
+          (*f)(x[i], y[i], z[i], ff, ge);
+          ff.eig(V, S, 1);
+          val[i] = std::min(val[i], sqrt(1. / S(2)));
+        }
+      }
+    }
+  }
   const char *getName() { return "Min"; }
 };
 
@@ -1900,21 +2017,22 @@ public:
   {
     return "Take the maximum value of a list of fields.";
   }
-  using Field::operator();
-  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  void update()
   {
-#pragma omp critical
-    {
-      if(updateNeeded) {
-        _fields.clear();
-        for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
-          Field *f = (GModel::current()->getFields()->get(*it));
-          if(!f) Msg::Warning("Unknown Field %i", *it);
-          if(f && *it != id) _fields.push_back(f);
-        }
-        updateNeeded = false;
+    if(updateNeeded) {
+      _fields.clear();
+      for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
+        Field *f = (GModel::current()->getFields()->get(*it));
+        if(!f) Msg::Warning("Unknown Field %i", *it);
+        if(f && *it != id) _fields.push_back(f);
       }
+      updateNeeded = false;
     }
+  }
+  using Field::operator();
+  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
 
     double v = -MAX_LC;
     for(auto f : _fields) {
@@ -1931,6 +2049,31 @@ public:
     }
     return v;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) update();
+
+    if(!n) return;
+    std::fill(val, val + n, -MAX_LC);
+    std::vector<double> tmp(n);
+    for(auto f : _fields) {
+      if(f->isotropic()) {
+        f->evaluate(n, x, y, z, &tmp[0], ge);
+        for(std::size_t i = 0; i < n; i++) val[i] = std::max(val[i], tmp[i]);
+      }
+      else {
+        SMetric3 ff;
+        fullMatrix<double> V(3, 3);
+        fullVector<double> S(3);
+        for(std::size_t i = 0; i < n; i++) {
+          (*f)(x[i], y[i], z[i], ff, ge);
+          ff.eig(V, S, 1);
+          val[i] = std::max(val[i], sqrt(1. / S(0)));
+        }
+      }
+    }
+  }
   const char *getName() { return "Max"; }
 };
 
@@ -2095,24 +2238,19 @@ struct AttractorInfo {
   double u, v;
 };
 
-#if defined(HAVE_ANN)
-
 class AttractorAnisoCurveField : public Field {
 private:
-  ANNkd_tree *_kdTree;
-  ANNpointArray _zeroNodes;
-  ANNidxArray _index;
-  ANNdistArray _dist;
+  SPoint3Cloud _pc;
+  SPoint3CloudAdaptor<SPoint3Cloud> _pc2kdtree;
+  SPoint3KDTree *_kdtree;
   std::list<int> _curveTags;
   double _dMin, _dMax, _lMinTangent, _lMaxTangent, _lMinNormal, _lMaxNormal;
   int _sampling;
   std::vector<SVector3> _tg;
 
 public:
-  AttractorAnisoCurveField() : _kdTree(nullptr), _zeroNodes(nullptr)
+  AttractorAnisoCurveField() : _pc2kdtree(_pc), _kdtree(nullptr)
   {
-    _index = new ANNidx[1];
-    _dist = new ANNdist[1];
     _sampling = 20;
     updateNeeded = true;
     _dMin = 0.1;
@@ -2172,10 +2310,7 @@ public:
   virtual bool isotropic() const { return false; }
   ~AttractorAnisoCurveField()
   {
-    if(_kdTree) delete _kdTree;
-    if(_zeroNodes) annDeallocPts(_zeroNodes);
-    delete[] _index;
-    delete[] _dist;
+    if(_kdtree) delete _kdtree;
   }
   const char *getName() { return "AttractorAnisoCurve"; }
   std::string getDescription()
@@ -2187,14 +2322,11 @@ public:
   }
   void update()
   {
-    if(_zeroNodes) {
-      annDeallocPts(_zeroNodes);
-      delete _kdTree;
-    }
-    int totpoints = _sampling * _curveTags.size();
-    if(totpoints) { _zeroNodes = annAllocPts(totpoints, 3); }
-    _tg.resize(totpoints);
-    int k = 0;
+    if(!updateNeeded) return;
+    _pc.pts.clear();
+    _tg.clear();
+    if(_kdtree) delete _kdtree;
+    _kdtree = nullptr;
     for(auto it = _curveTags.begin(); it != _curveTags.end(); ++it) {
       GEdge *e = GModel::current()->getEdgeByTag(*it);
       if(e) {
@@ -2204,29 +2336,45 @@ public:
           double t = b.low() + u * (b.high() - b.low());
           GPoint gp = e->point(t);
           SVector3 d = e->firstDer(t);
-          _zeroNodes[k][0] = gp.x();
-          _zeroNodes[k][1] = gp.y();
-          _zeroNodes[k][2] = gp.z();
-          _tg[k] = d;
-          _tg[k].normalize();
-          k++;
+          d.normalize();
+          _pc.pts.push_back(SPoint3(gp.x(), gp.y(), gp.z()));
+          _tg.push_back(d);
         }
       }
       else {
         Msg::Warning("Unknown curve %d", *it);
       }
     }
-    _kdTree = new ANNkd_tree(_zeroNodes, totpoints, 3);
+    if(_pc.pts.size()) {
+      _kdtree = new SPoint3KDTree(
+        3, _pc2kdtree, nanoflann::KDTreeSingleIndexAdaptorParams(10));
+      _kdtree->buildIndex();
+    }
     updateNeeded = false;
   }
+  // squared distance to the closest sampling point, whose index is returned
+  // in index; the kd-tree is only read, so this is safe to call concurrently
+  bool closest(double x, double y, double z, std::size_t &index,
+               double &dist2) const
+  {
+    if(!_kdtree) return false;
+    double pt[3] = {x, y, z};
+    nanoflann::KNNResultSet<double> res(1);
+    res.init(&index, &dist2);
+    _kdtree->findNeighbors(res, &pt[0], nanoflann::SearchParams(10));
+    return true;
+  }
   void operator()(double x, double y, double z, SMetric3 &metr,
                   GEntity *ge = nullptr)
   {
     if(updateNeeded) update();
-    double xyz[3] = {x, y, z};
-#pragma omp critical // avoid crash (still incorrect) - use Distance instead
-    _kdTree->annkSearch(xyz, 1, _index, _dist);
-    double d = sqrt(_dist[0]);
+    std::size_t index = 0;
+    double dist2 = 0.;
+    if(!closest(x, y, z, index, dist2)) {
+      metr = SMetric3(1. / (MAX_LC * MAX_LC));
+      return;
+    }
+    double d = sqrt(dist2);
     double lTg = d < _dMin ? _lMinTangent :
                  d > _dMax ? _lMaxTangent :
                              _lMinTangent + (_lMaxTangent - _lMinTangent) *
@@ -2235,7 +2383,7 @@ public:
                 d > _dMax ? _lMaxNormal :
                             _lMinNormal + (_lMaxNormal - _lMinNormal) *
                                             (d - _dMin) / (_dMax - _dMin);
-    SVector3 t = _tg[_index[0]];
+    SVector3 t = _tg[index];
     SVector3 n0 = crossprod(t, fabs(t(0)) > fabs(t(1)) ? SVector3(0, 1, 0) :
                                                          SVector3(1, 0, 0));
     SVector3 n1 = crossprod(t, n0);
@@ -2244,16 +2392,14 @@ public:
   virtual double operator()(double X, double Y, double Z, GEntity *ge = nullptr)
   {
     if(updateNeeded) update();
-    double xyz[3] = {X, Y, Z};
-#pragma omp critical // avoid crash (still incorrect) - use Distance instead
-    _kdTree->annkSearch(xyz, 1, _index, _dist);
-    double d = sqrt(_dist[0]);
+    std::size_t index = 0;
+    double dist2 = 0.;
+    if(!closest(X, Y, Z, index, dist2)) return MAX_LC;
+    double d = sqrt(dist2);
     return std::max(d, 0.05);
   }
 };
 
-#endif // ANN
-
 class OctreeField : public Field {
 private:
   // octree field
@@ -2453,10 +2599,9 @@ class DistanceField : public Field {
   SPoint3Cloud _pc;
   SPoint3CloudAdaptor<SPoint3Cloud> _pc2kdtree;
   SPoint3KDTree *_kdtree;
-  std::size_t _outIndex;
 
 public:
-  DistanceField() : _pc2kdtree(_pc), _kdtree(nullptr), _outIndex(0)
+  DistanceField() : _pc2kdtree(_pc), _kdtree(nullptr)
   {
     _sampling = 20;
 
@@ -2491,7 +2636,7 @@ public:
       new FieldOptionInt(_sampling, "[Deprecated]", &updateNeeded, true);
   }
   DistanceField(int dim, int tag, int nbe)
-    : _sampling(nbe), _pc2kdtree(_pc), _kdtree(nullptr), _outIndex(0)
+    : _sampling(nbe), _pc2kdtree(_pc), _kdtree(nullptr)
   {
     if(dim == 0)
       _pointTags.push_back(tag);
@@ -2514,10 +2659,10 @@ public:
            "of points (sampled according to Sampling), to which the distance "
            "is actually computed.";
   }
-  std::pair<AttractorInfo, SPoint3> getAttractorInfo() const
+  std::pair<AttractorInfo, SPoint3> getAttractorInfo(std::size_t index) const
   {
-    if(_outIndex < _infos.size() && _outIndex < _pc.pts.size())
-      return std::make_pair(_infos[_outIndex], _pc.pts[_outIndex]);
+    if(index < _infos.size() && index < _pc.pts.size())
+      return std::make_pair(_infos[index], _pc.pts[index]);
     return std::make_pair(AttractorInfo(), SPoint3());
   }
   void update()
@@ -2588,17 +2733,25 @@ public:
       updateNeeded = false;
     }
   }
-  using Field::operator();
-  virtual double operator()(double X, double Y, double Z, GEntity *ge = nullptr)
+  // distance to the closest sampling point, whose index is returned in index
+  // (to be used with getAttractorInfo)
+  double distance(double X, double Y, double Z, std::size_t &index) const
   {
+    index = 0;
     if(!_kdtree) return MAX_LC;
     double pt[3] = {X, Y, Z};
     nanoflann::KNNResultSet<double> res(1);
     double outDistSqr;
-    res.init(&_outIndex, &outDistSqr);
+    res.init(&index, &outDistSqr);
     _kdtree->findNeighbors(res, &pt[0], nanoflann::SearchParams(10));
     return sqrt(outDistSqr);
   }
+  using Field::operator();
+  virtual double operator()(double X, double Y, double Z, GEntity *ge = nullptr)
+  {
+    std::size_t index;
+    return distance(X, Y, Z, index);
+  }
 };
 
 class ExtendField : public Field {
@@ -3030,9 +3183,9 @@ void BoundaryLayerField::computeFor1dMesh(double x, double y, double z,
   metr = buildMetricTangentToCurve(t1, lc_n, lc_n);
 }
 
-void BoundaryLayerField::operator()(DistanceField *cc, double dist, double x,
-                                    double y, double z, SMetric3 &metr,
-                                    GEntity *ge)
+void BoundaryLayerField::operator()(DistanceField *cc, std::size_t index,
+                                    double dist, double x, double y, double z,
+                                    SMetric3 &metr, GEntity *ge)
 {
   // dist = hwall -> lc = hwall * ratio
   // dist = hwall (1+ratio) -> lc = hwall ratio ^ 2
@@ -3053,7 +3206,7 @@ void BoundaryLayerField::operator()(DistanceField *cc, double dist, double x,
   lc_t = std::max(lc_t, CTX::instance()->mesh.lcMin);
   lc_t = std::min(lc_t, CTX::instance()->mesh.lcMax);
 
-  std::pair<AttractorInfo, SPoint3> pp = cc->getAttractorInfo();
+  std::pair<AttractorInfo, SPoint3> pp = cc->getAttractorInfo(index);
   double beta = CTX::instance()->mesh.smoothRatio;
   if(pp.first.dim == 0) {
     GVertex *v = GModel::current()->getVertexByTag(pp.first.ent);
@@ -3146,15 +3299,16 @@ void BoundaryLayerField::operator()(double x, double y, double z,
   SMetric3 v(1. / (CTX::instance()->mesh.lcMax * CTX::instance()->mesh.lcMax));
   hop.push_back(v);
   for(auto it = _attFields.begin(); it != _attFields.end(); ++it) {
-    double cdist = (*(*it))(x, y, z);
-    SPoint3 CLOSEST = (*it)->getAttractorInfo().second;
+    std::size_t index;
+    double cdist = (*it)->distance(x, y, z, index);
+    SPoint3 CLOSEST = (*it)->getAttractorInfo(index).second;
     SMetric3 localMetric;
     if(iIntersect) {
-      (*this)(*it, cdist, x, y, z, localMetric, ge);
+      (*this)(*it, index, cdist, x, y, z, localMetric, ge);
       hop.push_back(localMetric);
     }
     if(cdist < currentDistance) {
-      if(!iIntersect) (*this)(*it, cdist, x, y, z, localMetric, ge);
+      if(!iIntersect) (*this)(*it, index, cdist, x, y, z, localMetric, ge);
       currentDistance = cdist;
       currentClosest = *it;
       v = localMetric;
@@ -3198,10 +3352,8 @@ FieldManager::FieldManager()
   mapTypeName["ExternalProcess"] = new FieldFactoryT<ExternalProcessField>();
   mapTypeName["MathEval"] = new FieldFactoryT<MathEvalField>();
   mapTypeName["MathEvalAniso"] = new FieldFactoryT<MathEvalFieldAniso>();
-#if defined(HAVE_ANN)
   mapTypeName["AttractorAnisoCurve"] =
     new FieldFactoryT<AttractorAnisoCurveField>();
-#endif
   mapTypeName["MaxEigenHessian"] = new FieldFactoryT<MaxEigenHessianField>();
   mapTypeName["AutomaticMeshSizeField"] =
     new FieldFactoryT<automaticMeshSizeField>();
@@ -3212,6 +3364,9 @@ void FieldManager::initialize()
 {
   auto it = begin();
   for(; it != end(); ++it) it->second->update();
+  // the fields (or the mesh size options) might have changed: the sizes cached
+  // at the mesh nodes are not valid anymore
+  BGM_ClearMeshSizeCache();
 }
 
 FieldManager::~FieldManager()
@@ -3238,11 +3393,23 @@ void Field::putOnNewView(int viewTag)
   std::map<int, std::vector<double> > d;
   std::vector<GEntity *> entities;
   GModel::current()->getEntities(entities);
+  std::vector<double> x, y, z, val;
   for(std::size_t i = 0; i < entities.size(); i++) {
-    for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++) {
+    std::size_t n = entities[i]->mesh_vertices.size();
+    if(!n) continue;
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    val.resize(n);
+    for(std::size_t j = 0; j < n; j++) {
       MVertex *v = entities[i]->mesh_vertices[j];
-      d[v->getNum()].push_back((*this)(v->x(), v->y(), v->z(), entities[i]));
+      x[j] = v->x();
+      y[j] = v->y();
+      z[j] = v->z();
     }
+    evaluate(n, &x[0], &y[0], &z[0], &val[0], entities[i]);
+    for(std::size_t j = 0; j < n; j++)
+      d[entities[i]->mesh_vertices[j]->getNum()].push_back(val[j]);
   }
   std::ostringstream oss;
   oss << "Field " << id;
@@ -3256,15 +3423,29 @@ void Field::putOnNewView(int viewTag)
 void Field::putOnView(PView *view, int comp)
 {
   PViewData *data = view->getData();
+  // gather the coordinates of all the nodes, and evaluate the field in one go
+  std::vector<double> x, y, z;
   for(int ent = 0; ent < data->getNumEntities(0); ent++) {
     for(int ele = 0; ele < data->getNumElements(0, ent); ele++) {
       if(data->skipElement(0, ent, ele)) continue;
       for(int nod = 0; nod < data->getNumNodes(0, ent, ele); nod++) {
-        double x, y, z;
-        data->getNode(0, ent, ele, nod, x, y, z);
-        double val = (*this)(x, y, z);
+        double xx, yy, zz;
+        data->getNode(0, ent, ele, nod, xx, yy, zz);
+        x.push_back(xx);
+        y.push_back(yy);
+        z.push_back(zz);
+      }
+    }
+  }
+  std::vector<double> val(x.size());
+  if(x.size()) evaluate(x.size(), &x[0], &y[0], &z[0], &val[0]);
+  std::size_t i = 0;
+  for(int ent = 0; ent < data->getNumEntities(0); ent++) {
+    for(int ele = 0; ele < data->getNumElements(0, ent); ele++) {
+      if(data->skipElement(0, ent, ele)) continue;
+      for(int nod = 0; nod < data->getNumNodes(0, ent, ele); nod++, i++) {
         for(int comp = 0; comp < data->getNumComponents(0, ent, ele); comp++)
-          data->setValue(0, ent, ele, nod, comp, val);
+          data->setValue(0, ent, ele, nod, comp, val[i]);
       }
     }
   }
@@ -126,6 +126,10 @@ public:
                           GEntity *ge = nullptr)
   {
   }
+  // isotropic, on n points with coordinates stored in separate arrays (the
+  // default implementation simply calls the pointwise operator on each point)
+  virtual void evaluate(std::size_t n, const double *x, const double *y,
+                        const double *z, double *val, GEntity *ge = nullptr);
   bool updateNeeded;
   virtual const char *getName() = 0;
 #if defined(HAVE_POST)
@@ -197,8 +201,8 @@ private:
   std::list<int> _excludedSurfaceTags;
   std::list<int> _fanSizes;
   SPoint3 _closestPoint;
-  void operator()(DistanceField *cc, double dist, double x, double y, double z,
-                  SMetric3 &metr, GEntity *ge);
+  void operator()(DistanceField *cc, std::size_t index, double dist, double x,
+                  double y, double z, SMetric3 &metr, GEntity *ge);
 
 public:
   double hWallN, ratio, hFar, thickness;
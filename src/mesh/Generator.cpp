@@ -4,6 +4,7 @@
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <stdlib.h>
+#include <string.h>
 #include <stack>
 #include <stdexcept>
 
@@ -29,7 +30,10 @@
 #include "meshGRegionLocalMeshMod.h"
 #include "meshRelocateVertex.h"
 #include "meshRefine.h"
+#include "meshSignature.h"
+#include "meshCache.h"
 #include "BackgroundMesh.h"
+#include "BackgroundMeshTools.h"
 #include "BoundaryLayers.h"
 #include "ExtrudeParams.h"
 #include "HighOrder.h"
@@ -338,13 +342,24 @@ static void Mesh0D(GModel *m)
   }
 }
 
-static void Mesh1D(GModel *m)
+// if onlyPending is set, only retry the curves whose mesh is still pending
+// (e.g. after Mesh1DAnd2D), without resetting the status of the others; if a
+// cache is given, the meshes found in the cache are reused
+static void Mesh1D(GModel *m, bool onlyPending = false,
+                   meshCache *cache = nullptr)
 {
   if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return;
 
+  if(onlyPending) {
+    bool pending = false;
+    for(auto it = m->firstEdge(); it != m->lastEdge(); ++it)
+      if((*it)->meshStatistics.status == GEdge::PENDING) pending = true;
+    if(!pending) return;
+  }
+
   m->getFields()->initialize();
 
-  if(TooManyElements(m, 1)) return;
+  if(!onlyPending && TooManyElements(m, 1)) return;
   Msg::StatusBar(true, "Meshing 1D...");
   double t1 = Cpu(), w1 = TimeOfDay();
 
@@ -366,13 +381,15 @@ static void Mesh1D(GModel *m)
 
   std::vector<GEdge *> temp;
   for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
-    (*it)->meshStatistics.status = GEdge::PENDING;
+    if(!onlyPending) (*it)->meshStatistics.status = GEdge::PENDING;
     temp.push_back(*it);
   }
 
   int nIter = 0, nTot = m->getNumEdges();
   Msg::StartProgressMeter(nTot);
 
+  // number the new nodes and elements independently of the scheduling
+  m->beginConcurrentNumbering();
   while(1) {
     if(CTX::instance()->abortOnError && Msg::GetErrorCount()) {
       Msg::Warning("Aborted 1D meshing");
@@ -388,7 +405,10 @@ static void Mesh1D(GModel *m)
       GEdge *ed = temp[K];
       if(ed->meshStatistics.status == GEdge::PENDING) {
         try{ // OpenMP forbids leaving block via exception
-          ed->mesh(true);
+          if(!cache || !cache->load(ed)) {
+            ed->mesh(true);
+            if(cache) cache->save(ed);
+          }
         }
         catch(...){
           exceptions = true;
@@ -401,10 +421,14 @@ static void Mesh1D(GModel *m)
       }
       if(!nIter) Msg::ProgressMeter(localPending, false, "Meshing 1D...");
     }
-    if(exceptions) throw std::runtime_error(Msg::GetLastError());
+    if(exceptions) {
+      m->endConcurrentNumbering();
+      throw std::runtime_error(Msg::GetLastError());
+    }
     if(!nPending) break;
     if(nIter++ > CTX::instance()->mesh.maxRetries) break;
   }
+  m->endConcurrentNumbering();
 
   Msg::StopProgressMeter();
 
@@ -479,13 +503,27 @@ static void PrintMesh2dStatistics(GModel *m)
   fclose(statreport);
 }
 
-static void Mesh2D(GModel *m)
+// if onlyPending is set, only retry the surfaces whose mesh is still pending
+// (e.g. after Mesh1DAnd2D), without resetting the status of the others; if a
+// cache is given, the meshes found in the cache are reused
+static void Mesh2D(GModel *m, bool onlyPending = false,
+                   meshCache *cache = nullptr)
 {
   if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return;
 
+  if(onlyPending) {
+    bool pending = false;
+    for(auto it = m->firstFace(); it != m->lastFace(); ++it)
+      if((*it)->meshStatistics.status == GFace::PENDING) pending = true;
+    if(!pending) {
+      PrintMesh2dStatistics(m);
+      return;
+    }
+  }
+
   m->getFields()->initialize();
 
-  if(TooManyElements(m, 2)) return;
+  if(!onlyPending && TooManyElements(m, 2)) return;
   Msg::StatusBar(true, "Meshing 2D...");
   double t1 = Cpu(), w1 = TimeOfDay();
 
@@ -513,8 +551,10 @@ static void Mesh2D(GModel *m)
       nthreads = 1;
   }
 
-  for(auto it = m->firstFace(); it != m->lastFace(); ++it)
-    (*it)->meshStatistics.status = GFace::PENDING;
+  if(!onlyPending) {
+    for(auto it = m->firstFace(); it != m->lastFace(); ++it)
+      (*it)->meshStatistics.status = GFace::PENDING;
+  }
 
   // boundary layers are special: their generation (including vertices and curve
   // meshes) is global as it depends on a smooth normal field generated from the
@@ -527,6 +567,7 @@ static void Mesh2D(GModel *m)
 
     Msg::StartProgressMeter(nTot);
 
+    m->beginConcurrentNumbering();
     while(1) {
       if(CTX::instance()->abortOnError && Msg::GetErrorCount()) {
         Msg::Warning("Aborted 2D meshing");
@@ -537,14 +578,24 @@ static void Mesh2D(GModel *m)
       bool exceptions = false;
       std::vector<GFace *> temp;
       temp.insert(temp.begin(), f.begin(), f.end());
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      // do not start more threads than there are surfaces to mesh, so that
+      // the threads can be used within the surface if there is a single one
+      // (see meshGFaceBDS.cpp)
+      int nToMesh = 0;
+      for(size_t K = 0; K < temp.size(); K++)
+        if(temp[K]->meshStatistics.status == GFace::PENDING) nToMesh++;
+      int nt = std::max(1, std::min(nthreads, nToMesh));
+#pragma omp parallel for schedule(dynamic) num_threads(nt)
       for(size_t K = 0; K < temp.size(); K++) {
         if(exceptions) continue;
         int localPending = 0;
         if(temp[K]->meshStatistics.status == GFace::PENDING) {
           backgroundMesh::current()->unset();
           try{ // OpenMP forbids leaving block via exception
-            temp[K]->mesh(true);
+            if(!cache || !cache->load(temp[K])) {
+              temp[K]->mesh(true);
+              if(cache) cache->save(temp[K]);
+            }
           }
           catch(...) {
             exceptions = true;
@@ -557,13 +608,17 @@ static void Mesh2D(GModel *m)
         }
         if(!nIter) Msg::ProgressMeter(localPending, false, "Meshing 2D...");
       }
-      if(exceptions) throw std::runtime_error(Msg::GetLastError());
+      if(exceptions) {
+        m->endConcurrentNumbering();
+        throw std::runtime_error(Msg::GetLastError());
+      }
       if(!nPending) break;
       // iter == 2 is for meshing re-parametrized surfaces; after that, we
       // serialize (self-intersections of 1D meshes are not thread safe)!
       if(nIter > 2) nthreads = 1;
       if(nIter++ > CTX::instance()->mesh.maxRetries) break;
     }
+    m->endConcurrentNumbering();
 
     Msg::StopProgressMeter();
   }
@@ -589,6 +644,197 @@ static void Mesh2D(GModel *m)
   PrintMesh2dStatistics(m);
 }
 
+// Mesh curves and surfaces in a single multi-threaded pass: instead of waiting
+// for the whole 1D mesh to be completed, each surface is scheduled as soon as
+// all its bounding and embedded curves are meshed and numbered. The curves are
+// numbered in their order, once all the previous curves are meshed, so that the
+// surfaces see the same node numbers as after Mesh1D (the surface meshing
+// algorithms depend on them), and the mesh does not depend on the scheduling
+// of the threads. Returns false if the pipelined pass could not be used;
+// otherwise the curves and surfaces that are still pending afterwards (e.g.
+// compounds or periodic copies) are left for the regular retry loops in Mesh1D
+// and Mesh2D.
+static bool Mesh1DAnd2D(GModel *m, meshCache *cache)
+{
+  if(!CTX::instance()->mesh.pipelineMeshing) return false;
+  if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return false;
+  if(CTX::instance()->mesh.algo2d == ALGO_2D_QUAD_QUASI_STRUCT) return false;
+
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads2D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads2D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // same restrictions as in Mesh1D and Mesh2D: only use the pipeline when both
+  // phases could run in parallel
+  if(m->getFields()->getNumBoundaryLayerFields()) nthreads = 1;
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
+    if((*it)->meshAttributes.extrude &&
+       (*it)->meshAttributes.extrude->mesh.ExtrudeMesh)
+      nthreads = 1;
+  }
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
+    if((*it)->getMeshingAlgo() == ALGO_2D_FRONTAL_QUAD ||
+       (*it)->getMeshingAlgo() == ALGO_2D_PACK_PRLGRMS ||
+       (*it)->getMeshingAlgo() == ALGO_2D_PACK_PRLGRMS_CSTR)
+      nthreads = 1;
+    if((*it)->getMeshMaster() != *it) nthreads = 1;
+    if((*it)->meshAttributes.extrude &&
+       (*it)->meshAttributes.extrude->mesh.ExtrudeMesh)
+      nthreads = 1;
+  }
+  if(nthreads < 2) return false;
+
+  // compounds are meshed globally once all their parts are meshed
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it)
+    if((*it)->compound.size()) return false;
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it)
+    if((*it)->compound.size()) return false;
+
+  // Extend fields are computed from the complete 1D mesh
+  FieldManager *fields = m->getFields();
+  for(auto it = fields->begin(); it != fields->end(); ++it)
+    if(!strcmp(it->second->getName(), "Extend")) return false;
+
+  fields->initialize();
+
+  if(TooManyElements(m, 2)) return false;
+  Msg::StatusBar(true, "Meshing 1D and 2D...");
+  double t1 = Cpu(), w1 = TimeOfDay();
+
+  std::vector<GEdge *> edges;
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
+    (*it)->meshStatistics.status = GEdge::PENDING;
+    edges.push_back(*it);
+  }
+
+  // for each surface, the number of curves it still waits for; and for each
+  // curve, the surfaces waiting for it
+  std::vector<GFace *> faces;
+  std::vector<int> waiting;
+  std::map<GEdge *, std::vector<std::size_t> > dependents;
+  std::vector<std::size_t> ready;
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
+    GFace *gf = *it;
+    gf->meshStatistics.status = GFace::PENDING;
+    std::set<GEdge *, GEntityPtrLessThan> deps(gf->edges().begin(),
+                                               gf->edges().end());
+    deps.insert(gf->embeddedEdges().begin(), gf->embeddedEdges().end());
+    for(auto ite = deps.begin(); ite != deps.end(); ++ite)
+      dependents[*ite].push_back(faces.size());
+    if(deps.empty()) ready.push_back(faces.size());
+    waiting.push_back(deps.size());
+    faces.push_back(gf);
+  }
+
+  Msg::StartProgressMeter(edges.size() + faces.size());
+
+  // each curve is meshed in a task; the task then numbers the curves that are
+  // meshed, up to the first one that is not, and creates a new task for each
+  // surface whose curves are then all numbered
+  std::vector<char> meshed(edges.size(), 0), unlocks(edges.size(), 0);
+  std::size_t numbered = 0;
+  int nDone = 0;
+  bool exceptions = false;
+  auto aborted = [&]() {
+    bool ret;
+#pragma omp critical(Mesh1DAnd2D)
+    ret = exceptions ||
+          (CTX::instance()->abortOnError && Msg::GetErrorCount());
+    return ret;
+  };
+  auto done = [&](bool ok) {
+    int localDone = 0;
+#pragma omp critical(Mesh1DAnd2D)
+    {
+      localDone = ++nDone;
+      if(!ok) exceptions = true;
+    }
+    Msg::ProgressMeter(localDone, false, "Meshing 1D and 2D...");
+  };
+  auto meshFace = [&](GFace *gf) {
+    if(aborted()) return;
+    bool ok = true;
+    try { // OpenMP forbids leaving block via exception
+      if(!cache || !cache->load(gf)) {
+        backgroundMesh::current()->unset();
+        gf->mesh(true);
+        if(cache) cache->save(gf);
+      }
+    }
+    catch(...) {
+      ok = false;
+    }
+    done(ok);
+  };
+
+  m->beginConcurrentNumbering();
+#pragma omp parallel num_threads(nthreads)
+#pragma omp single
+  {
+    for(std::size_t i = 0; i < ready.size(); i++) {
+      GFace *gf = faces[ready[i]];
+#pragma omp task firstprivate(gf)
+      meshFace(gf);
+    }
+    for(std::size_t i = 0; i < edges.size(); i++) {
+#pragma omp task firstprivate(i)
+      {
+        GEdge *ge = edges[i];
+        bool ok = false;
+        if(!aborted()) {
+          ok = true;
+          try { // OpenMP forbids leaving block via exception
+            if(!cache || !cache->load(ge)) {
+              ge->mesh(true);
+              if(cache) cache->save(ge);
+            }
+          }
+          catch(...) {
+            ok = false;
+          }
+          done(ok);
+        }
+        std::vector<GFace *> unlocked;
+#pragma omp critical(Mesh1DAnd2D)
+        {
+          meshed[i] = 1;
+          // curves waiting for their mesh master are left for Mesh1D; the
+          // surfaces they bound are then left for Mesh2D
+          unlocks[i] = ok && (ge->meshStatistics.status != GEdge::PENDING ||
+                              ge->getMeshMaster() == ge);
+          for(; numbered < edges.size() && meshed[numbered]; numbered++) {
+            m->endConcurrentNumbering(edges[numbered]);
+            if(!unlocks[numbered]) continue;
+            auto it = dependents.find(edges[numbered]);
+            if(it == dependents.end()) continue;
+            for(std::size_t j = 0; j < it->second.size(); j++)
+              if(--waiting[it->second[j]] == 0)
+                unlocked.push_back(faces[it->second[j]]);
+          }
+        }
+        for(std::size_t j = 0; j < unlocked.size(); j++) {
+          GFace *gf = unlocked[j];
+#pragma omp task firstprivate(gf)
+          meshFace(gf);
+        }
+      }
+    }
+  }
+
+  m->endConcurrentNumbering();
+  Msg::StopProgressMeter();
+
+  if(exceptions) throw std::runtime_error(Msg::GetLastError());
+
+  double t2 = Cpu(), w2 = TimeOfDay();
+  CTX::instance()->meshTimer[0] = 0.;
+  CTX::instance()->meshTimer[1] = w2 - w1;
+  Msg::StatusBar(true, "Done meshing 1D and 2D (Wall %gs, CPU %gs)",
+                 CTX::instance()->meshTimer[1], t2 - t1);
+  return true;
+}
+
 static void
 FindConnectedRegions(const std::vector<GRegion *> &del,
                      std::vector<std::vector<GRegion *> > &connected)
@@ -990,6 +1236,30 @@ static void Mesh3D(GModel *m)
                  CTX::instance()->meshTimer[2], t2 - t1);
 }
 
+// mesh the volumes that have no mesh (if onlyEmpty is set) or all the volumes,
+// reusing the meshes found in the cache (if any): the other volumes are emptied
+// and meshed by Mesh3D
+static void Mesh3DWithCache(GModel *m, meshCache *cache, bool onlyEmpty)
+{
+  int meshOnlyEmpty = CTX::instance()->mesh.meshOnlyEmpty;
+  if(meshOnlyEmpty) onlyEmpty = true;
+  std::vector<GRegion *> toMesh;
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+    GRegion *gr = *it;
+    if(CTX::instance()->mesh.meshOnlyVisible && !gr->getVisibility()) continue;
+    if(onlyEmpty && gr->getNumMeshElements()) continue;
+    if(cache && cache->load(gr)) continue;
+    deMeshGRegion()(gr);
+    toMesh.push_back(gr);
+  }
+  CTX::instance()->mesh.meshOnlyEmpty = 1;
+  Mesh3D(m);
+  CTX::instance()->mesh.meshOnlyEmpty = meshOnlyEmpty;
+  if(cache) {
+    for(std::size_t i = 0; i < toMesh.size(); i++) cache->save(toMesh[i]);
+  }
+}
+
 void OptimizeMesh(GModel *m, const std::string &how, bool force, int niter)
 {
   if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return;
@@ -1010,8 +1280,13 @@ void OptimizeMesh(GModel *m, const std::string &how, bool force, int niter)
     Msg::StatusBar(true, "Optimizing mesh (%s)...", how.c_str());
   double t1 = Cpu(), w1 = TimeOfDay();
 
+  // the mesh size fields might have changed since the mesh was generated
+  BGM_ClearMeshSizeCache();
+
   if(how == "" || how == "Gmsh" || how == "Optimize") {
     for(auto it = m->firstRegion(); it != m->lastRegion(); it++) {
+      if(CTX::instance()->mesh.meshOnlyVisible && !(*it)->getVisibility())
+        continue;
       optimizeMeshGRegion opt;
       opt(*it, force);
     }
@@ -1019,6 +1294,8 @@ void OptimizeMesh(GModel *m, const std::string &how, bool force, int niter)
   }
   else if(how == "Netgen") {
     for(auto it = m->firstRegion(); it != m->lastRegion(); it++) {
+      if(CTX::instance()->mesh.meshOnlyVisible && !(*it)->getVisibility())
+        continue;
       optimizeMeshGRegionNetgen opt;
       opt(*it, force);
     }
@@ -1043,7 +1320,7 @@ void OptimizeMesh(GModel *m, const std::string &how, bool force, int niter)
   }
   else if(how == "HighOrderElastic") {
 #if defined(HAVE_OPTHOM)
-    HighOrderMeshElasticAnalogy(m, false);
+    HighOrderMeshElasticAnalogy(m, CTX::instance()->mesh.meshOnlyVisible);
 #else
     Msg::Error("High-order mesh optimization requires the OPTHOM module");
 #endif
@@ -1472,6 +1749,166 @@ void FixPeriodicMesh(GModel *m)
   }
 }
 
+// incremental meshing is only used when the meshes of the entities can be
+// regenerated independently of each other
+static bool IncrementalMeshingPossible(GModel *m)
+{
+  if(m->getFields()->getNumBoundaryLayerFields()) return false;
+  if(CTX::instance()->mesh.algo2d == ALGO_2D_QUAD_QUASI_STRUCT ||
+     CTX::instance()->mesh.algo2d == ALGO_2D_PACK_PRLGRMS)
+    return false;
+  // subdivision and 3D recombination modify the existing meshes
+  if(CTX::instance()->mesh.algoSubdivide ||
+     CTX::instance()->mesh.recombine3DAll)
+    return false;
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
+    if((*it)->compound.size()) return false;
+    ExtrudeParams *ep = (*it)->meshAttributes.extrude;
+    if(ep && ep->mesh.ExtrudeMesh) return false;
+  }
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
+    if((*it)->compound.size()) return false;
+    ExtrudeParams *ep = (*it)->meshAttributes.extrude;
+    if(ep && ep->mesh.ExtrudeMesh) return false;
+  }
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+    if((*it)->meshAttributes.recombine3D) return false;
+    ExtrudeParams *ep = (*it)->meshAttributes.extrude;
+    if(ep && ep->mesh.ExtrudeMesh) return false;
+  }
+  return true;
+}
+
+// Delete the mesh of the entities (of dimension <= dim) that must be remeshed
+// by an incremental mesh generation, i.e. whose signature changed since their
+// mesh was generated, whose mesh is empty, or whose bounding or embedded
+// entities (or periodic master) are remeshed; and mark the meshes of the other
+// entities as done (and return them in kept). Entities of dimension > dim are
+// always demeshed. Returns false, without modifying any mesh, if no mesh can
+// be kept.
+static bool DeMeshChangedEntities(GModel *m, int dim,
+                                  std::map<GEntity *, std::size_t> &signatures,
+                                  std::set<GEntity *> &kept)
+{
+  auto unchanged = [&](GEntity *ge) {
+    return ge->dim() <= dim && ge->meshSignature &&
+           ge->meshSignature == signatures[ge];
+  };
+  auto allKept = [&](GEntity *const *beg, std::size_t n) {
+    for(std::size_t i = 0; i < n; i++)
+      if(!kept.count(beg[i])) return false;
+    return true;
+  };
+  auto keptMaster = [&](GEntity *ge) {
+    return ge->getMeshMaster() == ge || kept.count(ge->getMeshMaster());
+  };
+
+  for(auto it = m->firstVertex(); it != m->lastVertex(); ++it) {
+    if(unchanged(*it) && (*it)->mesh_vertices.size()) kept.insert(*it);
+  }
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
+    GEdge *ge = *it;
+    if(!unchanged(ge)) continue;
+    if(!ge->getNumMeshElements() && ge->meshAttributes.method != MESH_NONE)
+      continue;
+    if(ge->getBeginVertex() && !kept.count(ge->getBeginVertex())) continue;
+    if(ge->getEndVertex() && !kept.count(ge->getEndVertex())) continue;
+    kept.insert(ge);
+  }
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
+    if(!keptMaster(*it)) kept.erase(*it);
+  }
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
+    GFace *gf = *it;
+    if(!unchanged(gf)) continue;
+    if(!gf->getNumMeshElements() && gf->meshAttributes.method != MESH_NONE)
+      continue;
+    std::vector<GEdge *> const &edges = gf->edges();
+    std::vector<GEdge *> const &emb = gf->embeddedEdges();
+    std::vector<GVertex *> embv(gf->embeddedVertices().begin(),
+                                gf->embeddedVertices().end());
+    if(!allKept((GEntity *const *)edges.data(), edges.size()) ||
+       !allKept((GEntity *const *)emb.data(), emb.size()) ||
+       !allKept((GEntity *const *)embv.data(), embv.size()))
+      continue;
+    kept.insert(gf);
+  }
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
+    if(!keptMaster(*it)) kept.erase(*it);
+  }
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+    GRegion *gr = *it;
+    if(!unchanged(gr)) continue;
+    if(!gr->getNumMeshElements() && gr->meshAttributes.method != MESH_NONE)
+      continue;
+    std::vector<GFace *> faces = gr->faces();
+    if(!allKept((GEntity *const *)faces.data(), faces.size()) ||
+       !allKept((GEntity *const *)gr->embeddedFaces().data(),
+                gr->embeddedFaces().size()) ||
+       !allKept((GEntity *const *)gr->embeddedEdges().data(),
+                gr->embeddedEdges().size()) ||
+       !allKept((GEntity *const *)gr->embeddedVertices().data(),
+                gr->embeddedVertices().size()))
+      continue;
+    kept.insert(gr);
+  }
+
+  if(kept.empty()) return false;
+
+  // delete the meshes from the highest dimension down, as the lower
+  // dimensional meshes are used by the higher dimensional ones
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+    if(!kept.count(*it)) deMeshGRegion()(*it);
+  }
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it) {
+    if(!kept.count(*it))
+      deMeshGFace()(*it);
+    else
+      (*it)->meshStatistics.status = GFace::DONE;
+  }
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it) {
+    if(!kept.count(*it))
+      deMeshGEdge()(*it);
+    else
+      (*it)->meshStatistics.status = GEdge::DONE;
+  }
+  for(auto it = m->firstVertex(); it != m->lastVertex(); ++it) {
+    if(kept.count(*it)) continue;
+    // the meshes of discrete curves are not regenerated, and still use the
+    // nodes of their end points
+    bool discrete = false;
+    for(auto e : (*it)->edges())
+      if(e->isFullyDiscrete()) discrete = true;
+    if(!discrete) (*it)->deleteMesh();
+  }
+  Msg::Info("Incremental meshing: keeping the mesh of %lu entities out of %lu",
+            kept.size(), signatures.size());
+  return true;
+}
+
+// Temporarily hide the entities whose mesh was kept by an incremental mesh
+// generation (if hide is true), or show them again (if hide is false), so that
+// the optimization passes, which then only consider the visible entities, are
+// restricted to the entities that have been remeshed
+static void HideKeptEntities(const std::set<GEntity *> &kept, bool hide,
+                             std::vector<GEntity *> &hidden, int &onlyVisible)
+{
+  if(hide) {
+    for(auto ge : kept) {
+      if(!ge->getVisibility()) continue;
+      ge->setVisibility(0);
+      hidden.push_back(ge);
+    }
+    onlyVisible = CTX::instance()->mesh.meshOnlyVisible;
+    CTX::instance()->mesh.meshOnlyVisible = 1;
+  }
+  else {
+    for(auto ge : hidden) ge->setVisibility(1);
+    hidden.clear();
+    CTX::instance()->mesh.meshOnlyVisible = onlyVisible;
+  }
+}
+
 //#include <google/profiler.h>
 
 void GenerateMesh(GModel *m, int ask)
@@ -1550,25 +1987,64 @@ void GenerateMesh(GModel *m, int ask)
   // dimension of previous/existing mesh
   int old = m->getMeshStatus(false);
 
-  // 1D mesh
-  if(ask == 1 || (ask > 1 && old < 1)) {
+  // signatures of the entities, to only remesh the entities that changed
+  // since the previous mesh generation, and/or to reuse the meshes stored in
+  // the cache
+  std::map<GEntity *, std::size_t> signatures;
+  std::set<GEntity *> kept;
+  bool incremental = false;
+  meshCache *cache = nullptr;
+  int minDim = 4; // lowest dimension of the meshes generated below
+  if(CTX::instance()->mesh.incremental ||
+     CTX::instance()->mesh.cacheDirectory.size()) {
+    computeMeshSignatures(m, signatures);
+    if(IncrementalMeshingPossible(m)) {
+      if(CTX::instance()->mesh.incremental && old > 0)
+        incremental = DeMeshChangedEntities(m, ask, signatures, kept);
+      if(CTX::instance()->mesh.cacheDirectory.size())
+        cache = new meshCache(m, CTX::instance()->mesh.cacheDirectory,
+                              signatures);
+    }
+  }
+
+  if(incremental) {
+    // only mesh the entities whose mesh has been deleted
+    minDim = 0;
+    Mesh0D(m);
+    Mesh1D(m, true, cache);
+    if(ask >= 2) Mesh2D(m, true, cache);
+    if(ask == 3) Mesh3DWithCache(m, cache, true);
+  }
+
+  // 1D mesh (possibly overlapped with the 2D mesh)
+  bool pipelined = false;
+  if(!incremental && (ask == 1 || (ask > 1 && old < 1))) {
+    minDim = 0;
     std::for_each(m->firstRegion(), m->lastRegion(), deMeshGRegion());
     std::for_each(m->firstFace(), m->lastFace(), deMeshGFace());
     Mesh0D(m);
-    Mesh1D(m);
+    if(ask > 1) pipelined = Mesh1DAnd2D(m, cache);
+    Mesh1D(m, pipelined, cache);
   }
 
   // 2D mesh
-  if(ask == 2 || (ask > 2 && old < 2)) {
+  if(!incremental && (ask == 2 || (ask > 2 && old < 2))) {
+    minDim = std::min(minDim, 2);
     std::for_each(m->firstRegion(), m->lastRegion(), deMeshGRegion());
-    Mesh2D(m);
+    Mesh2D(m, pipelined, cache);
     // if two passes --> juste fait le ...
     //    createSizeFieldFromExistingMesh (m, false);
     // Mesh2D(m);
   }
 
   // 3D mesh
-  if(ask == 3) { Mesh3D(m); }
+  if(!incremental && ask == 3) {
+    minDim = std::min(minDim, 3);
+    if(cache)
+      Mesh3DWithCache(m, cache, false);
+    else
+      Mesh3D(m);
+  }
 
   // Orient the line and surface meshes so that they match the orientation of
   // the geometrical entities and/or the user orientation constraints
@@ -1577,16 +2053,23 @@ void GenerateMesh(GModel *m, int ask)
   if(m->getMeshStatus() >= 2)
     std::for_each(m->firstFace(), m->lastFace(), orientMeshGFace());
 
+  // the meshes kept by an incremental mesh generation have already been
+  // optimized
+  std::vector<GEntity *> hidden;
+  int onlyVisible = 0;
+
   // Optimize quality of 3D tet mesh
   if(m->getMeshStatus() == 3 &&
      CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
      CTX::instance()->mesh.algo3d != ALGO_3D_HXT) {
+    if(incremental) HideKeptEntities(kept, true, hidden, onlyVisible);
     for(int i = 0; i < std::max(CTX::instance()->mesh.optimize,
                                 CTX::instance()->mesh.optimizeNetgen);
         i++) {
       if(CTX::instance()->mesh.optimize > i) OptimizeMesh(m);
       if(CTX::instance()->mesh.optimizeNetgen > i) OptimizeMesh(m, "Netgen");
     }
+    if(incremental) HideKeptEntities(kept, false, hidden, onlyVisible);
   }
 
   // Subdivide into quads or hexas
@@ -1598,13 +2081,16 @@ void GenerateMesh(GModel *m, int ask)
     BarycentricRefineMesh(m);
 
   if(m->getMeshStatus() && CTX::instance()->mesh.order > 1) {
-    // Create high order elements
+    // Create high order elements (the kept meshes are not hidden here, so
+    // that the high-order nodes on their boundaries are shared with the
+    // remeshed entities)
     SetOrderN(m, CTX::instance()->mesh.order,
               CTX::instance()->mesh.secondOrderLinear,
               CTX::instance()->mesh.secondOrderIncomplete,
               CTX::instance()->mesh.meshOnlyVisible);
 
     // Optimize high order elements
+    if(incremental) HideKeptEntities(kept, true, hidden, onlyVisible);
     if(CTX::instance()->mesh.hoOptimize == 2 ||
        CTX::instance()->mesh.hoOptimize == 3)
       OptimizeMesh(m, "HighOrderElastic");
@@ -1615,19 +2101,35 @@ void GenerateMesh(GModel *m, int ask)
 
     if(CTX::instance()->mesh.hoOptimize == 4)
       OptimizeMesh(m, "HighOrderFastCurving");
+    if(incremental) HideKeptEntities(kept, false, hidden, onlyVisible);
   }
 
   // make sure periodic meshes are actually periodic and store periodic node
   // correspondences
   FixPeriodicMesh(m);
 
+  // store the signatures of the entities that have been meshed, so that their
+  // mesh can be kept by the next incremental mesh generation
+  for(auto it = signatures.begin(); it != signatures.end(); ++it) {
+    int dim = it->first->dim();
+    if(dim >= minDim && dim <= ask) it->first->meshSignature = it->second;
+  }
+
   Msg::Info("%d nodes %d elements", m->getNumMeshVertices(),
             m->getNumMeshElements());
 
+  if(cache) {
+    cache->printStatistics();
+    delete cache;
+  }
+
   Msg::PrintErrorCounter("Mesh generation error summary");
 
   if(qqs != nullptr) delete qqs;
 
+  // free the cached mesh sizes
+  BGM_ClearMeshSizeCache();
+
   CTX::instance()->lock = 0;
   // ProfilerStop();
 }
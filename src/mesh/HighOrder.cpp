@@ -8,7 +8,9 @@
 //
 
 #include <sstream>
+#include <set>
 #include <vector>
+#include <unordered_map>
 #include "GmshConfig.h"
 #include "GModel.h"
 #include "HighOrder.h"
@@ -24,6 +26,7 @@
 #include "fullMatrix.h"
 #include "BasisFactory.h"
 #include "nodalBasis.h"
+#include "ElementType.h"
 #include "InnerVertexPlacement.h"
 #include "Context.h"
 #include "MFace.h"
@@ -369,14 +372,15 @@ static bool getEdgeVerticesOnGeo(GFace *gf, MVertex *v0, MVertex *v1,
 
 static void interpVerticesInExistingEdge(GEntity *ge, const MElement *edgeEl,
                                          std::vector<MVertex *> &veEdge,
-                                         int nPts)
+                                         int nPts, std::size_t num = 0)
 {
   fullMatrix<double> points;
   points = edgeEl->getFunctionSpace(nPts + 1)->points;
   for(int k = 2; k < nPts + 2; k++) {
     SPoint3 pos;
     edgeEl->pnt(points(k, 0), 0., 0., pos);
-    MVertex *v = new MVertex(pos.x(), pos.y(), pos.z(), ge);
+    MVertex *v =
+      new MVertex(pos.x(), pos.y(), pos.z(), ge, num ? num + k - 2 : 0);
     veEdge.push_back(v);
   }
 }
@@ -481,38 +485,6 @@ static void getEdgeVertices(GFace *gf, MElement *ele,
   }
 }
 
-// Get new interior vertices for an edge in a 3D element
-static void getEdgeVertices(GRegion *gr, MElement *ele,
-                            std::vector<MVertex *> &ve,
-                            edgeContainer &edgeVertices, int nPts = 1)
-{
-  for(int i = 0; i < ele->getNumEdges(); i++) {
-    std::vector<MVertex *> veOld;
-    ele->getEdgeVertices(i, veOld);
-    MVertex *vMin, *vMax;
-    const bool increasing = getMinMaxVert(veOld[0], veOld[1], vMin, vMax);
-    std::pair<MVertex *, MVertex *> p(vMin, vMax);
-    std::vector<MVertex *> veEdge;
-    if(edgeVertices.count(p)) { // Vertices already exist
-      if(increasing)
-        veEdge.assign(edgeVertices[p].begin(), edgeVertices[p].end());
-      else
-        veEdge.assign(edgeVertices[p].rbegin(), edgeVertices[p].rend());
-    }
-    else { // Vertices do not exist, create them
-      const MLineN edgeEl(veOld, ele->getPolynomialOrder());
-      interpVerticesInExistingEdge(gr, &edgeEl, veEdge, nPts);
-      if(increasing) // Add newly created vertices to list
-        edgeVertices[p].insert(edgeVertices[p].end(), veEdge.begin(),
-                               veEdge.end());
-      else
-        edgeVertices[p].insert(edgeVertices[p].end(), veEdge.rbegin(),
-                               veEdge.rend());
-    }
-    ve.insert(ve.end(), veEdge.begin(), veEdge.end());
-  }
-}
-
 // Creation of high-order face vertices
 
 static void reorientTrianglePoints(std::vector<MVertex *> &vtcs,
@@ -665,10 +637,13 @@ static void reorientQuadPoints(std::vector<MVertex *> &vtcs, int orientation,
   }
 }
 
+// if firstNum is not zero, the new vertices are numbered firstNum, firstNum + 1,
+// ...
 static void interpVerticesInExistingFace(GEntity *ge,
                                          const fullMatrix<double> &coefficients,
                                          const std::vector<MVertex *> &vertices,
-                                         std::vector<MVertex *> &vFace)
+                                         std::vector<MVertex *> &vFace,
+                                         std::size_t firstNum = 0)
 {
   for(int k = 0; k < coefficients.size1(); k++) {
     double x(0), y(0), z(0);
@@ -678,7 +653,7 @@ static void interpVerticesInExistingFace(GEntity *ge,
       y += coefficients(k, j) * v->y();
       z += coefficients(k, j) * v->z();
     }
-    vFace.push_back(new MVertex(x, y, z, ge));
+    vFace.push_back(new MVertex(x, y, z, ge, firstNum ? firstNum + k : 0));
   }
 }
 
@@ -855,53 +830,11 @@ static int retrieveFaceBoundaryVertices(int k, int type, int nPts,
   }
 }
 
-// Get new face (excluding edge) vertices for a face of a 3D element
-static void getFaceVertices(GRegion *gr, MElement *ele,
-                            std::vector<MVertex *> &newVertices,
-                            faceContainer &faceVertices, int nPts = 1)
-{
-  std::vector<MVertex *> vCorner;
-  ele->getVertices(vCorner);
-  // NB: We can get more than corner vertices but we use only corners
-
-  for(int i = 0; i < ele->getNumFaces(); i++) {
-    MFace face = ele->getFace(i);
-    std::vector<MVertex *> vFace;
-    auto fIter = faceVertices.find(face);
-    if(fIter != faceVertices.end()) { // Vertices already exist
-      std::vector<MVertex *> vtcs = fIter->second;
-      int orientation;
-      bool swap;
-      if(fIter->first.computeCorrespondence(face, orientation, swap)) {
-        // Check correspondence and apply permutation if needed
-        if(face.getNumVertices() == 3 && nPts > 1)
-          reorientTrianglePoints(vtcs, orientation, swap);
-        else if(face.getNumVertices() == 4)
-          reorientQuadPoints(vtcs, orientation, swap, nPts - 1);
-      }
-      else
-        Msg::Error(
-          "Error in face lookup for retrieval of high order face nodes");
-      vFace.assign(vtcs.begin(), vtcs.end());
-    }
-    else { // Vertices do not exist, create them by interpolation
-      std::vector<MVertex *> faceBoundaryVertices;
-      int type = retrieveFaceBoundaryVertices(
-        i, ele->getType(), nPts, vCorner, newVertices, faceBoundaryVertices);
-      fullMatrix<double> *coefficients =
-        getInnerVertexPlacement(type, nPts + 1);
-      interpVerticesInExistingFace(gr, *coefficients, faceBoundaryVertices,
-                                   vFace);
-      faceVertices[face].insert(faceVertices[face].end(), vFace.begin(),
-                                vFace.end());
-    }
-    newVertices.insert(newVertices.end(), vFace.begin(), vFace.end());
-  }
-}
-
-// Get new interior vertices for a 3D element
+// Get new interior vertices for a 3D element, numbered firstNum, firstNum + 1,
+// ...
 static void getVolumeVertices(GRegion *gr, MElement *ele,
-                              std::vector<MVertex *> &newVertices, int nPts = 1)
+                              std::vector<MVertex *> &newVertices,
+                              std::size_t firstNum, int nPts = 1)
 {
   std::vector<MVertex *> boundaryVertices;
   {
@@ -923,7 +856,7 @@ static void getVolumeVertices(GRegion *gr, MElement *ele,
       y += coefficients(k, j) * v->y();
       z += coefficients(k, j) * v->z();
     }
-    MVertex *v = new MVertex(x, y, z, gr);
+    MVertex *v = new MVertex(x, y, z, gr, firstNum + k);
     newVertices.push_back(v);
   }
 }
@@ -1028,168 +961,424 @@ static void setHighOrder(GFace *gf, edgeContainer &edgeVertices,
   gf->deleteVertexArrays();
 }
 
-static MTetrahedron *setHighOrder(MTetrahedron *t, GRegion *gr,
-                                  edgeContainer &edgeVertices,
-                                  faceContainer &faceVertices, bool incomplete,
-                                  int nPts)
-{
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, t, v, edgeVertices, nPts);
-  if(nPts == 1) {
-    return new MTetrahedron10(t->getVertex(0), t->getVertex(1), t->getVertex(2),
-                              t->getVertex(3), v[0], v[1], v[2], v[3], v[4],
-                              v[5], 0, t->getPartition());
+// Creation of high-order volume elements, in parallel
+//
+// The unique high-order vertices on the edges and faces of the volume elements
+// are indexed in hash maps partitioned by edge/face key: each thread scans all
+// the elements but only inserts the keys of its own partitions. Vertices are
+// then created concurrently, and numbered (as are the new elements) according
+// to the first element in which each edge/face appears, so that the numbering
+// does not depend on the number of threads.
+
+typedef std::pair<MVertex *, MVertex *> edgeKey;
+
+struct edgeKeyHash {
+  std::size_t operator()(const edgeKey &e) const
+  {
+    std::size_t h = e.first->getNum() * 1000003 ^ e.second->getNum();
+    return h ^ (h >> 17);
   }
-  else {
-    if(!incomplete) {
-      getFaceVertices(gr, t, v, faceVertices, nPts);
-      getVolumeVertices(gr, t, v, nPts);
-    }
-    return new MTetrahedronN(t->getVertex(0), t->getVertex(1), t->getVertex(2),
-                             t->getVertex(3), v, nPts + 1, 0,
-                             t->getPartition());
+};
+
+struct faceKeyHash {
+  std::size_t operator()(const MFace &f) const
+  {
+    std::size_t h = 0;
+    for(std::size_t i = 0; i < f.getNumVertices(); i++)
+      h = h * 1000003 ^ f.getSortedVertex(i)->getNum();
+    return h ^ (h >> 17);
+  }
+};
+
+// index of the first high-order vertex of each edge/face in
+// volumeHighOrderData::edgeVertices/faceVertices
+typedef std::unordered_map<edgeKey, std::size_t, edgeKeyHash> edgeIndexMap;
+typedef std::unordered_map<MFace, std::size_t, faceKeyHash, MFaceEqual>
+  faceIndexMap;
+
+class volumeHighOrderData {
+public:
+  int nPts;
+  bool incomplete;
+  std::vector<MElement *> elements;
+  std::vector<GRegion *> regions; // region of each element
+  // high-order vertices of curves and surfaces
+  const edgeContainer &edgeVertices;
+  const faceContainer &faceVertices;
+  // high-order vertices created on the edges and faces of the elements
+  std::vector<edgeIndexMap> edgeMaps;
+  std::vector<faceIndexMap> faceMaps;
+  std::vector<MVertex *> newEdgeVertices, newFaceVertices;
+
+  volumeHighOrderData(int n, bool inc, const edgeContainer &ev,
+                      const faceContainer &fv)
+    : nPts(n), incomplete(inc), edgeVertices(ev), faceVertices(fv)
+  {
+  }
+  bool hasFaceVertices(MElement *e) const
+  {
+    if(incomplete) return false;
+    return e->getType() != TYPE_TET || nPts > 1;
+  }
+  bool hasVolumeVertices(MElement *e) const
+  {
+    if(incomplete) return false;
+    return e->getType() == TYPE_HEX || nPts > 1;
+  }
+  int numFaceVertices(const MFace &f) const
+  {
+    return getInnerVertexPlacement(f.getNumVertices() == 3 ? TYPE_TRI : TYPE_QUA,
+                                   nPts + 1)
+      ->size1();
+  }
+  std::size_t partition(const edgeKey &p) const
+  {
+    return edgeKeyHash()(p) % edgeMaps.size();
+  }
+  std::size_t partition(const MFace &f) const
+  {
+    return faceKeyHash()(f) % faceMaps.size();
   }
+};
+
+static edgeKey getEdgeKey(MElement *e, int i, bool &increasing)
+{
+  MEdge edge = e->getEdge(i);
+  MVertex *vMin, *vMax;
+  increasing = getMinMaxVert(edge.getVertex(0), edge.getVertex(1), vMin, vMax);
+  return edgeKey(vMin, vMax);
 }
 
-static MHexahedron *setHighOrder(MHexahedron *h, GRegion *gr,
-                                 edgeContainer &edgeVertices,
-                                 faceContainer &faceVertices, bool incomplete,
-                                 int nPts)
+// append the high-order vertices of the edges of the element
+static void getEdgeVertices(const volumeHighOrderData &data, MElement *e,
+                            std::vector<MVertex *> &v)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, h, v, edgeVertices, nPts);
-  if(incomplete) {
-    if(nPts == 1) {
-      return new MHexahedron20(
-        h->getVertex(0), h->getVertex(1), h->getVertex(2), h->getVertex(3),
-        h->getVertex(4), h->getVertex(5), h->getVertex(6), h->getVertex(7),
-        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
-        v[11], 0, h->getPartition());
+  for(int i = 0; i < e->getNumEdges(); i++) {
+    bool increasing;
+    edgeKey p = getEdgeKey(e, i, increasing);
+    std::vector<MVertex *>::const_iterator begin, end;
+    auto it = data.edgeVertices.find(p);
+    if(it != data.edgeVertices.end()) {
+      begin = it->second.begin();
+      end = it->second.end();
     }
     else {
-      return new MHexahedronN(h->getVertex(0), h->getVertex(1), h->getVertex(2),
-                              h->getVertex(3), h->getVertex(4), h->getVertex(5),
-                              h->getVertex(6), h->getVertex(7), v, nPts + 1, 0,
-                              h->getPartition());
+      const edgeIndexMap &map = data.edgeMaps[data.partition(p)];
+      auto it2 = map.find(p);
+      if(it2 == map.end()) {
+        Msg::Error("Missing high order nodes on mesh edge");
+        continue;
+      }
+      begin = data.newEdgeVertices.begin() + it2->second;
+      end = begin + data.nPts;
     }
+    if(increasing)
+      v.insert(v.end(), begin, end);
+    else
+      v.insert(v.end(), std::reverse_iterator<decltype(end)>(end),
+               std::reverse_iterator<decltype(begin)>(begin));
   }
-  else {
-    getFaceVertices(gr, h, v, faceVertices, nPts);
-    getVolumeVertices(gr, h, v, nPts);
-    if(nPts == 1) {
-      return new MHexahedron27(
-        h->getVertex(0), h->getVertex(1), h->getVertex(2), h->getVertex(3),
-        h->getVertex(4), h->getVertex(5), h->getVertex(6), h->getVertex(7),
-        v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
-        v[11], v[12], v[13], v[14], v[15], v[16], v[17], v[18], 0,
-        h->getPartition());
+}
+
+// append the high-order vertices of the faces of the element
+static void getFaceVertices(const volumeHighOrderData &data, MElement *e,
+                            std::vector<MVertex *> &v)
+{
+  for(int i = 0; i < e->getNumFaces(); i++) {
+    MFace face = e->getFace(i);
+    if(!data.numFaceVertices(face)) continue;
+    const MFace *key;
+    std::vector<MVertex *> vtcs;
+    auto it = data.faceVertices.find(face);
+    if(it != data.faceVertices.end()) {
+      key = &it->first;
+      vtcs = it->second;
     }
     else {
-      return new MHexahedronN(h->getVertex(0), h->getVertex(1), h->getVertex(2),
-                              h->getVertex(3), h->getVertex(4), h->getVertex(5),
-                              h->getVertex(6), h->getVertex(7), v, nPts + 1, 0,
-                              h->getPartition());
+      const faceIndexMap &map = data.faceMaps[data.partition(face)];
+      auto it2 = map.find(face);
+      if(it2 == map.end()) {
+        Msg::Error("Missing high order nodes on mesh face");
+        continue;
+      }
+      key = &it2->first;
+      auto begin = data.newFaceVertices.begin() + it2->second;
+      vtcs.assign(begin, begin + data.numFaceVertices(face));
+    }
+    int orientation;
+    bool swap;
+    if(key->computeCorrespondence(face, orientation, swap)) {
+      // Check correspondence and apply permutation if needed
+      if(face.getNumVertices() == 3 && data.nPts > 1)
+        reorientTrianglePoints(vtcs, orientation, swap);
+      else if(face.getNumVertices() == 4)
+        reorientQuadPoints(vtcs, orientation, swap, data.nPts - 1);
     }
+    else
+      Msg::Error("Error in face lookup for retrieval of high order face nodes");
+    v.insert(v.end(), vtcs.begin(), vtcs.end());
   }
 }
 
-static MPrism *setHighOrder(MPrism *p, GRegion *gr, edgeContainer &edgeVertices,
-                            faceContainer &faceVertices, bool incomplete,
-                            int nPts)
+static MElement *createHighOrderElement(MElement *e,
+                                        const std::vector<MVertex *> &v,
+                                        bool incomplete, int nPts,
+                                        std::size_t num)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, p, v, edgeVertices, nPts);
-  if(incomplete) {
+  std::vector<MVertex *> vAll;
+  e->getVertices(vAll);
+  vAll.insert(vAll.end(), v.begin(), v.end());
+  const int part = e->getPartition();
+  switch(e->getType()) {
+  case TYPE_TET:
+    if(nPts == 1) return new MTetrahedron10(vAll, num, part);
+    return new MTetrahedronN(vAll, nPts + 1, num, part);
+  case TYPE_HEX:
     if(nPts == 1) {
-      return new MPrism15(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                          p->getVertex(3), p->getVertex(4), p->getVertex(5),
-                          v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
-                          0, p->getPartition());
-    }
-    else {
-      return new MPrismN(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                         p->getVertex(3), p->getVertex(4), p->getVertex(5), v,
-                         nPts + 1, 0, p->getPartition());
+      if(incomplete) return new MHexahedron20(vAll, num, part);
+      return new MHexahedron27(vAll, num, part);
     }
-  }
-  else {
-    getFaceVertices(gr, p, v, faceVertices, nPts);
+    return new MHexahedronN(vAll, nPts + 1, num, part);
+  case TYPE_PRI:
     if(nPts == 1) {
-      return new MPrism18(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                          p->getVertex(3), p->getVertex(4), p->getVertex(5),
-                          v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
-                          v[9], v[10], v[11], 0, p->getPartition());
-    }
-    else {
-      getVolumeVertices(gr, p, v, nPts);
-      return new MPrismN(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                         p->getVertex(3), p->getVertex(4), p->getVertex(5), v,
-                         nPts + 1, 0, p->getPartition());
+      if(incomplete) return new MPrism15(vAll, num, part);
+      return new MPrism18(vAll, num, part);
     }
+    return new MPrismN(vAll, nPts + 1, num, part);
+  case TYPE_PYR: return new MPyramidN(vAll, nPts + 1, num, part);
+  default: return nullptr;
   }
 }
 
-static MPyramid *setHighOrder(MPyramid *p, GRegion *gr,
-                              edgeContainer &edgeVertices,
-                              faceContainer &faceVertices, bool incomplete,
-                              int nPts)
+// prefix sum of the number of vertices to create for the elements of each
+// block of the given size
+template <class F>
+static std::size_t countPerBlock(std::size_t numElements, std::size_t blockSize,
+                                 int nthreads, std::vector<std::size_t> &offsets,
+                                 F count)
 {
-  std::vector<MVertex *> v;
-  getEdgeVertices(gr, p, v, edgeVertices, nPts);
-  if(!incomplete) {
-    getFaceVertices(gr, p, v, faceVertices, nPts);
-    if(nPts > 1) { getVolumeVertices(gr, p, v, nPts); }
-  }
-  return new MPyramidN(p->getVertex(0), p->getVertex(1), p->getVertex(2),
-                       p->getVertex(3), p->getVertex(4), v, nPts + 1, 0,
-                       p->getPartition());
+  const std::size_t numBlocks = (numElements + blockSize - 1) / blockSize;
+  offsets.assign(numBlocks + 1, 0);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(std::size_t b = 0; b < numBlocks; b++) {
+    std::size_t n = 0;
+    for(std::size_t i = b * blockSize;
+        i < std::min((b + 1) * blockSize, numElements); i++)
+      n += count(i);
+    offsets[b + 1] = n;
+  }
+  for(std::size_t b = 0; b < numBlocks; b++) offsets[b + 1] += offsets[b];
+  return offsets[numBlocks];
 }
 
-static void setHighOrder(GRegion *gr, edgeContainer &edgeVertices,
+static void setHighOrder(GModel *m, std::vector<GRegion *> &regions,
+                         edgeContainer &edgeVertices,
                          faceContainer &faceVertices, bool incomplete,
                          int nPts = 1)
 {
-  std::vector<MTetrahedron *> tetrahedra2;
-  for(std::size_t i = 0; i < gr->tetrahedra.size(); i++) {
-    MTetrahedron *t = gr->tetrahedra[i];
-    MTetrahedron *tNew =
-      setHighOrder(t, gr, edgeVertices, faceVertices, incomplete, nPts);
-    tetrahedra2.push_back(tNew);
-    delete t;
+  volumeHighOrderData data(nPts, incomplete, edgeVertices, faceVertices);
+  for(std::size_t i = 0; i < regions.size(); i++) {
+    GRegion *gr = regions[i];
+    data.elements.insert(data.elements.end(), gr->tetrahedra.begin(),
+                         gr->tetrahedra.end());
+    data.elements.insert(data.elements.end(), gr->hexahedra.begin(),
+                         gr->hexahedra.end());
+    data.elements.insert(data.elements.end(), gr->prisms.begin(),
+                         gr->prisms.end());
+    data.elements.insert(data.elements.end(), gr->pyramids.begin(),
+                         gr->pyramids.end());
+    data.regions.resize(data.elements.size(), gr);
+  }
+  const std::size_t numElements = data.elements.size();
+  if(!numElements) return;
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  const std::size_t numParts = nthreads;
+  data.edgeMaps.resize(numParts);
+  data.faceMaps.resize(numParts);
+
+  // initialize the (lazily created) interpolation data before the parallel
+  // loops, including the function spaces of the (possibly curved) edges of the
+  // elements
+  std::set<int> orders;
+  orders.insert(nPts + 1);
+  for(std::size_t i = 0; i < numElements; i++)
+    orders.insert(data.elements[i]->getPolynomialOrder());
+  for(auto o : orders)
+    BasisFactory::getNodalBasis(ElementType::getType(TYPE_LIN, o));
+  const int types[6] = {TYPE_TRI, TYPE_QUA, TYPE_TET,
+                        TYPE_HEX, TYPE_PRI, TYPE_PYR};
+  for(int i = 0; i < 6; i++) getInnerVertexPlacement(types[i], nPts + 1);
+
+  // flags of the edges and faces of each element that are the first
+  // occurrence of an edge/face without high-order vertices
+  std::vector<unsigned short> newEdges(numElements, 0);
+  std::vector<unsigned char> newFaces(numElements, 0);
+
+  // find the new edges
+#pragma omp parallel num_threads(nthreads)
+  {
+    const std::size_t t = Msg::GetThreadNum(), nt = Msg::GetNumThreads();
+    for(std::size_t i = 0; i < numElements; i++) {
+      MElement *e = data.elements[i];
+      for(int j = 0; j < e->getNumEdges(); j++) {
+        bool increasing;
+        edgeKey p = getEdgeKey(e, j, increasing);
+        const std::size_t part = data.partition(p);
+        if(part % nt != t || edgeVertices.count(p)) continue;
+        if(data.edgeMaps[part].insert(std::make_pair(p, 0)).second) {
+#pragma omp atomic update
+          newEdges[i] |= (unsigned short)(1 << j);
+        }
+      }
+    }
+  }
+
+  // create the vertices on the new edges
+  const std::size_t blockSize = 1024;
+  std::vector<std::size_t> offsets;
+  const std::size_t numNewEdges =
+    countPerBlock(numElements, blockSize, nthreads, offsets, [&](std::size_t i) {
+      std::size_t n = 0;
+      for(unsigned short f = newEdges[i]; f; f >>= 1) n += f & 1;
+      return n;
+    });
+  std::size_t firstNum = m->getMaxVertexNumber() + 1;
+  m->setMaxVertexNumber(firstNum - 1 + numNewEdges * nPts);
+  data.newEdgeVertices.resize(numNewEdges * nPts);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t b = 0; b < offsets.size() - 1; b++) {
+    std::size_t index = offsets[b] * nPts;
+    for(std::size_t i = b * blockSize;
+        i < std::min((b + 1) * blockSize, numElements); i++) {
+      MElement *e = data.elements[i];
+      for(int j = 0; j < e->getNumEdges(); j++) {
+        if(!(newEdges[i] & (1 << j))) continue;
+        bool increasing;
+        edgeKey p = getEdgeKey(e, j, increasing);
+        data.edgeMaps[data.partition(p)][p] = index;
+        std::vector<MVertex *> veOld, veEdge;
+        e->getEdgeVertices(j, veOld);
+        const MLineN edgeEl(veOld, e->getPolynomialOrder());
+        interpVerticesInExistingEdge(data.regions[i], &edgeEl, veEdge, nPts,
+                                     firstNum + index);
+        if(increasing)
+          std::copy(veEdge.begin(), veEdge.end(),
+                    data.newEdgeVertices.begin() + index);
+        else
+          std::copy(veEdge.rbegin(), veEdge.rend(),
+                    data.newEdgeVertices.begin() + index);
+        index += nPts;
+      }
+    }
   }
-  gr->tetrahedra = tetrahedra2;
 
-  std::vector<MHexahedron *> hexahedra2;
-  for(std::size_t i = 0; i < gr->hexahedra.size(); i++) {
-    MHexahedron *h = gr->hexahedra[i];
-    MHexahedron *hNew =
-      setHighOrder(h, gr, edgeVertices, faceVertices, incomplete, nPts);
-    hexahedra2.push_back(hNew);
-    delete h;
+  // find the new faces
+#pragma omp parallel num_threads(nthreads)
+  {
+    const std::size_t t = Msg::GetThreadNum(), nt = Msg::GetNumThreads();
+    for(std::size_t i = 0; i < numElements; i++) {
+      MElement *e = data.elements[i];
+      if(!data.hasFaceVertices(e)) continue;
+      for(int j = 0; j < e->getNumFaces(); j++) {
+        MFace face = e->getFace(j);
+        const std::size_t part = data.partition(face);
+        if(part % nt != t || !data.numFaceVertices(face) ||
+           faceVertices.count(face))
+          continue;
+        if(data.faceMaps[part].insert(std::make_pair(face, 0)).second) {
+#pragma omp atomic update
+          newFaces[i] |= (unsigned char)(1 << j);
+        }
+      }
+    }
   }
-  gr->hexahedra = hexahedra2;
 
-  std::vector<MPrism *> prisms2;
-  for(std::size_t i = 0; i < gr->prisms.size(); i++) {
-    MPrism *p = gr->prisms[i];
-    MPrism *pNew =
-      setHighOrder(p, gr, edgeVertices, faceVertices, incomplete, nPts);
-    prisms2.push_back(pNew);
-    delete p;
+  // create the vertices on the new faces, by interpolation of the vertices on
+  // their boundary
+  const std::size_t numNewFaceVertices =
+    countPerBlock(numElements, blockSize, nthreads, offsets, [&](std::size_t i) {
+      std::size_t n = 0;
+      MElement *e = data.elements[i];
+      for(int j = 0; j < e->getNumFaces(); j++)
+        if(newFaces[i] & (1 << j)) n += data.numFaceVertices(e->getFace(j));
+      return n;
+    });
+  firstNum = m->getMaxVertexNumber() + 1;
+  m->setMaxVertexNumber(firstNum - 1 + numNewFaceVertices);
+  data.newFaceVertices.resize(numNewFaceVertices);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t b = 0; b < offsets.size() - 1; b++) {
+    std::size_t index = offsets[b];
+    for(std::size_t i = b * blockSize;
+        i < std::min((b + 1) * blockSize, numElements); i++) {
+      if(!newFaces[i]) continue;
+      MElement *e = data.elements[i];
+      std::vector<MVertex *> vCorner, vEdges;
+      e->getVertices(vCorner);
+      getEdgeVertices(data, e, vEdges);
+      for(int j = 0; j < e->getNumFaces(); j++) {
+        if(!(newFaces[i] & (1 << j))) continue;
+        MFace face = e->getFace(j);
+        std::vector<MVertex *> faceBoundaryVertices, vFace;
+        int type = retrieveFaceBoundaryVertices(j, e->getType(), nPts, vCorner,
+                                                vEdges, faceBoundaryVertices);
+        interpVerticesInExistingFace(data.regions[i],
+                                     *getInnerVertexPlacement(type, nPts + 1),
+                                     faceBoundaryVertices, vFace,
+                                     firstNum + index);
+        data.faceMaps[data.partition(face)][face] = index;
+        for(std::size_t k = 0; k < vFace.size(); k++)
+          data.newFaceVertices[index++] = vFace[k];
+      }
+    }
   }
-  gr->prisms = prisms2;
 
-  std::vector<MPyramid *> pyramids2;
-  for(std::size_t i = 0; i < gr->pyramids.size(); i++) {
-    MPyramid *p = gr->pyramids[i];
-    MPyramid *pNew =
-      setHighOrder(p, gr, edgeVertices, faceVertices, incomplete, nPts);
-    pyramids2.push_back(pNew);
-    delete p;
+  // create the high-order elements, with their interior vertices
+  const std::size_t numVolumeVertices =
+    countPerBlock(numElements, blockSize, nthreads, offsets, [&](std::size_t i) {
+      MElement *e = data.elements[i];
+      if(!data.hasVolumeVertices(e)) return 0;
+      return getInnerVertexPlacement(e->getType(), nPts + 1)->size1();
+    });
+  firstNum = m->getMaxVertexNumber() + 1;
+  m->setMaxVertexNumber(firstNum - 1 + numVolumeVertices);
+  const std::size_t firstElementNum = m->getMaxElementNumber() + 1;
+  m->setMaxElementNumber(firstElementNum - 1 + numElements);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t b = 0; b < offsets.size() - 1; b++) {
+    std::size_t index = offsets[b];
+    for(std::size_t i = b * blockSize;
+        i < std::min((b + 1) * blockSize, numElements); i++) {
+      MElement *e = data.elements[i];
+      std::vector<MVertex *> v;
+      getEdgeVertices(data, e, v);
+      if(data.hasFaceVertices(e)) getFaceVertices(data, e, v);
+      if(data.hasVolumeVertices(e)) {
+        std::size_t n = v.size();
+        getVolumeVertices(data.regions[i], e, v, firstNum + index, nPts);
+        index += v.size() - n;
+      }
+      data.elements[i] = createHighOrderElement(e, v, incomplete, nPts,
+                                                firstElementNum + i);
+      delete e;
+    }
   }
-  gr->pyramids = pyramids2;
 
-  gr->deleteVertexArrays();
+  std::size_t k = 0;
+  for(std::size_t i = 0; i < regions.size(); i++) {
+    GRegion *gr = regions[i];
+    for(std::size_t j = 0; j < gr->tetrahedra.size(); j++)
+      gr->tetrahedra[j] = (MTetrahedron *)data.elements[k++];
+    for(std::size_t j = 0; j < gr->hexahedra.size(); j++)
+      gr->hexahedra[j] = (MHexahedron *)data.elements[k++];
+    for(std::size_t j = 0; j < gr->prisms.size(); j++)
+      gr->prisms[j] = (MPrism *)data.elements[k++];
+    for(std::size_t j = 0; j < gr->pyramids.size(); j++)
+      gr->pyramids[j] = (MPyramid *)data.elements[k++];
+    gr->deleteVertexArrays();
+  }
 }
 
 // High-level functions
@@ -1459,14 +1648,16 @@ void SetOrderN(GModel *m, int order, bool linear, bool incomplete,
     if((*it)->getColumns() != nullptr) (*it)->getColumns()->clearElementData();
   }
 
+  // volumes are processed all together, in parallel
+  std::vector<GRegion *> regions;
   for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
     Msg::Info("Meshing volume %d order %d", (*it)->tag(), order);
     Msg::ProgressMeter(++counter, false, msg);
     if(onlyVisible && !(*it)->getVisibility()) continue;
-    if(getOrder(*it) != order)
-      setHighOrder(*it, edgeVertices, faceVertices, incomplete, nPts);
+    if(getOrder(*it) != order) regions.push_back(*it);
     if((*it)->getColumns() != nullptr) (*it)->getColumns()->clearElementData();
   }
+  setHighOrder(m, regions, edgeVertices, faceVertices, incomplete, nPts);
 
   // store nodes in entities
   m->pruneMeshVertexAssociations();
@@ -0,0 +1,209 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+// A priority queue of elements (MTri3, MTet4) sorted by decreasing "radius",
+// used by the Delaunay refinement algorithms to repeatedly get the worst
+// element. The elements are dispatched in buckets according to the binary
+// exponent (and the first bits of the mantissa) of their radius, and each
+// bucket is a binary heap stored in a contiguous array, ordered with the same
+// comparator (Compare(a, b) is true if a should be refined before b) as the
+// std::set it replaces: elements are thus popped in exactly the same order,
+// but without allocating a tree node per element.
+//
+// Each element stores its position in the queue (T::setQueuePosition(),
+// T::getQueueBucket() and T::getQueueIndex()), so that find() is O(1); an
+// element can thus only be stored in one queue at a time.
+//
+// The queue can be iterated over (in no particular order, except that begin()
+// is always the top element); erase() and the insertion of new elements
+// invalidate all iterators. Elements marked as deleted are not removed from the
+// queue by the meshing algorithms: they are discarded when they reach the top,
+// or in bulk with eraseIf().
+template <class T, class Compare> class bucketQueue {
+private:
+  // 4 buckets per power of 2, for radii between 2^-30 and 2^33, plus one
+  // bucket for null or negative radii
+  enum { minExp = -30, maxExp = 33, subBuckets = 4 };
+  enum { numBuckets = (maxExp - minExp) * subBuckets + 2 };
+  std::vector<std::vector<T *> > _buckets;
+  // all the buckets above _top are empty
+  int _top;
+  std::size_t _size;
+  Compare _comp;
+  static int _bucket(double r)
+  {
+    if(!(r > 0.)) return 0;
+    if(std::isinf(r)) return numBuckets - 1;
+    int e;
+    double m = std::frexp(r, &e); // r = m 2^e, with m in [0.5, 1[
+    if(e < minExp) return 1;
+    if(e >= maxExp) return numBuckets - 1;
+    int s = std::min((int)((m - 0.5) * 2 * subBuckets), subBuckets - 1);
+    return 1 + (e - minExp) * subBuckets + s;
+  }
+  void _place(std::vector<T *> &h, int b, std::size_t i, T *t)
+  {
+    h[i] = t;
+    t->setQueuePosition(b, i);
+  }
+  void _siftUp(int b, std::size_t i)
+  {
+    std::vector<T *> &h = _buckets[b];
+    T *t = h[i];
+    while(i > 0) {
+      std::size_t p = (i - 1) / 2;
+      if(!_comp(t, h[p])) break;
+      _place(h, b, i, h[p]);
+      i = p;
+    }
+    _place(h, b, i, t);
+  }
+  void _siftDown(int b, std::size_t i)
+  {
+    std::vector<T *> &h = _buckets[b];
+    T *t = h[i];
+    std::size_t n = h.size();
+    while(2 * i + 1 < n) {
+      std::size_t c = 2 * i + 1;
+      if(c + 1 < n && _comp(h[c + 1], h[c])) c++;
+      if(!_comp(h[c], t)) break;
+      _place(h, b, i, h[c]);
+      i = c;
+    }
+    _place(h, b, i, t);
+  }
+  void _lowerTop()
+  {
+    while(_top > 0 && _buckets[_top].empty()) _top--;
+  }
+
+public:
+  class iterator {
+    friend class bucketQueue;
+
+  private:
+    const bucketQueue *_q;
+    int _b;
+    std::size_t _i;
+
+  public:
+    iterator(const bucketQueue *q = nullptr, int b = -1, std::size_t i = 0)
+      : _q(q), _b(b), _i(i)
+    {
+    }
+    T *operator*() const { return _q->_buckets[_b][_i]; }
+    iterator &operator++()
+    {
+      if(++_i >= _q->_buckets[_b].size()) {
+        _i = 0;
+        do {
+          _b--;
+        } while(_b >= 0 && _q->_buckets[_b].empty());
+      }
+      return *this;
+    }
+    iterator operator++(int)
+    {
+      iterator it = *this;
+      ++(*this);
+      return it;
+    }
+    bool operator==(const iterator &other) const
+    {
+      return _b == other._b && _i == other._i;
+    }
+    bool operator!=(const iterator &other) const { return !(*this == other); }
+  };
+  typedef iterator const_iterator;
+
+  bucketQueue() : _buckets(numBuckets), _top(0), _size(0) {}
+  std::size_t size() const { return _size; }
+  bool empty() const { return !_size; }
+  iterator begin() const
+  {
+    if(!_size) return end();
+    return iterator(this, _top, 0);
+  }
+  iterator end() const { return iterator(this, -1, 0); }
+  void insert(T *t)
+  {
+    int b = _bucket(t->getRadius());
+    _buckets[b].push_back(t);
+    _siftUp(b, _buckets[b].size() - 1);
+    if(b > _top) _top = b;
+    _size++;
+  }
+  template <class ITER> void insert(ITER beg, ITER end)
+  {
+    for(ITER it = beg; it != end; ++it) insert(*it);
+  }
+  void erase(const iterator &it)
+  {
+    std::vector<T *> &h = _buckets[it._b];
+    std::size_t i = it._i;
+    h[i] = h.back();
+    h.pop_back();
+    _size--;
+    if(i < h.size()) {
+      _siftDown(it._b, i);
+      _siftUp(it._b, i);
+    }
+    if(h.empty()) _lowerTop();
+  }
+  // find an element, using the position it stores
+  iterator find(T *t) const
+  {
+    int b = t->getQueueBucket();
+    std::size_t i = t->getQueueIndex();
+    if(b < 0 || b >= numBuckets || i >= _buckets[b].size() ||
+       _buckets[b][i] != t)
+      return end();
+    return iterator(this, b, i);
+  }
+  // remove all the elements for which pred is true; pred is called exactly
+  // once for each element, and can thus free the elements it discards
+  template <class PRED> void eraseIf(PRED pred)
+  {
+    for(int b = 0; b <= _top; b++) {
+      std::vector<T *> &h = _buckets[b];
+      std::size_t n = 0;
+      for(std::size_t i = 0; i < h.size(); i++)
+        if(!pred(h[i])) h[n++] = h[i];
+      if(n == h.size()) continue;
+      _size -= h.size() - n;
+      h.resize(n);
+      for(std::size_t i = 0; i < n; i++) h[i]->setQueuePosition(b, i);
+      for(std::size_t i = n / 2; i-- > 0;) _siftDown(b, i);
+    }
+    _lowerTop();
+  }
+  // get all the elements, sorted in the order in which they would be popped
+  void getSorted(std::vector<T *> &v) const
+  {
+    v.clear();
+    v.reserve(_size);
+    for(int b = _top; b >= 0; b--) {
+      std::size_t n = v.size();
+      v.insert(v.end(), _buckets[b].begin(), _buckets[b].end());
+      std::sort(v.begin() + n, v.end(), _comp);
+    }
+  }
+  void clear()
+  {
+    for(int b = 0; b <= _top; b++) std::vector<T *>().swap(_buckets[b]);
+    _top = 0;
+    _size = 0;
+  }
+};
+
+#endif
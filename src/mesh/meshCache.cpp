@@ -0,0 +1,341 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include "meshCache.h"
+#include "meshSignature.h"
+#include "GmshMessage.h"
+#include "GModel.h"
+#include "GEdge.h"
+#include "GFace.h"
+#include "GRegion.h"
+#include "MVertex.h"
+#include "MElement.h"
+#include "Context.h"
+#include "OS.h"
+
+// Layout of a cache file (in native byte order):
+//
+//   magic (char[8]), dim (int), tag (int), signature (uint64)
+//   number of referenced entities (uint64), and for each one:
+//     dim (int), tag (int), number of nodes (uint64), hash of their coordinates
+//     (uint64)
+//   number of nodes (uint64), and for each node:
+//     kind (int: 0 = node, 1 = curve node, 2 = surface node), x, y, z (double),
+//     followed by u, lc (double) for curve nodes and u, v (double) for surface
+//     nodes
+//   number of elements (uint64), and for each element:
+//     MSH type (int), number of nodes (int), and for each node the index of
+//     the referenced entity it belongs to (int, -1 for the entity itself) and
+//     its index in the mesh_vertices of that entity (uint64)
+static const char MESH_CACHE_MAGIC[8] = {'G', 'M', 'S', 'H',
+                                        'C', 'A', 'C', '1'};
+
+template <class T> static void put(FILE *fp, const T &t)
+{
+  fwrite(&t, sizeof(T), 1, fp);
+}
+
+template <class T> static bool get(FILE *fp, T &t)
+{
+  return fread(&t, sizeof(T), 1, fp) == 1;
+}
+
+static uint64_t hashNodes(GEntity *ge)
+{
+  signatureHash h;
+  h.add(ge->mesh_vertices.size());
+  for(std::size_t i = 0; i < ge->mesh_vertices.size(); i++) {
+    MVertex *v = ge->mesh_vertices[i];
+    h.add(v->x());
+    h.add(v->y());
+    h.add(v->z());
+  }
+  return h.get();
+}
+
+meshCache::meshCache(GModel *m, const std::string &dir,
+                     const std::map<GEntity *, std::size_t> &signatures)
+  : _model(m), _dir(dir), _signatures(signatures), _hits(0), _misses(0),
+    _saved(0)
+{
+  if(_dir.size() && _dir[_dir.size() - 1] != '/') _dir += "/";
+  CreatePath(_dir);
+}
+
+std::string meshCache::_fileName(GEntity *ge, std::size_t signature) const
+{
+  std::ostringstream sstream;
+  sstream << _dir << ge->dim() << "-" << std::hex << std::setw(16)
+          << std::setfill('0') << signature << ".bin";
+  return sstream.str();
+}
+
+bool meshCache::cacheable(GEntity *ge)
+{
+  if(ge->dim() < 1 || ge->dim() > 3) return false;
+  auto it = _signatures.find(ge);
+  if(it == _signatures.end() || !it->second) return false;
+  if(ge->isFullyDiscrete() || ge->getMeshMaster() != ge) return false;
+  if(CTX::instance()->mesh.meshOnlyVisible && !ge->getVisibility())
+    return false;
+  if(ge->dim() == 1) {
+    GEdge *ed = ge->cast2Edge();
+    if(ed->meshAttributes.method == MESH_NONE) return false;
+  }
+  // the transfinite meshes of surfaces and volumes store additional data
+  else if(ge->dim() == 2) {
+    GFace *gf = ge->cast2Face();
+    if(gf->meshAttributes.method != MESH_UNSTRUCTURED) return false;
+  }
+  else {
+    GRegion *gr = ge->cast2Region();
+    if(gr->meshAttributes.method != MESH_UNSTRUCTURED) return false;
+  }
+  return true;
+}
+
+bool meshCache::load(GEntity *ge)
+{
+  if(!cacheable(ge)) return false;
+  if(CTX::instance()->mesh.meshOnlyEmpty && ge->getNumMeshElements())
+    return false;
+
+  std::size_t signature = _signatures[ge];
+  std::string fileName = _fileName(ge, signature);
+  FILE *fp = Fopen(fileName.c_str(), "rb");
+  if(!fp) {
+#pragma omp atomic
+    _misses++;
+    return false;
+  }
+
+  // read the file entirely before modifying the mesh
+  bool ok = true;
+  char magic[8];
+  int dim = -1, tag = -1;
+  uint64_t sig = 0, numRefs = 0, numNodes = 0, numElements = 0;
+  ok = fread(magic, sizeof(char), 8, fp) == 8 &&
+       !memcmp(magic, MESH_CACHE_MAGIC, 8) && get(fp, dim) && get(fp, tag) &&
+       get(fp, sig) && dim == ge->dim() && tag == ge->tag() &&
+       sig == signature && get(fp, numRefs);
+
+  // the nodes of the bounding entities must be those the mesh was generated
+  // with
+  std::vector<GEntity *> refs;
+  for(uint64_t i = 0; ok && i < numRefs; i++) {
+    int d, t;
+    uint64_t n, h;
+    ok = get(fp, d) && get(fp, t) && get(fp, n) && get(fp, h);
+    GEntity *ref = ok ? _model->getEntityByTag(d, t) : nullptr;
+    ok = ref && ref != ge && ref->mesh_vertices.size() == n &&
+         hashNodes(ref) == h;
+    refs.push_back(ref);
+  }
+
+  std::vector<int> kinds;
+  std::vector<double> coords;
+  if(ok) ok = get(fp, numNodes);
+  for(uint64_t i = 0; ok && i < numNodes; i++) {
+    int kind;
+    double x[5] = {0., 0., 0., 0., 0.};
+    ok = get(fp, kind) && kind >= 0 && kind <= 2 &&
+         fread(x, sizeof(double), kind ? 5 : 3, fp) == (kind ? 5u : 3u);
+    kinds.push_back(kind);
+    coords.insert(coords.end(), x, x + 5);
+  }
+
+  std::vector<int> types, sizes, ents;
+  std::vector<uint64_t> indices;
+  if(ok) ok = get(fp, numElements);
+  for(uint64_t i = 0; ok && i < numElements; i++) {
+    int type, n;
+    ok = get(fp, type) && get(fp, n) && n > 0;
+    types.push_back(type);
+    sizes.push_back(n);
+    for(int j = 0; ok && j < n; j++) {
+      int e;
+      uint64_t idx;
+      ok = get(fp, e) && get(fp, idx) && e >= -1 && e < (int)refs.size() &&
+           idx < (e < 0 ? numNodes : refs[e]->mesh_vertices.size());
+      ents.push_back(e);
+      indices.push_back(idx);
+    }
+  }
+  fclose(fp);
+
+  if(!ok) {
+    Msg::Debug("Ignoring invalid or outdated cached mesh '%s'",
+               fileName.c_str());
+#pragma omp atomic
+    _misses++;
+    return false;
+  }
+
+  // create the new mesh
+  std::vector<MVertex *> nodes(numNodes);
+  for(uint64_t i = 0; i < numNodes; i++) {
+    const double *x = &coords[5 * i];
+    if(kinds[i] == 1)
+      nodes[i] = new MEdgeVertex(x[0], x[1], x[2], ge, x[3], 0, x[4]);
+    else if(kinds[i] == 2)
+      nodes[i] = new MFaceVertex(x[0], x[1], x[2], ge, x[3], x[4]);
+    else
+      nodes[i] = new MVertex(x[0], x[1], x[2], ge);
+  }
+  MElementFactory factory;
+  std::vector<MElement *> elements(types.size());
+  std::size_t k = 0;
+  for(std::size_t i = 0; ok && i < types.size(); i++) {
+    std::vector<MVertex *> v(sizes[i]);
+    for(int j = 0; j < sizes[i]; j++, k++)
+      v[j] = ents[k] < 0 ? nodes[indices[k]] :
+                           refs[ents[k]]->mesh_vertices[indices[k]];
+    elements[i] = factory.create(types[i], v);
+    if(!elements[i]) ok = false;
+  }
+  if(!ok) {
+    Msg::Warning("Unknown element type in cached mesh '%s'", fileName.c_str());
+    for(std::size_t i = 0; i < elements.size(); i++) delete elements[i];
+    for(std::size_t i = 0; i < nodes.size(); i++) delete nodes[i];
+#pragma omp atomic
+    _misses++;
+    return false;
+  }
+  ge->deleteMesh();
+  ge->mesh_vertices = nodes;
+  for(std::size_t i = 0; i < elements.size(); i++)
+    ge->addElement(elements[i]->getType(), elements[i]);
+  if(ge->dim() == 1)
+    ge->cast2Edge()->meshStatistics.status = GEdge::DONE;
+  else if(ge->dim() == 2)
+    ge->cast2Face()->meshStatistics.status = GFace::DONE;
+
+  Msg::Debug("Loaded mesh of %s %d from cache '%s'",
+             ge->getTypeString().c_str(), ge->tag(), fileName.c_str());
+#pragma omp atomic
+  _hits++;
+  return true;
+}
+
+void meshCache::save(GEntity *ge)
+{
+  if(!cacheable(ge) || !ge->getNumMeshElements()) return;
+  if(ge->dim() == 1 &&
+     ge->cast2Edge()->meshStatistics.status != GEdge::DONE)
+    return;
+  if(ge->dim() == 2 &&
+     ge->cast2Face()->meshStatistics.status != GFace::DONE)
+    return;
+
+  // index the nodes of the entity and of the entities they refer to
+  std::map<GEntity *, int> refIndex;
+  std::vector<GEntity *> refs;
+  std::map<GEntity *, std::map<MVertex *, uint64_t> > nodeIndex;
+  auto indexNodes = [&](GEntity *e) {
+    std::map<MVertex *, uint64_t> &idx = nodeIndex[e];
+    for(std::size_t i = 0; i < e->mesh_vertices.size(); i++)
+      idx[e->mesh_vertices[i]] = i;
+  };
+  indexNodes(ge);
+  std::vector<int> ents;
+  std::vector<uint64_t> indices;
+  for(std::size_t i = 0; i < ge->getNumMeshElements(); i++) {
+    MElement *e = ge->getMeshElement(i);
+    for(std::size_t j = 0; j < e->getNumVertices(); j++) {
+      MVertex *v = e->getVertex(j);
+      GEntity *owner = v->onWhat();
+      if(!owner) return;
+      int r = -1;
+      if(owner != ge) {
+        auto it = refIndex.find(owner);
+        if(it == refIndex.end()) {
+          r = refIndex[owner] = refs.size();
+          refs.push_back(owner);
+          indexNodes(owner);
+        }
+        else
+          r = it->second;
+      }
+      auto it = nodeIndex[owner].find(v);
+      // node not owned by the entity it is classified on: cannot be cached
+      if(it == nodeIndex[owner].end()) return;
+      ents.push_back(r);
+      indices.push_back(it->second);
+    }
+  }
+
+  std::size_t signature = _signatures[ge];
+  std::string fileName = _fileName(ge, signature);
+  std::ostringstream tmp;
+  tmp << fileName << "." << GetProcessId() << ".tmp";
+  FILE *fp = Fopen(tmp.str().c_str(), "wb");
+  if(!fp) {
+    Msg::Warning("Could not open file '%s'", tmp.str().c_str());
+    return;
+  }
+  fwrite(MESH_CACHE_MAGIC, sizeof(char), 8, fp);
+  put(fp, ge->dim());
+  put(fp, ge->tag());
+  put(fp, (uint64_t)signature);
+  put(fp, (uint64_t)refs.size());
+  for(std::size_t i = 0; i < refs.size(); i++) {
+    put(fp, refs[i]->dim());
+    put(fp, refs[i]->tag());
+    put(fp, (uint64_t)refs[i]->mesh_vertices.size());
+    put(fp, hashNodes(refs[i]));
+  }
+  put(fp, (uint64_t)ge->mesh_vertices.size());
+  for(std::size_t i = 0; i < ge->mesh_vertices.size(); i++) {
+    MVertex *v = ge->mesh_vertices[i];
+    double x[5] = {v->x(), v->y(), v->z(), 0., 0.};
+    int kind = 0;
+    if(MEdgeVertex *ev = dynamic_cast<MEdgeVertex *>(v)) {
+      kind = 1;
+      ev->getParameter(0, x[3]);
+      x[4] = ev->getLc();
+    }
+    else if(dynamic_cast<MFaceVertex *>(v)) {
+      kind = 2;
+      v->getParameter(0, x[3]);
+      v->getParameter(1, x[4]);
+    }
+    put(fp, kind);
+    fwrite(x, sizeof(double), kind ? 5 : 3, fp);
+  }
+  put(fp, (uint64_t)ge->getNumMeshElements());
+  std::size_t k = 0;
+  for(std::size_t i = 0; i < ge->getNumMeshElements(); i++) {
+    MElement *e = ge->getMeshElement(i);
+    put(fp, e->getTypeForMSH());
+    put(fp, (int)e->getNumVertices());
+    for(std::size_t j = 0; j < e->getNumVertices(); j++, k++) {
+      put(fp, ents[k]);
+      put(fp, indices[k]);
+    }
+  }
+  bool ok = !ferror(fp);
+  fclose(fp);
+  // rename the complete file, so that concurrent sessions sharing the cache
+  // never read a partially written mesh
+  if(!ok || std::rename(tmp.str().c_str(), fileName.c_str())) {
+    UnlinkFile(tmp.str());
+    return;
+  }
+#pragma omp atomic
+  _saved++;
+}
+
+void meshCache::printStatistics() const
+{
+  if(!_hits && !_misses && !_saved) return;
+  Msg::Info("Mesh cache: %lu hit%s, %lu miss%s, %lu mesh%s saved", _hits,
+            _hits == 1 ? "" : "s", _misses, _misses == 1 ? "" : "es", _saved,
+            _saved == 1 ? "" : "es");
+}
@@ -0,0 +1,51 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstddef>
+#include <string>
+#include <map>
+
+class GModel;
+class GEntity;
+
+// A persistent cache of the meshes of the curves, surfaces and volumes of a
+// model, stored in a directory: the mesh of an entity is saved in a binary file
+// named after the signature of the entity (see meshSignature.h), and is reused
+// whenever an entity with the same signature is meshed again, in the same or in
+// another session. The nodes of the mesh that are classified on the boundary
+// of the entity are stored as references to the nodes of the bounding
+// entities, whose meshes are checked to be identical to those the cached mesh
+// was generated with.
+//
+// Loading and saving are thread-safe, as long as different threads handle
+// different entities.
+class meshCache {
+private:
+  GModel *_model;
+  std::string _dir;
+  std::map<GEntity *, std::size_t> _signatures;
+  std::size_t _hits, _misses, _saved;
+  std::string _fileName(GEntity *ge, std::size_t signature) const;
+
+public:
+  meshCache(GModel *m, const std::string &dir,
+            const std::map<GEntity *, std::size_t> &signatures);
+  // check if the mesh of the entity can be stored in the cache, i.e. if its
+  // signature is known and if its mesh only depends on its bounding entities
+  bool cacheable(GEntity *ge);
+  // replace the mesh of the entity by the cached one, if any; returns true on
+  // success (the mesh of the entity is left unchanged otherwise)
+  bool load(GEntity *ge);
+  // save the mesh of the entity in the cache, if it is complete
+  void save(GEntity *ge);
+  std::size_t getNumHits() const { return _hits; }
+  std::size_t getNumMisses() const { return _misses; }
+  void printStatistics() const;
+};
+
+#endif
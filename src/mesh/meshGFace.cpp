@@ -574,9 +574,9 @@ static void remeshUnrecoveredEdges(
               fabs(t1 - bb.low()) < fabs(t1 - bb.high()) ? bb.low() : bb.high();
 
           if(lc1 == -1)
-            lc1 = BGM_MeshSize(v1->onWhat(), 0, 0, v1->x(), v1->y(), v1->z());
+            lc1 = BGM_MeshSize(v1->onWhat(), 0, 0, v1);
           if(lc2 == -1)
-            lc2 = BGM_MeshSize(v2->onWhat(), 0, 0, v2->x(), v2->y(), v2->z());
+            lc2 = BGM_MeshSize(v2->onWhat(), 0, 0, v2);
           // should be better, i.e. equidistant
           double t = 0.5 * (t2 + t1);
           double lc = 0.5 * (lc1 + lc2);
@@ -674,9 +674,9 @@ remeshUnrecoveredEdges(std::map<MVertex *, BDS_Point *> &recoverMapInv,
               fabs(t1 - bb.low()) < fabs(t1 - bb.high()) ? bb.low() : bb.high();
 
           if(lc1 == -1)
-            lc1 = BGM_MeshSize(v1->onWhat(), 0, 0, v1->x(), v1->y(), v1->z());
+            lc1 = BGM_MeshSize(v1->onWhat(), 0, 0, v1);
           if(lc2 == -1)
-            lc2 = BGM_MeshSize(v2->onWhat(), 0, 0, v2->x(), v2->y(), v2->z());
+            lc2 = BGM_MeshSize(v2->onWhat(), 0, 0, v2);
           // should be better, i.e. equidistant
           double t = 0.5 * (t2 + t1);
           double lc = 0.5 * (lc1 + lc2);
@@ -1584,12 +1584,12 @@ static bool meshGenerator(GFace *gf, int RECUR_ITER,
         MVertex *here = itv->second;
         GEntity *ge = here->onWhat();
         if(ge->dim() == 0) {
-          pp->lcBGM() = BGM_MeshSize(ge, 0, 0, here->x(), here->y(), here->z());
+          pp->lcBGM() = BGM_MeshSize(ge, 0, 0, here);
         }
         else if(ge->dim() == 1) {
           double u;
           here->getParameter(0, u);
-          pp->lcBGM() = BGM_MeshSize(ge, u, 0, here->x(), here->y(), here->z());
+          pp->lcBGM() = BGM_MeshSize(ge, u, 0, here);
         }
         else
           pp->lcBGM() = MAX_LC;
@@ -2021,12 +2021,12 @@ static bool buildConsecutiveListOfVertices(
       V = param.y();
       pp = m->add_point(count + countTot, U, V, gf);
       if(ge->dim() == 0) {
-        pp->lcBGM() = BGM_MeshSize(ge, 0, 0, here->x(), here->y(), here->z());
+        pp->lcBGM() = BGM_MeshSize(ge, 0, 0, here);
       }
       else if(ge->dim() == 1) {
         double u;
         here->getParameter(0, u);
-        pp->lcBGM() = BGM_MeshSize(ge, u, 0, here->x(), here->y(), here->z());
+        pp->lcBGM() = BGM_MeshSize(ge, u, 0, here);
       }
       else {
         pp->lcBGM() = MAX_LC;
@@ -2215,7 +2215,7 @@ static bool meshGeneratorPeriodic(GFace *gf, int RECUR_ITER,
       BDS_Point *pp = m->add_point(++pNum, gp.u(), gp.v(), gf);
       m->add_geom(-(*itvx)->tag(), 0);
       pp->g = m->get_geom(-(*itvx)->tag(), 0);
-      pp->lcBGM() = BGM_MeshSize(*itvx, 0, 0, v->x(), v->y(), v->z());
+      pp->lcBGM() = BGM_MeshSize(*itvx, 0, 0, v);
       pp->lc() = pp->lcBGM();
       recoverMap[pp] = v;
       double XX = CTX::instance()->mesh.randFactor * LC2D * (double)rand() /
@@ -2290,11 +2290,11 @@ static bool meshGeneratorPeriodic(GFace *gf, int RECUR_ITER,
             pp->g = m->get_geom(-(*ite)->tag(), 1);
             if(v->onWhat()->dim() == 0)
               pp->lcBGM() =
-                BGM_MeshSize(v->onWhat(), 0, 0, v->x(), v->y(), v->z());
+                BGM_MeshSize(v->onWhat(), 0, 0, v);
             else {
               double uu;
               v->getParameter(0, uu);
-              pp->lcBGM() = BGM_MeshSize(*ite, uu, 0, v->x(), v->y(), v->z());
+              pp->lcBGM() = BGM_MeshSize(*ite, uu, 0, v);
             }
             pp->lc() = pp->lcBGM();
             recoverMap[pp] = v;
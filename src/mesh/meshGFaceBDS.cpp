@@ -176,6 +176,79 @@ static bool neighboringModified(BDS_Point *p)
   return false;
 }
 
+// Only large meshes of discrete surfaces (whose evaluation only involves
+// read-only lookups in their parametrization) are processed concurrently. The
+// smoothing pass on such meshes always moves the points color by color (see
+// smoothVertexPass), so that the result does not depend on the number of
+// threads
+static bool isConcurrentBDS(GFace *gf, BDS_Mesh &m)
+{
+  return gf->geomType() == GEntity::DiscreteSurface &&
+         m.points.size() >= 10000;
+}
+
+// Number of threads used for the passes on a single BDS mesh: surfaces that are
+// themselves meshed concurrently are processed by a single thread
+static int getNumThreadsBDS(GFace *gf, BDS_Mesh &m)
+{
+  if(!isConcurrentBDS(gf, m) || Msg::GetNumThreads() > 1) return 1;
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads2D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads2D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  return nthreads;
+}
+
+// Compute the adimensional length of the edges concurrently (no parallel region
+// is opened with a single thread, as the surface can itself be meshed in a
+// parallel region)
+static void computeEdgeLengths(GFace *gf, const std::vector<BDS_Edge *> &edges,
+                               std::vector<double> &lengths, int nthreads)
+{
+  lengths.resize(edges.size());
+  if(nthreads < 2) {
+    for(std::size_t i = 0; i < edges.size(); i++)
+      lengths[i] = NewGetLc(edges[i], gf);
+    return;
+  }
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
+  for(std::size_t i = 0; i < edges.size(); i++)
+    lengths[i] = NewGetLc(edges[i], gf);
+}
+
+// Greedy coloring of the points, in the order of their tags, so that adjacent
+// points have different colors: the points of each color can thus be moved
+// concurrently, as moving a point only modifies the point itself and reads its
+// neighbors. Points whose tag is not in [0, MAXPOINTNUMBER] are not colored,
+// and returned in uncolored.
+static void colorPoints(BDS_Mesh &m,
+                        std::vector<std::vector<BDS_Point *> > &colors,
+                        std::vector<BDS_Point *> &uncolored)
+{
+  colors.clear();
+  uncolored.clear();
+  std::vector<int> color(m.MAXPOINTNUMBER + 1, -1);
+  std::vector<char> used;
+  for(auto it = m.points.begin(); it != m.points.end(); ++it) {
+    BDS_Point *p = *it;
+    if(p->iD < 0 || p->iD > m.MAXPOINTNUMBER) {
+      uncolored.push_back(p);
+      continue;
+    }
+    used.assign(colors.size() + 1, 0);
+    for(std::size_t i = 0; i < p->edges.size(); i++) {
+      BDS_Point *o = p->edges[i]->othervertex(p);
+      if(o->iD >= 0 && o->iD <= m.MAXPOINTNUMBER && color[o->iD] >= 0)
+        used[color[o->iD]] = 1;
+    }
+    std::size_t c = 0;
+    while(used[c]) c++;
+    if(c == colors.size()) colors.resize(c + 1);
+    colors[c].push_back(p);
+    color[p->iD] = c;
+  }
+}
+
 static void swapEdgePass(GFace *gf, BDS_Mesh &m, int &nb_swap, double &t,
                          int FINALIZE = 0, double orientation = 1.0)
 {
@@ -430,25 +503,36 @@ static void splitEdgePass(GFace *gf, BDS_Mesh &m, double MAXE_, int &nb_split,
     }
   }
 
-  auto it = m.edges.begin();
-  while(it != m.edges.end()) {
+  int nthreads = getNumThreadsBDS(gf, m);
+
+  std::vector<BDS_Edge *> candidates;
+  for(auto it = m.edges.begin(); it != m.edges.end(); ++it) {
     if(!(*it)->deleted && (*it)->numfaces() == 2 && (*it)->g &&
-       (*it)->g->classif_degree == 2) {
-      double lone = NewGetLc(*it, gf);
-      if(lone > MAXE_) edges.push_back(std::make_pair(-lone, *it));
-    }
-    ++it;
+       (*it)->g->classif_degree == 2)
+      candidates.push_back(*it);
+  }
+  std::vector<double> lengths;
+  computeEdgeLengths(gf, candidates, lengths, nthreads);
+  for(std::size_t i = 0; i < candidates.size(); i++) {
+    if(lengths[i] > MAXE_)
+      edges.push_back(std::make_pair(-lengths[i], candidates[i]));
   }
 
   std::sort(edges.begin(), edges.end(), edges_sort);
 
-  std::vector<BDS_Point *> mids(edges.size());
+  // compute the new points concurrently (the mesh is not modified), then
+  // create them in order
+  struct newPoint {
+    bool ok;
+    double u, v, x, y, z, lcBGM;
+  };
+  std::vector<newPoint> newPoints(edges.size());
 
   bool faceDiscrete = gf->geomType() == GEntity::DiscreteSurface;
 
-  for(std::size_t i = 0; i < edges.size(); ++i) {
+  auto computeNewPoint = [&](std::size_t i) {
     BDS_Edge *e = edges[i].second;
-    BDS_Point *mid = nullptr;
+    newPoints[i].ok = false;
     if(!e->deleted &&
        (neighboringModified(e->p1) || neighboringModified(e->p2))) {
       double U1 = e->p1->u;
@@ -462,7 +546,7 @@ static void splitEdgePass(GFace *gf, BDS_Mesh &m, double MAXE_, int &nb_split,
       double U = 0.5 * (U1 + U2);
       double V = 0.5 * (V1 + V2);
       if(faceDiscrete)
-        if(!middlePoint(gf, e, U, V)) continue;
+        if(!middlePoint(gf, e, U, V)) return;
 
       GPoint gpp = gf->point(U, V);
       bool inside = true;
@@ -474,13 +558,35 @@ static void splitEdgePass(GFace *gf, BDS_Mesh &m, double MAXE_, int &nb_split,
         }
       }
       if(inside && gpp.succeeded()) {
-        mid = m.add_point(++m.MAXPOINTNUMBER, gpp.x(), gpp.y(), gpp.z());
-        mid->u = U;
-        mid->v = V;
-        mid->lc() = 0.5 * (e->p1->lc() + e->p2->lc());
-        mid->lcBGM() = BGM_MeshSize(gf, U, V, mid->X, mid->Y, mid->Z);
+        newPoint &np = newPoints[i];
+        np.ok = true;
+        np.u = U;
+        np.v = V;
+        np.x = gpp.x();
+        np.y = gpp.y();
+        np.z = gpp.z();
+        np.lcBGM = BGM_MeshSize(gf, U, V, np.x, np.y, np.z);
       }
     }
+  };
+  if(nthreads > 1) {
+#pragma omp parallel for schedule(dynamic, 64) num_threads(nthreads)
+    for(std::size_t i = 0; i < edges.size(); ++i) computeNewPoint(i);
+  }
+  else {
+    for(std::size_t i = 0; i < edges.size(); ++i) computeNewPoint(i);
+  }
+
+  std::vector<BDS_Point *> mids(edges.size(), nullptr);
+  for(std::size_t i = 0; i < edges.size(); ++i) {
+    const newPoint &np = newPoints[i];
+    if(!np.ok) continue;
+    BDS_Edge *e = edges[i].second;
+    BDS_Point *mid = m.add_point(++m.MAXPOINTNUMBER, np.x, np.y, np.z);
+    mid->u = np.u;
+    mid->v = np.v;
+    mid->lc() = 0.5 * (e->p1->lc() + e->p2->lc());
+    mid->lcBGM() = np.lcBGM;
     mids[i] = mid;
   }
 
@@ -534,14 +640,17 @@ void collapseEdgePass(GFace *gf, BDS_Mesh &m, double MINE_, int MAXNP,
 {
   double t1 = Cpu();
   std::vector<std::pair<double, BDS_Edge *> > edges;
-  auto it = m.edges.begin();
-  while(it != m.edges.end()) {
+  std::vector<BDS_Edge *> candidates;
+  for(auto it = m.edges.begin(); it != m.edges.end(); ++it) {
     if(!(*it)->deleted && (*it)->numfaces() == 2 && (*it)->g &&
-       (*it)->g->classif_degree == 2) {
-      double lone = NewGetLc(*it, gf);
-      if(lone < MINE_) edges.push_back(std::make_pair(lone, *it));
-    }
-    ++it;
+       (*it)->g->classif_degree == 2)
+      candidates.push_back(*it);
+  }
+  std::vector<double> lengths;
+  computeEdgeLengths(gf, candidates, lengths, getNumThreadsBDS(gf, m));
+  for(std::size_t i = 0; i < candidates.size(); i++) {
+    if(lengths[i] < MINE_)
+      edges.push_back(std::make_pair(lengths[i], candidates[i]));
   }
 
   std::sort(edges.begin(), edges.end(), edges_sort);
@@ -588,7 +697,41 @@ void smoothVertexPass(GFace *gf, BDS_Mesh &m, int &nb_smooth, bool q,
                       double threshold, double &t)
 {
   double t1 = Cpu();
-  for(int i = 0; i < 1; i++) {
+  if(isConcurrentBDS(gf, m)) {
+    // move the points of each color concurrently (or in sequence, with the
+    // same result, with a single thread)
+    int nthreads = getNumThreadsBDS(gf, m);
+    std::vector<std::vector<BDS_Point *> > colors;
+    std::vector<BDS_Point *> uncolored;
+    colorPoints(m, colors, uncolored);
+    for(std::size_t c = 0; c < colors.size(); c++) {
+      std::vector<BDS_Point *> &pts = colors[c];
+      int nb = 0;
+      if(nthreads > 1) {
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads) \
+  reduction(+ : nb)
+        for(std::size_t i = 0; i < pts.size(); i++) {
+          if(neighboringModified(pts[i])) {
+            if(m.smooth_point_centroid(pts[i], gf, threshold)) nb++;
+          }
+        }
+      }
+      else {
+        for(std::size_t i = 0; i < pts.size(); i++) {
+          if(neighboringModified(pts[i])) {
+            if(m.smooth_point_centroid(pts[i], gf, threshold)) nb++;
+          }
+        }
+      }
+      nb_smooth += nb;
+    }
+    for(std::size_t i = 0; i < uncolored.size(); i++) {
+      if(neighboringModified(uncolored[i])) {
+        if(m.smooth_point_centroid(uncolored[i], gf, threshold)) nb_smooth++;
+      }
+    }
+  }
+  else {
     auto itp = m.points.begin();
     while(itp != m.points.end()) {
       if(neighboringModified(*itp)) {
@@ -410,7 +410,7 @@ static void fourthPoint(double *p1, double *p2, double *p3, double *p4)
 
 MTri3::MTri3(MTriangle *t, double lc, SMetric3 *metric, bidimMeshData *data,
              GFace *gf)
-  : deleted(false), base(t)
+  : deleted(false), base(t), queueBucket(-1), queueIndex(0)
 {
   neigh[0] = neigh[1] = neigh[2] = nullptr;
   double center[3];
@@ -552,7 +552,7 @@ void connectTriangles(std::vector<MTri3 *> &l)
   connectTris(l.begin(), l.end(), conn);
 }
 
-void connectTriangles(std::set<MTri3 *, compareTri3Ptr> &l)
+void connectTriangles(bucketQueue<MTri3, compareTri3Ptr> &l)
 {
   std::vector<edgeXface> conn;
   connectTris(l.begin(), l.end(), conn);
@@ -684,7 +684,7 @@ inline double getSurfUV(MTriangle *t, bidimMeshData &data)
 static int insertVertexB(std::list<edgeXface> &shell,
                          std::list<MTri3 *> &cavity, bool force, GFace *gf,
                          MVertex *v, double *param, MTri3 *t,
-                         std::set<MTri3 *, compareTri3Ptr> &allTets,
+                         bucketQueue<MTri3, compareTri3Ptr> &allTets,
                          std::set<MTri3 *, compareTri3Ptr> *activeTets,
                          bidimMeshData &data, double *metric,
                          MTri3 **oneNewTriangle,
@@ -737,8 +737,8 @@ static int insertVertexB(std::list<edgeXface> &shell,
                    data.vSizesBGM[index2]);
     double LL = std::min(lc, lcBGM);
 
-    MTri3 *t4 = new MTri3(t, Extend1dMeshIn2dSurfaces(gf) ? LL : lcBGM, nullptr,
-                          &data, gf);
+    MTri3 *t4 = data.tri3Pool.create(
+      t, Extend1dMeshIn2dSurfaces(gf) ? LL : lcBGM, nullptr, &data, gf);
 
     if(oneNewTriangle) {
       force = true;
@@ -812,7 +812,7 @@ static int insertVertexB(std::list<edgeXface> &shell,
     // Us, Vs, false);
     for(std::size_t i = 0; i < shell.size(); i++) {
       delete newTris[i]->tri();
-      delete newTris[i];
+      data.tri3Pool.destroy(newTris[i]);
     }
     delete[] newTris;
 
@@ -872,7 +872,7 @@ static MTri3 *search4Triangle(MTri3 *t, MVertex *v, int maxx, int &ITER)
 }
 
 static MTri3 *search4Triangle(MTri3 *t, double pt[2], bidimMeshData &data,
-                              std::set<MTri3 *, compareTri3Ptr> &AllTris,
+                              bucketQueue<MTri3, compareTri3Ptr> &AllTris,
                               double uv[2], bool force = false)
 {
   // bool inside = t->inCircumCircle(pt);
@@ -920,9 +920,9 @@ static MTri3 *search4Triangle(MTri3 *t, double pt[2], bidimMeshData &data,
 }
 
 static bool
-insertAPoint(GFace *gf, std::set<MTri3 *, compareTri3Ptr>::iterator it,
+insertAPoint(GFace *gf, bucketQueue<MTri3, compareTri3Ptr>::iterator it,
              double center[2], double metric[3], bidimMeshData &data,
-             std::set<MTri3 *, compareTri3Ptr> &AllTris,
+             bucketQueue<MTri3, compareTri3Ptr> &AllTris,
              std::set<MTri3 *, compareTri3Ptr> *ActiveTris = nullptr,
              MTri3 *worst = nullptr, MTri3 **oneNewTriangle = nullptr,
              bool testStarShapeness = false)
@@ -1034,7 +1034,7 @@ void bowyerWatson(GFace *gf, int MAXPNT,
                   std::map<MVertex *, MVertex *> *equivalence,
                   std::map<MVertex *, SPoint2> *parametricCoordinates)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  bucketQueue<MTri3, compareTri3Ptr> AllTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
 
   if(!buildMeshGenerationDataStructures(gf, AllTris, DATA)) {
@@ -1053,7 +1053,7 @@ void bowyerWatson(GFace *gf, int MAXPNT,
     MTri3 *worst = *AllTris.begin();
     if(worst->isDeleted()) {
       delete worst->tri();
-      delete worst;
+      DATA.tri3Pool.destroy(worst);
       AllTris.erase(AllTris.begin());
       NBDELETED++;
     }
@@ -1290,7 +1290,7 @@ void bowyerWatsonFrontal(GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
                          std::map<MVertex *, SPoint2> *parametricCoordinates,
                          std::vector<SPoint2> *true_boundary)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  bucketQueue<MTri3, compareTri3Ptr> AllTris;
   std::set<MTri3 *, compareTri3Ptr> ActiveTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
   bool testStarShapeness = true;
@@ -1498,7 +1498,7 @@ void bowyerWatsonFrontalLayers(
   GFace *gf, bool quad, std::map<MVertex *, MVertex *> *equivalence,
   std::map<MVertex *, SPoint2> *parametricCoordinates)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  bucketQueue<MTri3, compareTri3Ptr> AllTris;
   std::set<MTri3 *, compareTri3Ptr> ActiveTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
 
@@ -1597,8 +1597,8 @@ void bowyerWatsonFrontalLayers(
       }
     }
     _front.clear();
-    it = ActiveTrisNotInFront.begin();
-    for(; it != ActiveTrisNotInFront.end(); ++it) {
+    for(auto it = ActiveTrisNotInFront.begin();
+        it != ActiveTrisNotInFront.end(); ++it) {
       if((*it)->getRadius() > LIMIT_ && isActive(*it, LIMIT_, active_edge)) {
         ActiveTris.insert(*it);
         updateActiveEdges(*it, LIMIT_, _front);
@@ -1622,7 +1622,7 @@ void bowyerWatsonParallelograms(
   GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
   std::map<MVertex *, SPoint2> *parametricCoordinates)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  bucketQueue<MTri3, compareTri3Ptr> AllTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
   std::vector<MVertex *> packed;
   std::vector<SMetric3> metrics;
@@ -1667,7 +1667,7 @@ void bowyerWatsonParallelograms(
     MTri3 *worst = *AllTris.begin();
     if(worst->isDeleted()) {
       delete worst->tri();
-      delete worst;
+      DATA.tri3Pool.destroy(worst);
       AllTris.erase(AllTris.begin());
     }
     else {
@@ -1686,15 +1686,11 @@ void bowyerWatsonParallelograms(
     }
 
     if(1.0 * AllTris.size() > 2.5 * DATA.vSizes.size()) {
-      auto itd = AllTris.begin();
-      while(itd != AllTris.end()) {
-        if((*itd)->isDeleted()) {
-          delete *itd;
-          AllTris.erase(itd++);
-        }
-        else
-          itd++;
-      }
+      AllTris.eraseIf([&DATA](MTri3 *t) {
+        if(!t->isDeleted()) return false;
+        DATA.tri3Pool.destroy(t);
+        return true;
+      });
     }
   }
 
@@ -1716,7 +1712,7 @@ void bowyerWatsonParallelogramsConstrained(
   Msg::Error("bowyerWatsonParallelogramsConstrained deprecated");
   return;
 
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  bucketQueue<MTri3, compareTri3Ptr> AllTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
   std::vector<MVertex *> packed;
   std::vector<SMetric3> metrics;
@@ -1740,7 +1736,7 @@ void bowyerWatsonParallelogramsConstrained(
     MTri3 *worst = *AllTris.begin();
     if(worst->isDeleted()) {
       delete worst->tri();
-      delete worst;
+      DATA.tri3Pool.destroy(worst);
       AllTris.erase(AllTris.begin());
     }
     else {
@@ -1759,15 +1755,11 @@ void bowyerWatsonParallelogramsConstrained(
     }
 
     if(1.0 * AllTris.size() > 2.5 * DATA.vSizes.size()) {
-      auto itd = AllTris.begin();
-      while(itd != AllTris.end()) {
-        if((*itd)->isDeleted()) {
-          delete *itd;
-          AllTris.erase(itd++);
-        }
-        else
-          itd++;
-      }
+      AllTris.eraseIf([&DATA](MTri3 *t) {
+        if(!t->isDeleted()) return false;
+        DATA.tri3Pool.destroy(t);
+        return true;
+      });
     }
   }
 
@@ -11,6 +11,8 @@
 #include "STensor3.h"
 #include "GEntity.h"
 #include "MFace.h"
+#include "bucketQueue.h"
+#include "objectPool.h"
 #include <list>
 #include <set>
 #include <map>
@@ -19,6 +21,7 @@ class GModel;
 class GFace;
 class BDS_Mesh;
 class BDS_Point;
+class MTri3;
 
 struct bidimMeshData {
   std::map<MVertex *, int> indices;
@@ -27,6 +30,7 @@ struct bidimMeshData {
   std::map<MVertex *, MVertex *> *equivalence;
   std::map<MVertex *, SPoint2> *parametricCoordinates;
   std::set<MEdge, MEdgeLessThan> internalEdges; // embedded edges
+  objectPool<MTri3> tri3Pool; // storage for the MTri3 of the face
   //  std::set<MVertex*> internalVertices; // embedded vertices
   inline void addVertex(MVertex *mv, double u, double v, double size,
                         double sizeBGM)
@@ -81,6 +85,9 @@ protected:
   double circum_radius;
   MTriangle *base;
   MTri3 *neigh[3];
+  // position in the bucketQueue storing the triangle
+  int queueBucket;
+  unsigned int queueIndex;
 
 public:
   /// 2 is euclidian norm, -1 is infinite norm  , 3 quality
@@ -88,6 +95,13 @@ public:
   bool isDeleted() const { return deleted; }
   void forceRadius(double r) { circum_radius = r; }
   inline double getRadius() const { return circum_radius; }
+  void setQueuePosition(int b, std::size_t i)
+  {
+    queueBucket = b;
+    queueIndex = i;
+  }
+  int getQueueBucket() const { return queueBucket; }
+  std::size_t getQueueIndex() const { return queueIndex; }
   inline MVertex *otherSide(int i)
   {
     MTri3 *n = neigh[i];
@@ -145,7 +159,7 @@ public:
 
 void connectTriangles(std::list<MTri3 *> &);
 void connectTriangles(std::vector<MTri3 *> &);
-void connectTriangles(std::set<MTri3 *, compareTri3Ptr> &AllTris);
+void connectTriangles(bucketQueue<MTri3, compareTri3Ptr> &AllTris);
 void bowyerWatson(
   GFace *gf, int MAXPNT = 1000000000,
   std::map<MVertex *, MVertex *> *equivalence = nullptr,
@@ -172,7 +172,7 @@ static void setLcs(MTriangle *t, std::map<MVertex *, double> &vSizes,
 }
 
 bool buildMeshGenerationDataStructures(
-  GFace *gf, std::set<MTri3 *, compareTri3Ptr> &AllTris, bidimMeshData &data)
+  GFace *gf, bucketQueue<MTri3, compareTri3Ptr> &AllTris, bidimMeshData &data)
 {
   std::map<MVertex *, double> vSizesMap;
 
@@ -243,8 +243,7 @@ bool buildMeshGenerationDataStructures(
     // Add size of background mesh to embedded vertices. For the other nodes,
     // use the size in vSizesMap
     const double lcBGM = (embeddedVertices.count(it->first) > 0) ?
-                           BGM_MeshSize(gf, param[0], param[1], it->first->x(),
-                                        it->first->y(), it->first->z()) :
+                           BGM_MeshSize(gf, param[0], param[1], it->first) :
                            it->second;
     data.addVertex(it->first, param[0], param[1], it->second, lcBGM);
   }
@@ -260,7 +259,8 @@ bool buildMeshGenerationDataStructures(
        data.vSizesBGM[data.getIndex(gf->triangles[i]->getVertex(2))]);
 
     double LL = Extend1dMeshIn2dSurfaces(gf) ? std::min(lc, lcBGM) : lcBGM;
-    AllTris.insert(new MTri3(gf->triangles[i], LL, nullptr, &data, gf));
+    AllTris.insert(
+      data.tri3Pool.create(gf->triangles[i], LL, nullptr, &data, gf));
   }
   gf->triangles.clear();
   connectTriangles(AllTris);
@@ -346,18 +346,20 @@ void splitEquivalentTriangles(GFace *gf, bidimMeshData &data)
 }
 
 void transferDataStructure(GFace *gf,
-                           std::set<MTri3 *, compareTri3Ptr> &AllTris,
+                           bucketQueue<MTri3, compareTri3Ptr> &AllTris,
                            bidimMeshData &data)
 {
-  while(1) {
-    if(AllTris.begin() == AllTris.end()) break;
-    MTri3 *worst = *AllTris.begin();
+  // keep the triangles in the order of the queue (sorted by decreasing radius);
+  // the MTri3 themselves are released with the pool
+  std::vector<MTri3 *> sorted;
+  AllTris.getSorted(sorted);
+  AllTris.clear();
+  for(std::size_t i = 0; i < sorted.size(); i++) {
+    MTri3 *worst = sorted[i];
     if(worst->isDeleted())
       delete worst->tri();
     else
       gf->triangles.push_back(worst->tri());
-    delete worst;
-    AllTris.erase(AllTris.begin());
   }
 
   // make sure all the triangles are oriented in the same way in
@@ -59,9 +59,9 @@ void buildEdgeToElements(std::vector<MElement *> &tris, e2t_cont &adj);
 void laplaceSmoothing(GFace *gf, int niter = 1, bool infinity_norm = false);
 
 bool buildMeshGenerationDataStructures(
-  GFace *gf, std::set<MTri3 *, compareTri3Ptr> &AllTris, bidimMeshData &data);
+  GFace *gf, bucketQueue<MTri3, compareTri3Ptr> &AllTris, bidimMeshData &data);
 void transferDataStructure(GFace *gf,
-                           std::set<MTri3 *, compareTri3Ptr> &AllTris,
+                           bucketQueue<MTri3, compareTri3Ptr> &AllTris,
                            bidimMeshData &DATA);
 void computeEquivalences(GFace *gf, bidimMeshData &DATA);
 void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
@@ -22,6 +22,8 @@
 #include "MEdge.h"
 #include "MLine.h"
 #include "ExtrudeParams.h"
+#include "HilbertCurve.h"
+#include "SBoundingBox3d.h"
 
 int MTet4::radiusNorm = 2;
 
@@ -326,7 +328,8 @@ static void removeFromCavity(std::vector<faceXtet> &shell,
 }
 
 static void extendCavity(std::vector<faceXtet> &shell,
-                         std::vector<MTet4 *> &cavity, faceXtet &toExtend)
+                         std::vector<MTet4 *> &cavity, faceXtet &toExtend,
+                         bool mark = true)
 {
   MTet4 *t = toExtend.t1;
   MTet4 *opposite = t->getNeigh(toExtend.i1);
@@ -339,7 +342,7 @@ static void extendCavity(std::vector<faceXtet> &shell,
       shell.erase(it);
   }
   cavity.push_back(opposite);
-  opposite->setDeleted(true);
+  if(mark) opposite->setDeleted(true);
 }
 
 // if all faces of the tet that are not in the shell see v, then it is ok
@@ -364,8 +367,12 @@ static bool verifyShell(MVertex *v, MTet4 *t, std::vector<faceXtet> &shell)
   return (NBAD_AFTER < NBAD_BEFORE);
 }
 
+// returns 0 if the cavity is star shaped, 1 if it has been corrected and -1 if
+// it cannot be corrected; if part >= 0, -2 is returned if the correction would
+// extend the cavity to another subdomain
 int makeCavityStarShaped(std::vector<faceXtet> &shell,
-                         std::vector<MTet4 *> &cavity, MVertex *v)
+                         std::vector<MTet4 *> &cavity, MVertex *v,
+                         bool mark = true, int part = -1)
 {
   std::vector<faceXtet> wrong;
   for(auto it = shell.begin(); it != shell.end(); ++it) {
@@ -380,10 +387,13 @@ int makeCavityStarShaped(std::vector<faceXtet> &shell,
   while(!wrong.empty()) {
     faceXtet &fxt = *(wrong.begin());
     if(std::find(shell.begin(), shell.end(), fxt) != shell.end()) {
+      if(part >= 0 && fxt.t1->getNeigh(fxt.i1) &&
+         fxt.t1->getNeigh(fxt.i1)->getPartition() != part)
+        return -2;
       if(fxt.t1->getNeigh(fxt.i1) &&
          fxt.t1->getNeigh(fxt.i1)->onWhat() == fxt.t1->onWhat() &&
          verifyShell(v, fxt.t1->getNeigh(fxt.i1), shell)) {
-        extendCavity(shell, cavity, fxt);
+        extendCavity(shell, cavity, fxt, mark);
       }
       else if(verifyShell(v, fxt.t1, shell)) {
         return -1;
@@ -431,6 +441,36 @@ void findCavity(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
   }
 }
 
+// same as findCavity, but without marking the tets of the cavity as deleted,
+// so that the cavities of several vertices can be computed concurrently; if
+// part >= 0, the search stops (and false is returned) as soon as a tet of the
+// cavity is adjacent to a tet of another subdomain
+static bool findCavityNoMark(std::vector<faceXtet> &shell,
+                             std::vector<MTet4 *> &cavity, MVertex *v, MTet4 *t,
+                             int part = -1)
+{
+  cavity.push_back(t);
+  for(std::size_t k = 0; k < cavity.size(); k++) {
+    MTet4 *const c = cavity[k];
+    for(int i = 0; i < 4; i++) {
+      MTet4 *const neighbour = c->getNeigh(i);
+      if(!neighbour) { shell.push_back(faceXtet(c, i)); }
+      else if(part >= 0 && neighbour->getPartition() != part) {
+        return false;
+      }
+      else if(!neighbour->isDeleted() &&
+              std::find(cavity.begin(), cavity.end(), neighbour) ==
+                cavity.end()) {
+        if(neighbour->inCircumSphere(v) && neighbour->onWhat() == c->onWhat())
+          cavity.push_back(neighbour);
+        else
+          shell.push_back(faceXtet(c, i));
+      }
+    }
+  }
+  return true;
+}
+
 #ifdef PRINT_TETS
 
 static void printTets(const char *fn, std::list<MTet4 *> &cavity,
@@ -460,7 +500,7 @@ bool insertVertexB(std::vector<faceXtet> &shell, std::vector<MTet4 *> &cavity,
                    MVertex *v, double lc1, double lc2,
                    std::vector<double> &vSizes, std::vector<double> &vSizesBGM,
                    MTet4 *t, MTet4Factory &myFactory,
-                   std::set<MTet4 *, compareTet4Ptr> &allTets,
+                   MTet4Factory::container &allTets,
                    const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
 {
   std::vector<MTet4 *> new_cavity;
@@ -1123,18 +1163,14 @@ double tetcircumcenter(double a[3], double b[3], double c[3], double d[3],
 }
 
 static void memoryCleanup(MTet4Factory &myFactory,
-                          std::set<MTet4 *, compareTet4Ptr> &allTets)
+                          MTet4Factory::container &allTets)
 {
   // int n1 = allTets.size();
-  auto itd = allTets.begin();
-  while(itd != allTets.end()) {
-    if((*itd)->isDeleted()) {
-      myFactory.Free((*itd));
-      allTets.erase(itd++);
-    }
-    else
-      itd++;
-  }
+  allTets.eraseIf([&myFactory](MTet4 *t) {
+    if(!t->isDeleted()) return false;
+    myFactory.Free(t);
+    return true;
+  });
   // Msg::Info("Cleaning up memory %d -> %d", n1, allTets.size());
 }
 
@@ -1210,6 +1246,533 @@ static void _deleteUnusedVertices(GRegion *gr)
                            allverts.end());
 }
 
+// a candidate vertex for the concurrent refinement: the circumcenter of a bad
+// tet, with its Delaunay cavity
+struct refinementCandidate {
+  MTet4 *worst, *container;
+  MVertex *v;
+  double uvw[3], lc1, lc2;
+  std::vector<faceXtet> shell;
+  std::vector<MTet4 *> cavity;
+  // 0: can be inserted, 1: not found in the mesh, 2: cannot be inserted, 3:
+  // the cavity reaches another subdomain
+  int status;
+  bool corrected;
+  std::size_t firstTetNum;
+  std::vector<MTet4 *> newTets;
+};
+
+// compute the cavity of a candidate vertex, without modifying the mesh; if
+// part >= 0, only cavities that are strictly inside the subdomain part are
+// accepted
+static void
+computeCandidateCavity(refinementCandidate &c, std::vector<double> &vSizes,
+                       edgeContainerB &allEmbeddedEdges,
+                       const std::set<MFace, MFaceLessThan> &allEmbeddedFaces,
+                       int part = -1)
+{
+  MVertex *v = c.v;
+  double center[3] = {v->x(), v->y(), v->z()};
+  c.status = 1;
+  c.corrected = false;
+  c.container = nullptr;
+  if(!findCavityNoMark(c.shell, c.cavity, v, c.worst, part)) {
+    c.status = 3;
+    return;
+  }
+  for(auto itc = c.cavity.begin(); itc != c.cavity.end(); ++itc) {
+    (*itc)->tet()->xyz2uvw(center, c.uvw);
+    if((*itc)->tet()->isInside(c.uvw[0], c.uvw[1], c.uvw[2])) {
+      c.container = *itc;
+      break;
+    }
+  }
+  if(!c.container) return;
+  c.status = 2;
+  if(!isCavityCompatibleWithEmbeddedEdges(c.cavity, c.shell,
+                                          allEmbeddedEdges) ||
+     !isCavityCompatibleWithEmbeddedFace(c.cavity, c.shell, allEmbeddedFaces))
+    return;
+  v->setEntity(c.container->onWhat());
+  bool starShaped = true;
+  while(1) {
+    int r = makeCavityStarShaped(c.shell, c.cavity, v, false, part);
+    if(r == -2) {
+      c.status = 3;
+      return;
+    }
+    else if(r == -1) {
+      starShaped = false;
+      break;
+    }
+    else if(r == 0)
+      break;
+    else if(r == 1)
+      c.corrected = true;
+  }
+  if(!starShaped) return;
+  if(part >= 0 && c.corrected) {
+    // the tets added by the correction can be adjacent to another subdomain
+    for(std::size_t j = 0; j < c.cavity.size(); j++) {
+      for(int i = 0; i < 4; i++) {
+        MTet4 *o = c.cavity[j]->getNeigh(i);
+        if(o && o->getPartition() != part) {
+          c.status = 3;
+          return;
+        }
+      }
+    }
+  }
+  if(c.corrected &&
+     (!isCavityCompatibleWithEmbeddedEdges(c.cavity, c.shell,
+                                           allEmbeddedEdges) ||
+      !isCavityCompatibleWithEmbeddedFace(c.cavity, c.shell, allEmbeddedFaces)))
+    return;
+  MTetrahedron *base = c.container->tet();
+  c.lc1 = (1 - c.uvw[0] - c.uvw[1] - c.uvw[2]) *
+            vSizes[base->getVertex(0)->getIndex()] +
+          c.uvw[0] * vSizes[base->getVertex(1)->getIndex()] +
+          c.uvw[1] * vSizes[base->getVertex(2)->getIndex()] +
+          c.uvw[2] * vSizes[base->getVertex(3)->getIndex()];
+  c.lc2 = BGM_MeshSize(c.container->onWhat(), 0, 0, center[0], center[1],
+                       center[2]);
+  double const lc = Extend2dMeshIn3dVolumes() ? std::min(c.lc1, c.lc2) : c.lc2;
+  for(auto its = c.shell.begin(); its != c.shell.end(); ++its) {
+    if(distance(its->v[0], v) < lc * .05 ||
+       distance(its->v[1], v) < lc * .05 ||
+       distance(its->v[2], v) < lc * .05)
+      return;
+  }
+  c.status = 0;
+}
+
+// replace the cavity of an accepted candidate by the tets connecting its
+// vertex to the shell; the new tets are numbered from c.firstTetNum (or
+// automatically if c.firstTetNum is 0) and are put in the subdomain part
+static void
+insertCandidate(refinementCandidate &c, MTet4Factory &myFactory,
+                std::vector<double> &vSizes, std::vector<double> &vSizesBGM,
+                const std::set<MFace, MFaceLessThan> &allEmbeddedFaces,
+                int part = 0)
+{
+  for(auto itc = c.cavity.begin(); itc != c.cavity.end(); ++itc)
+    (*itc)->setDeleted(true);
+  std::vector<MTet4 *> new_cavity;
+  new_cavity.reserve(2 * c.shell.size());
+  std::size_t num = c.firstTetNum;
+  for(auto its = c.shell.begin(); its != c.shell.end(); ++its) {
+    MTetrahedron *tr =
+      new MTetrahedron(its->getVertex(0), its->getVertex(1), its->getVertex(2),
+                       c.v, num ? (int)num++ : 0);
+    MTet4 *t4 = myFactory.Create(tr, vSizes, vSizesBGM, c.lc1, c.lc2);
+    t4->setOnWhat(c.container->onWhat());
+    t4->setPartition(part);
+    c.newTets.push_back(t4);
+    new_cavity.push_back(t4);
+    MTet4 *otherSide = its->t1->getNeigh(its->i1);
+    if(otherSide) new_cavity.push_back(otherSide);
+  }
+  if(allEmbeddedFaces.empty()) {
+    std::vector<faceXtet> conn;
+    connectTets_vector2(new_cavity, conn);
+  }
+  else {
+    connectTets(new_cavity.begin(), new_cavity.end(), &allEmbeddedFaces);
+  }
+}
+
+// number of candidate vertices in each round of the concurrent refinement
+// (independent of the number of threads, so that the mesh is too)
+static const std::size_t REFINEMENT_BATCH_SIZE = 2048;
+
+// Concurrent version of the main loop of insertVerticesInRegion: in each
+// round, the circumcenters of the worst tets are sorted along a Hilbert curve,
+// so that each thread handles a compact region of the mesh, and their
+// cavities are computed concurrently (without modifying the mesh). The
+// cavities are then locked in the order of decreasing tet radius: a cavity is
+// only accepted if none of its tets (nor their neighbors) belongs to a cavity
+// accepted before, as in delaunayTrgl. The vertices of accepted cavities are
+// finally inserted concurrently; the other candidates are processed in the
+// next rounds. The resulting mesh does not depend on the number of threads,
+// but differs from the one of the serial main loop (see
+// Mesh.ConcurrentRefinement3D).
+static void
+insertVerticesConcurrently(int nthreads, int maxIter,
+                           double worstTetRadiusTarget, MTet4Factory &myFactory,
+                           std::vector<double> &vSizes,
+                           std::vector<double> &vSizesBGM, int &NUM, int &ITER,
+                           int &REALCOUNT, int &NB_CORRECTION_OF_CAVITY,
+                           int &COUNT_MISS_1, int &COUNT_MISS_2,
+                           edgeContainerB &allEmbeddedEdges,
+                           const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+{
+  MTet4Factory::container &allTets = myFactory.getAllTets();
+  GModel *m = GModel::current();
+  myFactory.setNumThreads(nthreads);
+  std::vector<refinementCandidate> cand;
+  std::vector<MVertex *> sorted;
+  std::vector<std::size_t> order;
+
+  while(1) {
+    if(maxIter > 0 && ITER >= maxIter) break;
+
+    // pop the worst tets, in the order of decreasing radius; they are pushed
+    // back in the queue at the end of the round, unless they were deleted
+    std::size_t maxBatch = REFINEMENT_BATCH_SIZE;
+    if(maxIter > 0) maxBatch = std::min(maxBatch, (std::size_t)(maxIter - ITER));
+    cand.clear();
+    while(!allTets.empty() && cand.size() < maxBatch) {
+      MTet4 *t = *allTets.begin();
+      if(!t->isDeleted() && t->getRadius() < worstTetRadiusTarget) break;
+      allTets.erase(allTets.begin());
+      if(t->isDeleted()) {
+        myFactory.Free(t);
+        continue;
+      }
+      cand.push_back(refinementCandidate());
+      cand.back().worst = t;
+    }
+    if(cand.empty()) break;
+
+    int ITER0 = ITER;
+    double worstRadius = cand[0].worst->getRadius();
+
+    // create the candidate vertices, and sort them spatially
+    sorted.resize(cand.size());
+    for(std::size_t i = 0; i < cand.size(); i++) {
+      double center[3];
+      cand[i].worst->circumcenter(center);
+      cand[i].v = new MVertex(center[0], center[1], center[2],
+                              cand[i].worst->onWhat());
+      cand[i].v->setIndex(i);
+      sorted[i] = cand[i].v;
+    }
+    SortHilbert(sorted);
+    order.resize(sorted.size());
+    for(std::size_t k = 0; k < sorted.size(); k++)
+      order[k] = sorted[k]->getIndex();
+
+    // compute the cavities concurrently: each thread handles a contiguous
+    // range of sorted vertices
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for(std::size_t k = 0; k < order.size(); k++)
+      computeCandidateCavity(cand[order[k]], vSizes, allEmbeddedEdges,
+                             allEmbeddedFaces);
+
+    // lock the cavities, by decreasing tet radius
+    std::set<MTet4 *> locked;
+    std::size_t numTets = 0;
+    for(std::size_t i = 0; i < cand.size(); i++) {
+      refinementCandidate &c = cand[i];
+      if(locked.count(c.worst)) {
+        // the tet will be removed by an accepted cavity
+        c.status = -1;
+        continue;
+      }
+      if(c.status == 0) {
+        bool free = true;
+        for(std::size_t j = 0; j < c.cavity.size() && free; j++)
+          if(locked.count(c.cavity[j])) free = false;
+        for(std::size_t j = 0; j < c.shell.size() && free; j++) {
+          MTet4 *o = c.shell[j].t1->getNeigh(c.shell[j].i1);
+          if(o && locked.count(o)) free = false;
+        }
+        if(!free) {
+          // try again in the next round
+          c.status = -1;
+          continue;
+        }
+        locked.insert(c.cavity.begin(), c.cavity.end());
+        for(std::size_t j = 0; j < c.shell.size(); j++) {
+          MTet4 *o = c.shell[j].t1->getNeigh(c.shell[j].i1);
+          if(o) locked.insert(o);
+        }
+        c.firstTetNum = m->getMaxElementNumber() + 1 + numTets;
+        numTets += c.shell.size();
+        c.v->setIndex(NUM++);
+        vSizes.push_back(c.lc1);
+        vSizesBGM.push_back(c.lc2);
+      }
+      else {
+        c.worst->forceRadius(0.);
+        if(c.status == 1)
+          COUNT_MISS_2++;
+        else
+          COUNT_MISS_1++;
+      }
+      if(c.corrected) NB_CORRECTION_OF_CAVITY++;
+      ITER++;
+    }
+    // reserve the tags of the new tets, so that the mesh does not depend on
+    // the number of threads
+    if(numTets) m->setMaxElementNumber(m->getMaxElementNumber() + numTets);
+
+    // insert the vertices concurrently
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for(std::size_t k = 0; k < order.size(); k++) {
+      refinementCandidate &c = cand[order[k]];
+      if(!c.status)
+        insertCandidate(c, myFactory, vSizes, vSizesBGM, allEmbeddedFaces);
+    }
+
+    for(std::size_t i = 0; i < cand.size(); i++) {
+      refinementCandidate &c = cand[i];
+      if(c.worst->isDeleted())
+        myFactory.Free(c.worst);
+      else
+        allTets.insert(c.worst);
+      if(c.status) {
+        delete c.v;
+        continue;
+      }
+      allTets.insert(c.newTets.begin(), c.newTets.end());
+      c.v->onWhat()->mesh_vertices.push_back(c.v);
+      REALCOUNT++;
+    }
+
+    if(ITER / 500 != ITER0 / 500)
+      Msg::Info("It. %d - %d nodes created - worst tet radius %g (nodes "
+                "removed %d %d)",
+                ITER, REALCOUNT, worstRadius, COUNT_MISS_1, COUNT_MISS_2);
+
+    // Normally, a tet mesh contains about 6 times more tets than vertices. This
+    // allows to clean up the set of tets when lots of deleted ones are present
+    // in the mesh
+    if(allTets.size() > 7 * vSizes.size() && ITER > 1000) {
+      memoryCleanup(myFactory, allTets);
+    }
+  }
+}
+
+// recursively split the tets into numParts subdomains with the same number of
+// tets, by cutting the bounding box of their barycenters in its largest
+// dimension (or in the next ones, if shift > 0)
+typedef std::vector<std::pair<SPoint3, MTet4 *> >::iterator tetCenterIter;
+static void splitIntoSubdomains(tetCenterIter beg, tetCenterIter end,
+                                int firstPart, int numParts, int shift)
+{
+  if(numParts <= 1) {
+    for(auto it = beg; it != end; ++it) it->second->setPartition(firstPart);
+    return;
+  }
+  SBoundingBox3d bbox;
+  for(auto it = beg; it != end; ++it) bbox += it->first;
+  SVector3 d = bbox.max() - bbox.min();
+  int dir = (d.x() >= d.y() && d.x() >= d.z()) ? 0 : (d.y() >= d.z()) ? 1 : 2;
+  dir = (dir + shift) % 3;
+  int n1 = numParts / 2;
+  tetCenterIter mid = beg + (end - beg) * n1 / numParts;
+  std::nth_element(beg, mid, end,
+                   [dir](const std::pair<SPoint3, MTet4 *> &a,
+                         const std::pair<SPoint3, MTet4 *> &b) {
+                     return a.first[dir] < b.first[dir];
+                   });
+  splitIntoSubdomains(beg, mid, firstPart, n1, shift);
+  splitIntoSubdomains(mid, end, firstPart + n1, numParts - n1, shift);
+}
+
+// refine the subdomain part with the serial algorithm, until all its tets are
+// small enough or maxNewVertices vertices have been inserted (with indices
+// starting at firstIndex); the bad tets whose cavity reaches another subdomain
+// are stored in interfaceTets
+static void refineSubdomain(
+  int part, MTet4Factory::container &tets, std::vector<MTet4 *> &interfaceTets,
+  std::vector<MVertex *> &newVertices, std::size_t firstIndex,
+  std::size_t maxNewVertices, double worstTetRadiusTarget,
+  MTet4Factory &myFactory, std::vector<double> &vSizes,
+  std::vector<double> &vSizesBGM, int &ITER, int &NB_CORRECTION_OF_CAVITY,
+  int &COUNT_MISS_1, int &COUNT_MISS_2, edgeContainerB &allEmbeddedEdges,
+  const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+{
+  refinementCandidate c;
+  c.firstTetNum = 0;
+  while(!tets.empty() && newVertices.size() < maxNewVertices) {
+    MTet4 *worst = *tets.begin();
+    tets.erase(tets.begin());
+    if(worst->isDeleted()) {
+      myFactory.Free(worst);
+      continue;
+    }
+    if(worst->getRadius() < worstTetRadiusTarget) {
+      tets.insert(worst);
+      break;
+    }
+    double center[3];
+    worst->circumcenter(center);
+    c.worst = worst;
+    c.v = new MVertex(center[0], center[1], center[2], worst->onWhat());
+    c.shell.clear();
+    c.cavity.clear();
+    c.newTets.clear();
+    computeCandidateCavity(c, vSizes, allEmbeddedEdges, allEmbeddedFaces,
+                           part);
+    if(c.status == 3) {
+      interfaceTets.push_back(worst);
+      delete c.v;
+      continue;
+    }
+    ITER++;
+    if(c.corrected) NB_CORRECTION_OF_CAVITY++;
+    if(c.status) {
+      worst->forceRadius(0.);
+      tets.insert(worst);
+      if(c.status == 1)
+        COUNT_MISS_2++;
+      else
+        COUNT_MISS_1++;
+      delete c.v;
+      continue;
+    }
+    std::size_t index = firstIndex + newVertices.size();
+    c.v->setIndex(index);
+    vSizes[index] = c.lc1;
+    vSizesBGM[index] = c.lc2;
+    insertCandidate(c, myFactory, vSizes, vSizesBGM, allEmbeddedFaces, part);
+    tets.insert(c.newTets.begin(), c.newTets.end());
+    // the worst tet is always in its cavity
+    myFactory.Free(worst);
+    newVertices.push_back(c.v);
+  }
+}
+
+// minimum number of new vertices per subdomain in each round of the decomposed
+// refinement
+static const std::size_t SUBDOMAIN_MIN_NEW_VERTICES = 10000;
+
+// number of tets per subdomain when the volume is decomposed (the number of
+// subdomains thus only depends on the mesh, and not on the number of threads)
+static const std::size_t SUBDOMAIN_NUM_TETS = 10000;
+
+// the volume is only decomposed once the worst tet radius is smaller than
+// SUBDOMAIN_COARSE_RADIUS times the target radius
+static const double SUBDOMAIN_COARSE_RADIUS = 4.;
+
+// Decomposed first phase of the concurrent refinement of a large volume: the
+// tets are split into subdomains of SUBDOMAIN_NUM_TETS tets by recursive
+// coordinate bisection, and the threads refine the subdomains independently,
+// each with its own queue of bad tets. Cavities that contain a tet adjacent to
+// another subdomain are skipped, so that the tets on the interfaces between
+// subdomains are never modified, and the threads do not need to synchronize. New subdomains, cut
+// along other directions so that the previous interfaces are inside the new
+// subdomains, are then computed (and refined) as long as this leads to
+// significant progress; the bad tets left on the interfaces are finally
+// refined by insertVerticesConcurrently. As the subdomains do not depend on the
+// number of threads (and are also used with a single thread), neither does the
+// resulting mesh.
+static void refineSubdomainsConcurrently(
+  int nthreads, double worstTetRadiusTarget, MTet4Factory &myFactory,
+  std::vector<double> &vSizes, std::vector<double> &vSizesBGM, int &NUM,
+  int &ITER, int &REALCOUNT, int &NB_CORRECTION_OF_CAVITY, int &COUNT_MISS_1,
+  int &COUNT_MISS_2, edgeContainerB &allEmbeddedEdges,
+  const std::set<MFace, MFaceLessThan> &allEmbeddedFaces)
+{
+  MTet4Factory::container &allTets = myFactory.getAllTets();
+  GModel *m = GModel::current();
+  myFactory.setNumThreads(nthreads);
+  std::vector<MTet4Factory::container> tets;
+  std::vector<std::vector<MTet4 *> > interfaceTets;
+  std::vector<std::vector<MVertex *> > newVertices;
+  std::vector<std::pair<SPoint3, MTet4 *> > centers;
+
+  for(int round = 0;; round++) {
+    memoryCleanup(myFactory, allTets);
+    int numParts = (int)(allTets.size() / SUBDOMAIN_NUM_TETS);
+    if(numParts < 2 || (*allTets.begin())->getRadius() < worstTetRadiusTarget)
+      break;
+    tets.resize(numParts);
+    interfaceTets.resize(numParts);
+    newVertices.resize(numParts);
+
+    centers.clear();
+    centers.reserve(allTets.size());
+    for(auto it = allTets.begin(); it != allTets.end(); ++it)
+      centers.push_back(std::make_pair((*it)->tet()->barycenter(), *it));
+    splitIntoSubdomains(centers.begin(), centers.end(), 0, numParts, round);
+    for(std::size_t i = 0; i < centers.size(); i++)
+      tets[centers[i].second->getPartition()].insert(centers[i].second);
+    allTets.clear();
+
+    // each subdomain gets a contiguous range of vertex indices, so that the
+    // mesh size at the new vertices can be stored concurrently
+    std::size_t maxNewVertices =
+      std::max(centers.size() / numParts, SUBDOMAIN_MIN_NEW_VERTICES);
+    std::vector<std::pair<SPoint3, MTet4 *> >().swap(centers);
+    std::size_t firstIndex = NUM;
+    vSizes.resize(firstIndex + numParts * maxNewVertices);
+    vSizesBGM.resize(firstIndex + numParts * maxNewVertices);
+
+    // the new vertices and tets take their tags from blocks reserved by each
+    // thread, and are renumbered below in the order of the subdomains, so that
+    // the numbering does not depend on the scheduling of the threads
+    std::size_t maxVertexNum = m->getMaxVertexNumber();
+    std::size_t maxElementNum = m->getMaxElementNumber();
+    int iter = 0, corrections = 0, miss1 = 0, miss2 = 0;
+    m->beginConcurrentNumbering();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 1) \
+  reduction(+ : iter, corrections, miss1, miss2)
+    for(int part = 0; part < numParts; part++) {
+      refineSubdomain(part, tets[part], interfaceTets[part], newVertices[part],
+                      firstIndex + part * maxNewVertices, maxNewVertices,
+                      worstTetRadiusTarget, myFactory, vSizes, vSizesBGM, iter,
+                      corrections, miss1, miss2, allEmbeddedEdges,
+                      allEmbeddedFaces);
+    }
+    m->endConcurrentNumbering();
+    ITER += iter;
+    NB_CORRECTION_OF_CAVITY += corrections;
+    COUNT_MISS_1 += miss1;
+    COUNT_MISS_2 += miss2;
+
+    // renumber the new vertices and tets contiguously, and gather the tets of
+    // all the subdomains
+    int numNew = 0;
+    std::size_t numInterface = 0;
+    auto gather = [&](MTet4 *t) {
+      if(t->isDeleted()) {
+        myFactory.Free(t);
+        return false;
+      }
+      if(t->tet()->getNum() > maxElementNum)
+        t->tet()->forceNum(++maxElementNum);
+      allTets.insert(t);
+      return true;
+    };
+    for(int part = 0; part < numParts; part++) {
+      std::vector<MVertex *> &nv = newVertices[part];
+      for(std::size_t i = 0; i < nv.size(); i++) {
+        std::size_t index = nv[i]->getIndex();
+        vSizes[NUM] = vSizes[index];
+        vSizesBGM[NUM] = vSizesBGM[index];
+        nv[i]->setIndex(NUM++);
+        nv[i]->forceNum(++maxVertexNum);
+        nv[i]->onWhat()->mesh_vertices.push_back(nv[i]);
+      }
+      numNew += (int)nv.size();
+      nv.clear();
+      tets[part].eraseIf([&gather](MTet4 *t) {
+        gather(t);
+        return true;
+      });
+      for(std::size_t i = 0; i < interfaceTets[part].size(); i++) {
+        if(gather(interfaceTets[part][i])) numInterface++;
+      }
+      interfaceTets[part].clear();
+    }
+    vSizes.resize(NUM);
+    vSizesBGM.resize(NUM);
+    REALCOUNT += numNew;
+
+    Msg::Info("It. %d - %d nodes created - %d subdomains refined (%d nodes "
+              "created, %d tets left on interfaces)",
+              ITER, REALCOUNT, numParts, numNew, (int)numInterface);
+
+    // stop when the interfaces prevent any significant progress
+    if(numNew < (int)(numParts * SUBDOMAIN_MIN_NEW_VERTICES / 10)) break;
+  }
+  for(auto it = allTets.begin(); it != allTets.end(); ++it)
+    (*it)->setPartition(0);
+}
+
 void insertVerticesInRegion(GRegion *gr, int maxIter,
                             double worstTetRadiusTarget, bool _classify,
                             splitQuadRecovery *sqr)
@@ -1219,8 +1782,8 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
 #endif
 
   std::vector<double> vSizes, vSizesBGM;
-  MTet4Factory myFactory(1600000);
-  std::set<MTet4 *, compareTet4Ptr> &allTets = myFactory.getAllTets();
+  MTet4Factory myFactory;
+  MTet4Factory::container &allTets = myFactory.getAllTets();
   int NUM = 0;
 
   // leave this in a block so the map gets deallocated directly
@@ -1376,9 +1939,48 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
 
   double t1 = TimeOfDay();
 
-  // main loop in Delaunay inserstion starts here
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads3D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads3D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // the concurrent refinement is used with any number of threads (including
+  // a single one) when it is enabled, so that the mesh does not depend on the
+  // number of threads
+  bool concurrent =
+    (CTX::instance()->mesh.concurrentRefinement3D && !allTets.empty());
+  if(concurrent) {
+    int minTets = CTX::instance()->mesh.domainDecomposition3D;
+    if(minTets > 0 && maxIter <= 0 && (int)allTets.size() >= minTets) {
+      // the initial tets can cross the whole volume: refine them first, until
+      // the mesh is coarse but local enough for the cavities to be mostly
+      // inside a single subdomain
+      Msg::Info("Refining with %d threads", nthreads);
+      insertVerticesConcurrently(nthreads, maxIter,
+                                 SUBDOMAIN_COARSE_RADIUS * worstTetRadiusTarget,
+                                 myFactory, vSizes, vSizesBGM, NUM, ITER,
+                                 REALCOUNT, NB_CORRECTION_OF_CAVITY,
+                                 COUNT_MISS_1, COUNT_MISS_2, allEmbeddedEdges,
+                                 allEmbeddedFaces);
+      Msg::Info("Refining subdomains with %d threads", nthreads);
+      refineSubdomainsConcurrently(nthreads, worstTetRadiusTarget, myFactory,
+                                   vSizes, vSizesBGM, NUM, ITER, REALCOUNT,
+                                   NB_CORRECTION_OF_CAVITY, COUNT_MISS_1,
+                                   COUNT_MISS_2, allEmbeddedEdges,
+                                   allEmbeddedFaces);
+    }
+    Msg::Info("Refining with %d threads", nthreads);
+    insertVerticesConcurrently(nthreads, maxIter, worstTetRadiusTarget,
+                               myFactory, vSizes, vSizesBGM, NUM, ITER,
+                               REALCOUNT, NB_CORRECTION_OF_CAVITY,
+                               COUNT_MISS_1, COUNT_MISS_2, allEmbeddedEdges,
+                               allEmbeddedFaces);
+  }
+
+  // main loop in Delaunay inserstion starts here (if the refinement is not
+  // done concurrently)
 
-  while(1) {
+  while(!concurrent) {
     if(maxIter > 0 && ITER >= maxIter) break;
     if(allTets.empty()) {
       Msg::Warning("No tetrahedra in region %d", gr->tag());
@@ -1522,10 +2124,16 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
   Msg::Info(" - %d tetrahedra created in %g sec. (%d tets/s)", allTets.size(),
             dt, (int)(allTets.size() / dt));
 
+  // process the tets by decreasing radius (smoothing modifies the radii, so
+  // sort them once and for all)
+  std::vector<MTet4 *> sorted;
+  allTets.getSorted(sorted);
+  allTets.clear();
+
   // relocate vertices
   int nbReloc = 0;
   for(int SM = 0; SM < CTX::instance()->mesh.nbSmoothing; SM++) {
-    for(auto it = allTets.begin(); it != allTets.end(); ++it) {
+    for(auto it = sorted.begin(); it != sorted.end(); ++it) {
       if(!(*it)->isDeleted()) {
         double qq = (*it)->getQuality();
         if(qq < .4)
@@ -1536,17 +2144,20 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
     }
   }
 
-  while(1) {
-    if(allTets.begin() == allTets.end()) break;
-    MTet4 *worst = *allTets.begin();
+  for(auto it = sorted.begin(); it != sorted.end(); ++it) {
+    MTet4 *worst = *it;
     if(!worst->isDeleted()) {
       worst->onWhat()->tetrahedra.push_back(worst->tet());
       worst->tet() = nullptr;
     }
     myFactory.Free(worst);
-    allTets.erase(allTets.begin());
   }
 
+  std::size_t poolTets, poolMemory;
+  myFactory.getPoolUsage(poolTets, poolMemory);
+  Msg::Debug("Peak tet pool usage: %d tets (%g Mb)", (int)poolTets,
+             poolMemory / 1024. / 1024.);
+
   _deleteUnusedVertices(gr);
 }
 
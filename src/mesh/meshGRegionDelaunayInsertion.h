@@ -10,13 +10,17 @@
 #include <set>
 #include <map>
 #include <stack>
+#include <vector>
+#include <algorithm>
 #include "MTetrahedron.h"
 #include "Numeric.h"
 #include "BackgroundMeshTools.h"
 #include "qualityMeasures.h"
 #include "robustPredicates.h"
+#include "bucketQueue.h"
+#include "objectPool.h"
+#include "GmshMessage.h"
 
-//#define GMSH_PRE_ALLOCATE_STRATEGY 1
 class GRegion;
 class GFace;
 class GModel;
@@ -32,9 +36,9 @@ class MTet4Factory;
 //
 // * sizeof(MTet4) = 36 Bytes and sizeof(MTetrahedron) = 28 Bytes
 //   -> 64 MB
-// * rb tree containing all pointers sorted with respect to tet
-//   radius: each bucket of the tree contains 4 pointers (16 Bytes)
-//   plus the data -> 20 MB
+// * bucket queue containing all pointers sorted with respect to tet
+//   radius: one pointer per tet, stored contiguously -> 4 MB (8 MB
+//   with 64 bit pointers)
 // * sizeof(MVertex) = 44 Bytes and there are about 200000 verts per
 //   million tet -> 9MB
 // * vector of char lengths per vertex -> 1.6Mb
@@ -48,25 +52,34 @@ class MTet4 {
 
 private:
   bool deleted;
+  // subdomain of the tet, during the decomposed concurrent refinement
+  int part;
   double circum_radius;
   MTetrahedron *base;
   MTet4 *neigh[4];
   GRegion *gr;
+  // position in the bucketQueue storing the tet
+  int queueBucket;
+  unsigned int queueIndex;
 
 public:
   static int radiusNorm; // 2 is euclidian norm, -1 is infinite norm
   ~MTet4() {}
-  MTet4() : deleted(false), circum_radius(0.0), base(nullptr), gr(nullptr)
+  MTet4()
+    : deleted(false), part(0), circum_radius(0.0), base(nullptr), gr(nullptr),
+      queueBucket(-1), queueIndex(0)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
   }
   MTet4(MTetrahedron *t, double qual)
-    : deleted(false), circum_radius(qual), base(t), gr(nullptr)
+    : deleted(false), part(0), circum_radius(qual), base(t), gr(nullptr),
+      queueBucket(-1), queueIndex(0)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
   }
   MTet4(MTetrahedron *t, const qmTetrahedron::Measures &qm)
-    : deleted(false), base(t), gr(nullptr)
+    : deleted(false), part(0), base(t), gr(nullptr), queueBucket(-1),
+      queueIndex(0)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
     double vol;
@@ -160,8 +173,17 @@ public:
   GRegion *onWhat() const { return gr; }
   void setOnWhat(GRegion *g) { gr = g; }
   bool isDeleted() const { return deleted; }
+  int getPartition() const { return part; }
+  void setPartition(int p) { part = p; }
   void forceRadius(double r) { circum_radius = r; }
   double getRadius() const { return circum_radius; }
+  void setQueuePosition(int b, std::size_t i)
+  {
+    queueBucket = b;
+    queueIndex = i;
+  }
+  int getQueueBucket() const { return queueBucket; }
+  std::size_t getQueueIndex() const { return queueIndex; }
   double getQuality() const { return circum_radius; }
   void setQuality(const double &q) { circum_radius = q; }
   MTetrahedron *tet() const { return base; }
@@ -227,82 +249,63 @@ struct compareTet4Ptr {
   }
 };
 
+// Creates and stores the MTet4 of a region being meshed: the MTet4 are
+// allocated in per-thread pools, released in bulk when the factory is
+// destroyed.
 class MTet4Factory {
 public:
-  typedef std::set<MTet4 *, compareTet4Ptr> container;
+  typedef bucketQueue<MTet4, compareTet4Ptr> container;
   typedef container::iterator iterator;
 
 private:
   container allTets;
-#ifdef GMSH_PRE_ALLOCATE_STRATEGY
-  MTet4 *allSlots;
-  int s_last, s_alloc;
-  std::stack<MTet4 *> emptySlots;
-  inline MTet4 *getANewSlot()
+  std::vector<objectPool<MTet4> *> _pools;
+  objectPool<MTet4> &_getPool()
   {
-    if(s_last >= s_alloc) return 0;
-    MTet4 *t = &(allSlots[s_last]);
-    s_last++;
-    return t;
+    std::size_t t = Msg::GetThreadNum();
+    return *_pools[t < _pools.size() ? t : 0];
   }
-  inline MTet4 *getAnEmptySlot()
-  {
-    if(!emptySlots.empty()) {
-      MTet4 *t = emptySlots.top();
-      emptySlots.pop();
-      return t;
-    }
-    return getANewSlot();
-  };
-#endif
+
 public:
-  MTet4Factory(int _size = 1000000)
+  MTet4Factory(int numThreads = 1) { setNumThreads(numThreads); }
+  ~MTet4Factory()
   {
-#ifdef GMSH_PRE_ALLOCATE_STRATEGY
-    s_last = 0;
-    s_alloc = _size;
-    allSlots = new MTet4[s_alloc];
-#endif
+    for(std::size_t i = 0; i < _pools.size(); i++) delete _pools[i];
   }
-  ~MTet4Factory()
+  // Create() can be called concurrently by numThreads threads
+  void setNumThreads(int numThreads)
   {
-#ifdef GMSH_PRE_ALLOCATE_STRATEGY
-    delete[] allSlots;
-#endif
+    while((int)_pools.size() < std::max(numThreads, 1))
+      _pools.push_back(new objectPool<MTet4>(4096));
   }
   MTet4 *Create(MTetrahedron *t, std::vector<double> &sizes,
                 std::vector<double> &sizesBGM)
   {
-#ifdef GMSH_PRE_ALLOCATE_STRATEGY
-    MTet4 *t4 = getAnEmptySlot();
-#else
-    MTet4 *t4 = new MTet4;
-#endif
+    MTet4 *t4 = _getPool().create();
     t4->setup(t, sizes, sizesBGM);
     return t4;
   }
   MTet4 *Create(MTetrahedron *t, std::vector<double> &sizes,
                 std::vector<double> &sizesBGM, double lc1, double lc2)
   {
-#ifdef GMSH_PRE_ALLOCATE_STRATEGY
-    MTet4 *t4 = getAnEmptySlot();
-#else
-    MTet4 *t4 = new MTet4;
-#endif
+    MTet4 *t4 = _getPool().create();
     t4->setup(t, sizes, sizesBGM, lc1, lc2);
     return t4;
   }
-
   void Free(MTet4 *t)
   {
     if(t->tet()) delete t->tet();
     t->tet() = nullptr;
-#ifdef GMSH_PRE_ALLOCATE_STRATEGY
-    emptySlots.push(t);
-    t->setDeleted(true);
-#else
-    delete t;
-#endif
+    _getPool().destroy(t);
+  }
+  // peak number of MTet4 and memory used by the pools
+  void getPoolUsage(std::size_t &numTets, std::size_t &memory) const
+  {
+    numTets = memory = 0;
+    for(std::size_t i = 0; i < _pools.size(); i++) {
+      numTets += _pools[i]->getPeakNumObjects();
+      memory += _pools[i]->getMemoryUsage();
+    }
   }
   void changeTetRadius(iterator it, double r)
   {
@@ -167,7 +167,7 @@ static void gmsh2MMG(GRegion *gr, MMG5_pMesh mmg, MMG5_pSol sol,
     }
 
     // double lc = BGM_MeshSize(v->onWhat(), U, V, v->x(), v->y(), v->z());
-    SMetric3 m = BGM_MeshMetric(v->onWhat(), U, V, v->x(), v->y(), v->z());
+    SMetric3 m = BGM_MeshMetric(v->onWhat(), U, V, v);
 
     auto itv = LCS.find(v);
     if(itv != LCS.end()) {
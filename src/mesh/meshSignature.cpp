@@ -0,0 +1,247 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include "meshSignature.h"
+#include "GModel.h"
+#include "GVertex.h"
+#include "GEdge.h"
+#include "GFace.h"
+#include "GRegion.h"
+#include "ExtrudeParams.h"
+#include "Field.h"
+#include "Context.h"
+
+// number of samples of the parametrization of curves and surfaces (in each
+// direction)
+static const int NUM_SAMPLES = 8;
+
+std::size_t computeMeshOptionsSignature(GModel *m)
+{
+  signatureHash h;
+  CTX *ctx = CTX::instance();
+  h.add(ctx->mesh.lcFactor);
+  h.add(ctx->mesh.lcMin);
+  h.add(ctx->mesh.lcMax);
+  h.add(ctx->mesh.lcIntegrationPrecision);
+  h.add(ctx->mesh.randFactor);
+  h.add(ctx->mesh.randFactor3d);
+  h.add(ctx->mesh.toleranceEdgeLength);
+  h.add(ctx->mesh.toleranceInitialDelaunay);
+  h.add(ctx->mesh.anisoMax);
+  h.add(ctx->mesh.smoothRatio);
+  h.add(ctx->mesh.allowSwapEdgeAngle);
+  h.add(ctx->mesh.recombineMinimumQuality);
+  h.add(ctx->mesh.lcFromPoints);
+  h.add(ctx->mesh.lcFromParametricPoints);
+  h.add(ctx->mesh.lcFromCurvature);
+  h.add(ctx->mesh.lcFromCurvatureIso);
+  h.add(ctx->mesh.lcExtendFromBoundary);
+  h.add(ctx->mesh.nbSmoothing);
+  h.add(ctx->mesh.algo2d);
+  h.add(ctx->mesh.algo3d);
+  h.add(ctx->mesh.algoSwitchOnFailure);
+  h.add(ctx->mesh.algoRecombine);
+  h.add(ctx->mesh.recombineAll);
+  h.add(ctx->mesh.recombineOptimizeTopology);
+  h.add(ctx->mesh.recombineNodeRepositioning);
+  h.add(ctx->mesh.recombine3DAll);
+  h.add(ctx->mesh.flexibleTransfinite);
+  h.add(ctx->mesh.transfiniteTri);
+  h.add(ctx->mesh.minCircleNodes);
+  h.add(ctx->mesh.minCurveNodes);
+  h.add(ctx->mesh.minLineNodes);
+  h.add(ctx->mesh.maxIterDelaunay3D);
+  h.add((int)ctx->mesh.randomSeed);
+  h.add(m->lcCallback ? 1 : 0);
+
+  FieldManager *fields = m->getFields();
+  h.add(fields->getBackgroundField());
+  for(auto it = fields->begin(); it != fields->end(); ++it) {
+    h.add(it->first);
+    h.add(std::string(it->second->getName()));
+    for(auto ito = it->second->options.begin();
+        ito != it->second->options.end(); ++ito) {
+      std::string val;
+      ito->second->getTextRepresentation(val);
+      h.add(ito->first);
+      h.add(val);
+    }
+  }
+  return h.get();
+}
+
+static void addSignature(signatureHash &h, GEntity *ge,
+                         std::map<GEntity *, std::size_t> &signatures)
+{
+  h.add(ge->dim());
+  h.add(ge->tag());
+  h.add(signatures[ge]);
+}
+
+static void addPeriodicity(signatureHash &h, GEntity *ge,
+                           std::map<GEntity *, std::size_t> &signatures)
+{
+  if(ge->getMeshMaster() == ge) return;
+  addSignature(h, ge->getMeshMaster(), signatures);
+  for(std::size_t i = 0; i < ge->affineTransform.size(); i++)
+    h.add(ge->affineTransform[i]);
+}
+
+static void addPoint(signatureHash &h, const GPoint &p)
+{
+  h.add(p.x());
+  h.add(p.y());
+  h.add(p.z());
+}
+
+static bool isExtruded(ExtrudeParams *ep)
+{
+  return ep && ep->mesh.ExtrudeMesh;
+}
+
+static std::size_t signature(GVertex *gv, std::size_t global)
+{
+  signatureHash h;
+  h.add(global);
+  h.add(gv->tag());
+  h.add(gv->x());
+  h.add(gv->y());
+  h.add(gv->z());
+  h.add(gv->prescribedMeshSizeAtVertex());
+  return h.get();
+}
+
+static std::size_t signature(GEdge *ge, std::size_t global,
+                             std::map<GEntity *, std::size_t> &signatures)
+{
+  if(isExtruded(ge->meshAttributes.extrude)) return 0;
+  signatureHash h;
+  h.add(global);
+  h.add(ge->tag());
+  h.add((int)ge->geomType());
+  if(ge->getBeginVertex()) addSignature(h, ge->getBeginVertex(), signatures);
+  if(ge->getEndVertex()) addSignature(h, ge->getEndVertex(), signatures);
+  if(ge->haveParametrization()) {
+    Range<double> r = ge->parBounds(0);
+    h.add(r.low());
+    h.add(r.high());
+    for(int i = 0; i <= NUM_SAMPLES; i++) {
+      double t = r.low() + (r.high() - r.low()) * i / (double)NUM_SAMPLES;
+      addPoint(h, ge->point(t));
+    }
+  }
+  else {
+    h.add(ge->getNumMeshVertices());
+    h.add(ge->getNumMeshElements());
+  }
+  h.add((int)ge->meshAttributes.method);
+  h.add(ge->meshAttributes.coeffTransfinite);
+  h.add(ge->meshAttributes.meshSize);
+  h.add(ge->meshAttributes.meshSizeFactor);
+  h.add(ge->meshAttributes.nbPointsTransfinite);
+  h.add(ge->meshAttributes.typeTransfinite);
+  h.add(ge->meshAttributes.minimumMeshSegments);
+  h.add((int)ge->meshAttributes.reverseMesh);
+  addPeriodicity(h, ge, signatures);
+  return h.get();
+}
+
+static std::size_t signature(GFace *gf, std::size_t global,
+                             std::map<GEntity *, std::size_t> &signatures)
+{
+  if(isExtruded(gf->meshAttributes.extrude)) return 0;
+  signatureHash h;
+  h.add(global);
+  h.add(gf->tag());
+  h.add((int)gf->geomType());
+  std::vector<GEdge *> const &edges = gf->edges();
+  std::vector<int> const &dirs = gf->edgeOrientations();
+  for(std::size_t i = 0; i < edges.size(); i++) {
+    addSignature(h, edges[i], signatures);
+    if(i < dirs.size()) h.add(dirs[i]);
+  }
+  for(auto e : gf->embeddedEdges()) addSignature(h, e, signatures);
+  for(auto v : gf->embeddedVertices()) addSignature(h, v, signatures);
+  if(gf->haveParametrization()) {
+    Range<double> ru = gf->parBounds(0), rv = gf->parBounds(1);
+    h.add(ru.low());
+    h.add(ru.high());
+    h.add(rv.low());
+    h.add(rv.high());
+    for(int i = 0; i <= NUM_SAMPLES; i++) {
+      double u = ru.low() + (ru.high() - ru.low()) * i / (double)NUM_SAMPLES;
+      for(int j = 0; j <= NUM_SAMPLES; j++) {
+        double v = rv.low() + (rv.high() - rv.low()) * j / (double)NUM_SAMPLES;
+        addPoint(h, gf->point(u, v));
+      }
+    }
+  }
+  else {
+    h.add(gf->getNumMeshVertices());
+    h.add(gf->getNumMeshElements());
+  }
+  h.add(gf->meshAttributes.recombine);
+  h.add(gf->meshAttributes.recombineAngle);
+  h.add((int)gf->meshAttributes.method);
+  for(auto v : gf->meshAttributes.corners) h.add(v->tag());
+  h.add(gf->meshAttributes.transfiniteArrangement);
+  h.add(gf->meshAttributes.transfiniteSmoothing);
+  h.add((int)gf->meshAttributes.reverseMesh);
+  h.add(gf->meshAttributes.meshSize);
+  h.add(gf->meshAttributes.meshSizeFactor);
+  h.add(gf->meshAttributes.algorithm);
+  h.add(gf->meshAttributes.meshSizeFromBoundary);
+  h.add((int)gf->meshAttributes.transfinite3);
+  addPeriodicity(h, gf, signatures);
+  return h.get();
+}
+
+static std::size_t signature(GRegion *gr, std::size_t global,
+                             std::map<GEntity *, std::size_t> &signatures)
+{
+  if(isExtruded(gr->meshAttributes.extrude)) return 0;
+  signatureHash h;
+  h.add(global);
+  h.add(gr->tag());
+  h.add((int)gr->geomType());
+  std::vector<GFace *> faces = gr->faces();
+  std::vector<int> const &dirs = gr->faceOrientations();
+  for(std::size_t i = 0; i < faces.size(); i++) {
+    addSignature(h, faces[i], signatures);
+    if(i < dirs.size()) h.add(dirs[i]);
+  }
+  for(auto f : gr->embeddedFaces()) addSignature(h, f, signatures);
+  for(auto e : gr->embeddedEdges()) addSignature(h, e, signatures);
+  for(auto v : gr->embeddedVertices()) addSignature(h, v, signatures);
+  h.add(gr->meshAttributes.recombine3D);
+  h.add((int)gr->meshAttributes.method);
+  for(auto v : gr->meshAttributes.corners) h.add(v->tag());
+  h.add(gr->meshAttributes.QuadTri);
+  h.add(gr->meshAttributes.meshSize);
+  return h.get();
+}
+
+void computeMeshSignatures(GModel *m,
+                           std::map<GEntity *, std::size_t> &signatures)
+{
+  signatures.clear();
+  std::size_t global = computeMeshOptionsSignature(m);
+  for(auto it = m->firstVertex(); it != m->lastVertex(); ++it)
+    signatures[*it] = signature(*it, global);
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it)
+    signatures[*it] = signature(*it, global, signatures);
+  // periodic curves and surfaces depend on their master, which can have a
+  // larger tag
+  for(auto it = m->firstEdge(); it != m->lastEdge(); ++it)
+    if((*it)->getMeshMaster() != *it)
+      signatures[*it] = signature(*it, global, signatures);
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it)
+    signatures[*it] = signature(*it, global, signatures);
+  for(auto it = m->firstFace(); it != m->lastFace(); ++it)
+    if((*it)->getMeshMaster() != *it)
+      signatures[*it] = signature(*it, global, signatures);
+  for(auto it = m->firstRegion(); it != m->lastRegion(); ++it)
+    signatures[*it] = signature(*it, global, signatures);
+}
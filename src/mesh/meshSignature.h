@@ -0,0 +1,63 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MESH_SIGNATURE_H
+#define MESH_SIGNATURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <map>
+
+class GModel;
+class GEntity;
+
+// A 64 bit FNV-1a hash, used to compute the signature of the data the mesh of
+// an entity depends on
+class signatureHash {
+private:
+  uint64_t _h;
+
+public:
+  signatureHash() : _h(14695981039346656037ULL) {}
+  void add(const void *data, std::size_t n)
+  {
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for(std::size_t i = 0; i < n; i++) {
+      _h ^= p[i];
+      _h *= 1099511628211ULL;
+    }
+  }
+  void add(double d)
+  {
+    if(d == 0.) d = 0.; // same signature for 0 and -0
+    add(&d, sizeof(double));
+  }
+  void add(int i) { add(&i, sizeof(int)); }
+  void add(std::size_t i) { add(&i, sizeof(std::size_t)); }
+  void add(const std::string &s)
+  {
+    add(s.size());
+    add(s.data(), s.size());
+  }
+  // 0 is reserved for unknown signatures
+  std::size_t get() const { return _h ? (std::size_t)_h : 1; }
+};
+
+// Compute the signature of the global mesh options and of the mesh size fields
+// that are taken into account when meshing any entity.
+std::size_t computeMeshOptionsSignature(GModel *m);
+
+// Compute the signature of all the entities of the model: the signature of an
+// entity combines the global signature, the geometry of the entity (sampled
+// through its parametrization), its mesh constraints, and the signatures of its
+// bounding and embedded entities (and of its periodic master), so that it
+// changes whenever anything its mesh depends on changes. Mesh size fields are
+// only compared through their options (and the mesh size callback is assumed
+// to be unchanged). Extruded entities get a null (unknown) signature.
+void computeMeshSignatures(GModel *m,
+                           std::map<GEntity *, std::size_t> &signatures);
+
+#endif
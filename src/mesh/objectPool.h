@@ -0,0 +1,90 @@
+// Gmsh - Copyright (C) 1997-2022 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A slab allocator for the small objects that are created and destroyed in
+// large numbers by the meshing algorithms (MTri3, MTet4, BDS_Point, BDS_Edge,
+// BDS_Face): objects are constructed in place in large contiguous slabs, and
+// destroyed objects are recycled through a free list. All the slabs are
+// released at once when the pool is destroyed (or cleared), so that the
+// (possibly many) objects still alive at the end of the meshing of an entity
+// do not have to be freed one by one; their destructor is however not called,
+// so that objects owning other resources must be destroyed explicitly.
+//
+// A pool is not thread-safe: it is meant to be owned by the data structure of
+// a single entity being meshed (or by a single thread), which avoids the
+// contention of the global allocator when several entities are meshed
+// concurrently.
+template <class T> class objectPool {
+private:
+  std::size_t _slabSize, _last;
+  std::vector<T *> _slabs;
+  std::vector<T *> _free;
+  std::size_t _numObjects, _peakNumObjects;
+
+public:
+  objectPool(std::size_t slabSize = 1024)
+    : _slabSize(slabSize), _last(slabSize), _numObjects(0), _peakNumObjects(0)
+  {
+  }
+  ~objectPool() { clear(); }
+  objectPool(const objectPool &) = delete;
+  objectPool &operator=(const objectPool &) = delete;
+  template <class... Args> T *create(Args &&...args)
+  {
+    void *p;
+    if(!_free.empty()) {
+      p = _free.back();
+      _free.pop_back();
+    }
+    else {
+      if(_last == _slabSize) {
+        _slabs.push_back(
+          static_cast<T *>(::operator new(_slabSize * sizeof(T))));
+        _last = 0;
+      }
+      p = _slabs.back() + _last++;
+    }
+    if(++_numObjects > _peakNumObjects) _peakNumObjects = _numObjects;
+    return new(p) T(std::forward<Args>(args)...);
+  }
+  void destroy(T *t)
+  {
+    if(!t) return;
+    t->~T();
+    _free.push_back(t);
+    // objects can be destroyed in a different pool than the one they were
+    // created in (e.g. with one pool per thread)
+    if(_numObjects) _numObjects--;
+  }
+  // release all the memory, without calling the destructor of the objects that
+  // are still alive
+  void clear()
+  {
+    for(std::size_t i = 0; i < _slabs.size(); i++)
+      ::operator delete(_slabs[i]);
+    _slabs.clear();
+    std::vector<T *>().swap(_free);
+    _last = _slabSize;
+    _numObjects = 0;
+  }
+  std::size_t getNumObjects() const { return _numObjects; }
+  std::size_t getPeakNumObjects() const { return _peakNumObjects; }
+  // memory allocated for the slabs, which is also the peak memory usage of the
+  // pool, as slabs are only released by clear()
+  std::size_t getMemoryUsage() const
+  {
+    return _slabs.size() * _slabSize * sizeof(T);
+  }
+};
+
+#endif
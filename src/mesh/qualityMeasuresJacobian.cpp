@@ -4,9 +4,11 @@
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <limits>
+#include <map>
 #include "qualityMeasuresJacobian.h"
 #include "FuncSpaceData.h"
 #include "MElement.h"
+#include "MVertex.h"
 #include "BasisFactory.h"
 #include "bezierBasis.h"
 #include "JacobianBasis.h"
@@ -20,6 +22,9 @@ static const double cTri = 2 / std::sqrt(3);
 static const double cTet = std::sqrt(2);
 static const double cPyr = 4 * std::sqrt(2);
 
+// number of elements processed together by the batched functions
+static const std::size_t BATCH_SIZE = 256;
+
 static void _computeCoeffLengthVectors(const fullMatrix<double> &mat,
                                        fullMatrix<double> &coeff, int type,
                                        int numCoeff = -1)
@@ -178,6 +183,15 @@ static void _computeICN(const fullVector<double> &det,
   }
 }
 
+static bool _jacobianBoundsOk(double minL, double maxL, double minB,
+                              double maxB)
+{
+  double tol = std::max(std::abs(minL), std::abs(maxL)) * 1e-3;
+  return (minL <= 0 || minB > 0) && (maxL >= 0 || maxB < 0) &&
+         minL - minB < tol && maxB - maxL < tol;
+  // NB: First condition implies minL and minB both positive or both negative
+}
+
 static bool _getQualityFunctionSpace(MElement *el, FuncSpaceData &fsGrad,
                                      FuncSpaceData &fsDet,
                                      int orderSamplingPoints = 0)
@@ -239,6 +253,29 @@ static bool _getQualityFunctionSpace(MElement *el, FuncSpaceData &fsGrad,
 
 namespace jacobianBasedQuality {
 
+  static void _minMaxJacobianDeterminant(const FuncSpaceData &fsData,
+                                         const fullVector<double> &coeffLag,
+                                         double &min, double &max, bool debug)
+  {
+    // Convert into Bezier coeff
+    bezierCoeff::usePools(static_cast<std::size_t>(coeffLag.size()), 0);
+    bezierCoeff *bez = new bezierCoeff(fsData, coeffLag, 0);
+
+    // Refine coefficients
+    std::vector<_coeffData *> domains(1, new _coeffDataJac(bez));
+    _subdivideDomains(domains, true, debug);
+
+    // Get extrema
+    min = std::numeric_limits<double>::max();
+    max = -min;
+    for(std::size_t i = 0; i < domains.size(); ++i) {
+      min = std::min(min, domains[i]->minB());
+      max = std::max(max, domains[i]->maxB());
+      domains[i]->deleteBezierCoeff();
+      delete domains[i];
+    }
+  }
+
   void minMaxJacobianDeterminant(MElement *el, double &min, double &max,
                                  const fullMatrix<double> *normals, bool debug)
   {
@@ -258,22 +295,85 @@ namespace jacobianBasedQuality {
     el->getNodesCoord(nodesXYZ);
     jfs->getSignedJacobian(nodesXYZ, coeffLag, normals);
 
-    // Convert into Bezier coeff
-    bezierCoeff::usePools(static_cast<std::size_t>(coeffLag.size()), 0);
-    bezierCoeff *bez = new bezierCoeff(jfs->getFuncSpaceData(), coeffLag, 0);
+    _minMaxJacobianDeterminant(jfs->getFuncSpaceData(), coeffLag, min, max,
+                               debug);
+  }
 
-    // Refine coefficients
-    std::vector<_coeffData *> domains(1, new _coeffDataJac(bez));
-    _subdivideDomains(domains, true, debug);
+  void minMaxJacobianDeterminant(const std::vector<MElement *> &el,
+                                 std::vector<double> &min,
+                                 std::vector<double> &max,
+                                 const fullMatrix<double> *normals)
+  {
+    min.resize(el.size());
+    max.resize(el.size());
+
+    // Elements of the same type share the same Jacobian basis
+    std::map<int, std::vector<std::size_t> > types;
+    for(std::size_t i = 0; i < el.size(); i++)
+      types[el[i]->getTypeForMSH()].push_back(i);
+
+    for(auto it = types.begin(); it != types.end(); ++it) {
+      const std::vector<std::size_t> &idx = it->second;
+      const JacobianBasis *jfs = el[idx[0]]->getJacobianFuncSpace();
+      if(!jfs) {
+        Msg::Warning("Jacobian function space not implemented for %s",
+                     el[idx[0]]->getName().c_str());
+        for(std::size_t i = 0; i < idx.size(); i++) {
+          min[idx[i]] = 99;
+          max[idx[i]] = -99;
+        }
+        continue;
+      }
+      const int numNodes = jfs->getNumMapNodes();
+      const int numSampling = jfs->getNumSamplingPnts();
+
+      for(std::size_t b = 0; b < idx.size(); b += BATCH_SIZE) {
+        const int n = static_cast<int>(std::min(BATCH_SIZE, idx.size() - b));
+
+        // Gather node coordinates, one column per element
+        fullMatrix<double> nodesX(numNodes, n), nodesY(numNodes, n),
+          nodesZ(numNodes, n);
+        for(int j = 0; j < n; j++) {
+          MElement *e = el[idx[b + j]];
+          for(int i = 0; i < numNodes; i++) {
+            const MVertex *v = e->getShapeFunctionNode(i);
+            nodesX(i, j) = v->x();
+            nodesY(i, j) = v->y();
+            nodesZ(i, j) = v->z();
+          }
+        }
 
-    // Get extrema
-    min = std::numeric_limits<double>::max();
-    max = -min;
-    for(std::size_t i = 0; i < domains.size(); ++i) {
-      min = std::min(min, domains[i]->minB());
-      max = std::max(max, domains[i]->maxB());
-      domains[i]->deleteBezierCoeff();
-      delete domains[i];
+        // Sample Jacobian determinant and convert into Bezier coeff for the
+        // whole batch at once (matrix-matrix products)
+        fullMatrix<double> coeffLag(numSampling, n);
+        jfs->getSignedJacobian(nodesX, nodesY, nodesZ, coeffLag, normals);
+        bezierCoeff bez(jfs->getFuncSpaceData(), coeffLag);
+
+        // Only refine the elements for which the bounds are not sharp enough
+        for(int j = 0; j < n; j++) {
+          double minL = bez.getCornerCoeff(0, j), maxL = minL;
+          for(int i = 1; i < bez.getNumCornerCoeff(); i++) {
+            minL = std::min(minL, bez.getCornerCoeff(i, j));
+            maxL = std::max(maxL, bez.getCornerCoeff(i, j));
+          }
+          double minB = bez(0, j), maxB = minB;
+          for(int i = 1; i < bez.getNumCoeff(); i++) {
+            minB = std::min(minB, bez(i, j));
+            maxB = std::max(maxB, bez(i, j));
+          }
+          const std::size_t k = idx[b + j];
+          if(_jacobianBoundsOk(minL, maxL, minB, maxB)) {
+            min[k] = minB;
+            max[k] = maxB;
+          }
+          else {
+            fullVector<double> col;
+            col.setAsProxy(coeffLag, j);
+            _minMaxJacobianDeterminant(jfs->getFuncSpaceData(), col, min[k],
+                                       max[k], false);
+          }
+        }
+      }
     }
   }
 
@@ -369,6 +469,38 @@ namespace jacobianBasedQuality {
     return _getMinAndDeleteDomains(domains);
   }
 
+  void minIGEMeasure(const std::vector<MElement *> &el,
+                     std::vector<double> &ige, bool knownValid,
+                     bool reversedOk, const fullMatrix<double> *normals)
+  {
+    std::vector<double> jmin, jmax;
+    if(!knownValid) minMaxJacobianDeterminant(el, jmin, jmax, normals);
+    ige.resize(el.size());
+    for(std::size_t i = 0; i < el.size(); i++) {
+      if(!knownValid && ((jmin[i] <= 0 && jmax[i] >= 0) ||
+                         (jmax[i] < 0 && !reversedOk)))
+        ige[i] = 0;
+      else
+        ige[i] = minIGEMeasure(el[i], true, reversedOk, normals);
+    }
+  }
+
+  void minICNMeasure(const std::vector<MElement *> &el,
+                     std::vector<double> &icn, bool knownValid,
+                     bool reversedOk, const fullMatrix<double> *normals)
+  {
+    std::vector<double> jmin, jmax;
+    if(!knownValid) minMaxJacobianDeterminant(el, jmin, jmax, normals);
+    icn.resize(el.size());
+    for(std::size_t i = 0; i < el.size(); i++) {
+      if(!knownValid && ((jmin[i] <= 0 && jmax[i] >= 0) ||
+                         (jmax[i] < 0 && !reversedOk)))
+        icn[i] = 0;
+      else
+        icn[i] = minICNMeasure(el[i], true, reversedOk, normals);
+    }
+  }
+
   void sampleJacobianDeterminant(MElement *el, int deg, double &min,
                                  double &max, const fullMatrix<double> *normals)
   {
@@ -509,10 +641,7 @@ namespace jacobianBasedQuality {
 
   bool _coeffDataJac::boundsOk(double minL, double maxL) const
   {
-    double tol = std::max(std::abs(minL), std::abs(maxL)) * 1e-3;
-    return (minL <= 0 || _minB > 0) && (maxL >= 0 || _maxB < 0) &&
-           minL - _minB < tol && _maxB - maxL < tol;
-    // NB: First condition implies minL and minB both positive or both negative
+    return _jacobianBoundsOk(minL, maxL, _minB, _maxB);
   }
 
   void _coeffDataJac::getSubCoeff(std::vector<_coeffData *> &v) const
@@ -27,6 +27,23 @@ namespace jacobianBasedQuality {
                        bool reversedOk = false,
                        const fullMatrix<double> *normals = nullptr,
                        bool debug = false);
+
+  // Same as above for a whole set of elements: elements of the same type are
+  // processed in batches, and adaptive subdivision is only performed for the
+  // elements whose bounds are not sharp enough
+  void minMaxJacobianDeterminant(const std::vector<MElement *> &el,
+                                 std::vector<double> &min,
+                                 std::vector<double> &max,
+                                 const fullMatrix<double> *normals = nullptr);
+  void minIGEMeasure(const std::vector<MElement *> &el,
+                     std::vector<double> &ige, bool knownValid = false,
+                     bool reversedOk = false,
+                     const fullMatrix<double> *normals = nullptr);
+  void minICNMeasure(const std::vector<MElement *> &el,
+                     std::vector<double> &icn, bool knownValid = false,
+                     bool reversedOk = false,
+                     const fullMatrix<double> *normals = nullptr);
+
   void sampleJacobianDeterminant(MElement *el, int order, double &min,
                                  double &max,
                                  const fullMatrix<double> *normals = nullptr);
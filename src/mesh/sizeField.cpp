@@ -60,15 +60,15 @@ int createSizeFieldFromExistingMesh(GModel *gm, bool computeCrosses)
     double size = 1.e22, U, V;
     if(v->onWhat()->dim() == 1) {
       v->getParameter(0, U);
-      size = BGM_MeshSize(v->onWhat(), U, 0., v->x(), v->y(), v->z());
+      size = BGM_MeshSize(v->onWhat(), U, 0., v);
     }
     else if(v->onWhat()->dim() == 2) {
       v->getParameter(0, U);
       v->getParameter(1, V);
-      size = BGM_MeshSize(v->onWhat(), U, V, v->x(), v->y(), v->z());
+      size = BGM_MeshSize(v->onWhat(), U, V, v);
     }
     else
-      size = BGM_MeshSize(v->onWhat(), 0., 0., v->x(), v->y(), v->z());
+      size = BGM_MeshSize(v->onWhat(), 0., 0., v);
     sizeField[v] = size;
   }
 
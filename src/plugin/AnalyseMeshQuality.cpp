@@ -39,6 +39,10 @@ StringXNumber CurvedMeshOptions_Number[] = {
 #endif
 };
 
+// number of elements whose Jacobian is checked at once, between two updates
+// of the progress status
+static const unsigned JACOBIAN_BATCH_SIZE = 4096;
+
 extern "C" {
 GMSH_Plugin *GMSH_RegisterAnalyseMeshQualityPlugin()
 {
@@ -301,18 +305,26 @@ void GMSH_AnalyseMeshQualityPlugin::_computeMinMaxJandValidity(int dim)
 
     MsgProgressStatus progress(num);
 
+    std::vector<MElement *> elements;
+    std::vector<double> min, max;
     _data.reserve(_data.size() + num);
-    for(unsigned i = 0; i < num; ++i) {
-      MElement *el = entity->getMeshElement(i);
-      double min, max;
-      jacobianBasedQuality::minMaxJacobianDeterminant(el, min, max, normals);
-      _data.push_back(data_elementMinMax(el, min, max));
-      if(min < 0 && max < 0) ++cntInverted;
-      progress.next();
+    for(unsigned b = 0; b < num; b += JACOBIAN_BATCH_SIZE) {
+      unsigned n = std::min(num - b, JACOBIAN_BATCH_SIZE);
+      elements.resize(n);
+      for(unsigned i = 0; i < n; ++i)
+        elements[i] = entity->getMeshElement(b + i);
+      jacobianBasedQuality::minMaxJacobianDeterminant(elements, min, max,
+                                                      normals);
+      for(unsigned i = 0; i < n; ++i) {
+        MElement *el = elements[i];
+        _data.push_back(data_elementMinMax(el, min[i], max[i]));
+        if(min[i] < 0 && max[i] < 0) ++cntInverted;
+        progress.next();
 
 #if defined(HAVE_VISUDEV)
-      _computePointwiseQuantities(el, normals);
+        _computePointwiseQuantities(el, normals);
 #endif
+      }
     }
     if(normals) delete normals;
   }
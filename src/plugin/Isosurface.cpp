@@ -13,7 +13,8 @@ StringXNumber IsosurfaceOptions_Number[] = {
   {GMSH_FULLRC, "TargetError", GMSH_IsosurfacePlugin::callbackTarget, 1e-4},
   {GMSH_FULLRC, "View", nullptr, -1.},
   {GMSH_FULLRC, "OtherTimeStep", nullptr, -1.},
-  {GMSH_FULLRC, "OtherView", nullptr, -1.}};
+  {GMSH_FULLRC, "OtherView", nullptr, -1.},
+  {GMSH_FULLRC, "Welded", nullptr, 0.}};
 
 extern "C" {
 GMSH_Plugin *GMSH_RegisterIsosurfacePlugin()
@@ -91,7 +92,13 @@ std::string GMSH_IsosurfacePlugin::getHelp() const
          "source.\n\n"
          "If `View' < 0, the plugin is run on the current view.\n\n"
          "Plugin(Isosurface) creates as many list-based views as there "
-         "are time steps in `View'.";
+         "are time steps in `View'.\n\n"
+         "If `Welded' is nonzero and if `View' and `OtherView' are "
+         "model-based views with node data on the same mesh, the "
+         "isosurface of the volume elements is instead created as a "
+         "new discrete surface in the model, whose triangles share "
+         "their nodes, and the plugin creates model-based views on "
+         "this surface.";
 }
 
 int GMSH_IsosurfacePlugin::getNbOptions() const
@@ -122,6 +129,7 @@ PView *GMSH_IsosurfacePlugin::execute(PView *v)
   _targetError = IsosurfaceOptions_Number[3].def;
   _valueTimeStep = (int)IsosurfaceOptions_Number[5].def;
   _valueView = (int)IsosurfaceOptions_Number[6].def;
+  _welded = (int)IsosurfaceOptions_Number[7].def;
   _orientation = GMSH_LevelsetPlugin::MAP;
 
   PView *v1 = getView(iView, v);
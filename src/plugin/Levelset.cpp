@@ -3,6 +3,8 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
+#include <unordered_map>
 #include "Levelset.h"
 #include "MakeSimplex.h"
 #include "Numeric.h"
@@ -10,6 +12,12 @@
 #include "adaptiveData.h"
 #include "GmshDefines.h"
 #include "PViewOptions.h"
+#include "Context.h"
+#include "PViewDataGModel.h"
+#include "GModel.h"
+#include "discreteFace.h"
+#include "MTriangle.h"
+#include "MEdgeHash.h"
 
 static const int exn[13][12][2] = {
   {{0, 0}}, // point
@@ -221,9 +229,78 @@ static void reorderPrism(int numComp, double xp[12], double yp[12],
   }
 }
 
+// A node of a welded levelset, on the edge (v0, v1) of the mesh, at parametric
+// coordinate c from v0: v0 and v1 are sorted by number, and v0 == v1 if the
+// node is a node of the mesh.
+struct weldedPoint {
+  MVertex *v0, *v1;
+  double c, x, y, z;
+};
+
+// edges of the tetrahedron (see exn) cut by the zero levelset, in cyclic
+// order, indexed by the bitmask of the nodes with a nonnegative level: the
+// first entry is the number of edges
+static const int tetCut[16][5] = {
+  {0, 0, 0, 0, 0}, {3, 0, 1, 2, 0}, {3, 0, 3, 4, 0}, {4, 1, 2, 4, 3},
+  {3, 1, 3, 5, 0}, {4, 0, 2, 5, 3}, {4, 0, 4, 5, 1}, {3, 2, 4, 5, 0},
+  {3, 2, 4, 5, 0}, {4, 0, 1, 5, 4}, {4, 0, 3, 5, 2}, {3, 1, 3, 5, 0},
+  {4, 1, 3, 4, 2}, {3, 0, 3, 4, 0}, {3, 0, 1, 2, 0}, {0, 0, 0, 0, 0}};
+
+// cut a tetrahedron by the zero levelset, and store the nodes of the resulting
+// triangles; if requested, the triangles are oriented along the gradient of
+// the levelset
+static void cutTetrahedron(MVertex *v[4], double x[4], double y[4],
+                           double z[4], double levels[4], bool orient,
+                           std::vector<weldedPoint> &out)
+{
+  int idx = 0;
+  for(int i = 0; i < 4; i++)
+    if(levels[i] >= 0.) idx |= (1 << i);
+  const int *edges = tetCut[idx];
+  int np = edges[0];
+  if(!np) return;
+
+  weldedPoint p[4];
+  for(int i = 0; i < np; i++) {
+    int n0 = exn[6][edges[i + 1]][0], n1 = exn[6][edges[i + 1]][1];
+    // always interpolate from the node with the smallest number, so that all
+    // the elements sharing the edge compute the same point
+    if(v[n1]->getNum() < v[n0]->getNum()) std::swap(n0, n1);
+    double c = levels[n0] / (levels[n0] - levels[n1]);
+    if(c <= 0.) n1 = n0;
+    if(c >= 1.) n0 = n1;
+    if(n0 == n1) c = 0.;
+    p[i].v0 = v[n0];
+    p[i].v1 = v[n1];
+    p[i].c = c;
+    p[i].x = x[n0] + c * (x[n1] - x[n0]);
+    p[i].y = y[n0] + c * (y[n1] - y[n0]);
+    p[i].z = z[n0] + c * (z[n1] - z[n0]);
+  }
+
+  if(orient) {
+    double grad[3], normal[3];
+    gradSimplex(x, y, z, levels, grad);
+    double v1[3] = {p[np - 2].x - p[0].x, p[np - 2].y - p[0].y,
+                    p[np - 2].z - p[0].z};
+    double v2[3] = {p[np - 1].x - p[np - 3].x, p[np - 1].y - p[np - 3].y,
+                    p[np - 1].z - p[np - 3].z};
+    prodve(v1, v2, normal);
+    if(prosca(grad, normal) < 0.) std::reverse(p, p + np);
+  }
+
+  out.push_back(p[0]);
+  out.push_back(p[1]);
+  out.push_back(p[2]);
+  if(np == 4) {
+    out.push_back(p[0]);
+    out.push_back(p[2]);
+    out.push_back(p[3]);
+  }
+}
+
 GMSH_LevelsetPlugin::GMSH_LevelsetPlugin()
 {
-  _invert = 0.;
   _ref[0] = _ref[1] = _ref[2] = 0.;
   _valueIndependent = 0; // "moving" levelset
   _valueView = -1; // use same view for levelset and field data
@@ -232,13 +309,15 @@ GMSH_LevelsetPlugin::GMSH_LevelsetPlugin()
   _targetError = 0.;
   _extractVolume =
     0; // to create isovolumes (keep all elements < or > levelset)
+  _welded = 0; // to create a triangulated surface in the model
   _orientation = GMSH_LevelsetPlugin::NONE;
 }
 
 void GMSH_LevelsetPlugin::_addElement(int np, int numEdges, int numComp,
                                       double xp[12], double yp[12],
                                       double zp[12], double valp[12][9],
-                                      PViewDataList *out, bool firstStep)
+                                      PViewDataList *out,
+                                      bool firstStep) const
 {
   std::vector<double> *list;
   int *nbPtr;
@@ -373,8 +452,9 @@ void GMSH_LevelsetPlugin::_addElement(int np, int numEdges, int numComp,
 
 void GMSH_LevelsetPlugin::_cutAndAddElements(
   PViewData *vdata, PViewData *wdata, int ent, int ele, int vstep, int wstep,
-  double x[8], double y[8], double z[8], double levels[8],
-  double scalarValues[8], PViewDataList *out)
+  const PViewDataCursor &vc, PViewDataCursor &wc, double x[8], double y[8],
+  double z[8], double levels[8], double scalarValues[8],
+  PViewDataList *out) const
 {
   int stepmin = vstep, stepmax = vstep + 1, otherstep = wstep;
   if(stepmin < 0) {
@@ -383,10 +463,13 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
   }
   if(wstep < 0) otherstep = wdata->getFirstNonEmptyTimeStep();
 
-  int numNodes = vdata->getNumNodes(stepmin, ent, ele);
-  int numEdges = vdata->getNumEdges(stepmin, ent, ele);
-  int numComp = wdata->getNumComponents(otherstep, ent, ele);
-  int type = vdata->getType(stepmin, ent, ele);
+  int numNodes = vc.getNumNodes();
+  int numEdges = vc.getNumEdges();
+  int type = vc.getType();
+  int wcstep = otherstep;
+  wdata->setCursor(wc, wcstep, ent, ele);
+  int numComp = wc.getNumComponents();
+  double invert = 0.;
 
   // decompose the element into simplices
   for(int simplex = 0; simplex < numSimplexDec(type); simplex++) {
@@ -400,6 +483,10 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
       if(wstep < 0) otherstep = step;
 
       if(!wdata->hasTimeStep(otherstep)) continue;
+      if(otherstep != wcstep) {
+        wcstep = otherstep;
+        wdata->setCursor(wc, wcstep, ent, ele);
+      }
 
       int np = 0;
       double xp[12], yp[12], zp[12], valp[12][9];
@@ -410,8 +497,8 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
                                     &yp[np], &zp[np]);
           for(int comp = 0; comp < numComp; comp++) {
             double v0, v1;
-            wdata->getValue(otherstep, ent, ele, n[n0], comp, v0);
-            wdata->getValue(otherstep, ent, ele, n[n1], comp, v1);
+            wc.getValue(n[n0], comp, v0);
+            wc.getValue(n[n1], comp, v1);
             valp[np][comp] = v0 + c * (v1 - v0);
           }
           ep[np++] = i + 1;
@@ -439,8 +526,7 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
             yp[nod] = y[n[nod]];
             zp[nod] = z[n[nod]];
             for(int comp = 0; comp < numComp; comp++)
-              wdata->getValue(otherstep, ent, ele, n[nod], comp,
-                              valp[nod][comp]);
+              wc.getValue(n[nod], comp, valp[nod][comp]);
           }
           _addElement(nsn, nse, numComp, xp, yp, zp, valp, out,
                       step == stepmin);
@@ -470,19 +556,19 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
           switch(_orientation) {
           case MAP:
             gradSimplex(x, y, z, scalarValues, gr);
-            _invert = prosca(gr, normal);
+            invert = prosca(gr, normal);
             break;
-          case PLANE: _invert = prosca(normal, _ref); break;
+          case PLANE: invert = prosca(normal, _ref); break;
           case SPHERE:
             gr[0] = xp[0] - _ref[0];
             gr[1] = yp[0] - _ref[1];
             gr[2] = zp[0] - _ref[2];
-            _invert = prosca(gr, normal);
+            invert = prosca(gr, normal);
           case NONE:
           default: break;
           }
         }
-        if(_invert > 0.) {
+        if(invert > 0.) {
           double xpi[12], ypi[12], zpi[12], valpi[12][9];
           int epi[12];
           for(int k = 0; k < np; k++)
@@ -506,8 +592,7 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
             yp[np] = y[n[nod]];
             zp[np] = z[n[nod]];
             for(int comp = 0; comp < numComp; comp++)
-              wdata->getValue(otherstep, ent, ele, n[nod], comp,
-                              valp[np][comp]);
+              wc.getValue(n[nod], comp, valp[np][comp]);
             ep[np] = -(nod + 1); // store node num!
             np++;
           }
@@ -523,14 +608,6 @@ void GMSH_LevelsetPlugin::_cutAndAddElements(
       _addElement(np, numEdges, numComp, xp, yp, zp, valp, out,
                   step == stepmin);
     }
-
-  }
-
-  if(vstep < 0 && (stepmax - stepmin) > (int)out->Time.size()) {
-    out->Time.clear();
-    for(int i = stepmin; i < stepmax; i++) {
-      out->Time.push_back(vdata->getTime(i));
-    }
   }
 }
 
@@ -569,58 +646,266 @@ PView *GMSH_LevelsetPlugin::execute(PView *v)
   // Force creation of one view per time step if we have multi meshes
   if(vdata->hasMultipleMeshes()) _valueIndependent = 0;
 
-  double x[8], y[8], z[8], levels[8];
-  double scalarValues[8] = {0., 0., 0., 0., 0., 0., 0., 0.};
+  // time steps to cut: a single output view contains the (possibly
+  // multi-step) levelset if it does not depend on the values; otherwise one
+  // view is created per time step
+  std::vector<int> steps;
+  if(_valueIndependent)
+    steps.push_back(vdata->getFirstNonEmptyTimeStep());
+  else
+    for(int step = 0; step < vdata->getNumTimeSteps(); step++)
+      if(vdata->hasTimeStep(step)) steps.push_back(step);
+
+  // number the elements of all the entities consecutively, for each step
+  std::vector<std::vector<int> > first(steps.size());
+  for(std::size_t i = 0; i < steps.size(); i++) {
+    int numEnt = vdata->getNumEntities(steps[i]);
+    first[i].resize(numEnt + 1, 0);
+    for(int ent = 0; ent < numEnt; ent++)
+      first[i][ent + 1] = first[i][ent] + vdata->getNumElements(steps[i], ent);
+  }
+
+  if(_welded) {
+    PViewDataGModel *vgm = dynamic_cast<PViewDataGModel *>(vdata);
+    PViewDataGModel *wgm = dynamic_cast<PViewDataGModel *>(wdata);
+    if(!_extractVolume && vgm && wgm && vgm->isNodeData() &&
+       wgm->isNodeData() && !vgm->hasMultipleMeshes() &&
+       !wgm->hasMultipleMeshes() &&
+       vgm->getModel(vgm->getFirstNonEmptyTimeStep()) ==
+         wgm->getModel(wgm->getFirstNonEmptyTimeStep()))
+      return _executeWelded(vgm, wgm, steps, first);
+    Msg::Warning("Welded levelsets require model-based views with node data "
+                 "on the same mesh: creating list-based views");
+  }
+
+  // each thread cuts a contiguous range of the elements of each step into its
+  // own buffer, so that concatenating the buffers in order leads to the same
+  // output as a sequential cut; as the loops are not synchronized, threads that
+  // are done with a step directly proceed with the next one
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  std::vector<PViewDataList> buffers(steps.size() * nthreads);
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    PViewDataCursor vc, wc;
+    double x[8], y[8], z[8], levels[8];
+    double scalarValues[8] = {0., 0., 0., 0., 0., 0., 0., 0.};
+    int thread = Msg::GetThreadNum();
+    for(std::size_t i = 0; i < steps.size(); i++) {
+      int step = steps[i], numEle = first[i].back();
+      PViewDataList *out = &buffers[i * nthreads + thread];
+#pragma omp for schedule(static) nowait
+      for(int k = 0; k < numEle; k++) {
+        int ent = std::upper_bound(first[i].begin(), first[i].end(), k) -
+                  first[i].begin() - 1;
+        int ele = k - first[i][ent];
+        if(vdata->skipElement(step, ent, ele)) continue;
+        vdata->setCursor(vc, step, ent, ele);
+        for(int nod = 0; nod < vc.getNumNodes(); nod++) {
+          vc.getNode(nod, x[nod], y[nod], z[nod]);
+          if(!_valueIndependent) vc.getScalarValue(nod, scalarValues[nod]);
+          levels[nod] = levelset(x[nod], y[nod], z[nod], scalarValues[nod]);
+        }
+        if(_valueIndependent)
+          _cutAndAddElements(vdata, wdata, ent, ele, -1, _valueTimeStep, vc,
+                             wc, x, y, z, levels, scalarValues, out);
+        else
+          _cutAndAddElements(vdata, wdata, ent, ele, step,
+                             (_valueTimeStep < 0) ? step : _valueTimeStep, vc,
+                             wc, x, y, z, levels, scalarValues, out);
+      }
+    }
+  }
 
   PView *v2 = nullptr;
-  if(_valueIndependent) {
-    // create a single output view containing the (possibly multi-step) levelset
-    int firstNonEmptyStep = vdata->getFirstNonEmptyTimeStep();
+  for(std::size_t i = 0; i < steps.size(); i++) {
+    // merge the buffers of all the threads
+    int N[24];
+    std::vector<double> *V[24];
+    buffers[i * nthreads].getListPointers(N, V);
+    for(int t = 1; t < nthreads; t++) {
+      int Nt[24];
+      std::vector<double> *Vt[24];
+      buffers[i * nthreads + t].getListPointers(Nt, Vt);
+      for(int j = 0; j < 24; j++) {
+        N[j] += Nt[j];
+        V[j]->insert(V[j]->end(), Vt[j]->begin(), Vt[j]->end());
+        std::vector<double>().swap(*Vt[j]);
+      }
+    }
     v2 = new PView();
     PViewDataList *out = getDataList(v2);
-    for(int ent = 0; ent < vdata->getNumEntities(firstNonEmptyStep); ent++) {
-      for(int ele = 0; ele < vdata->getNumElements(firstNonEmptyStep, ent);
-          ele++) {
-        if(vdata->skipElement(firstNonEmptyStep, ent, ele)) continue;
-        for(int nod = 0; nod < vdata->getNumNodes(firstNonEmptyStep, ent, ele);
-            nod++) {
-          vdata->getNode(firstNonEmptyStep, ent, ele, nod, x[nod], y[nod],
-                         z[nod]);
-          levels[nod] = levelset(x[nod], y[nod], z[nod], 0.);
-        }
-        _cutAndAddElements(vdata, wdata, ent, ele, -1, _valueTimeStep, x, y, z,
-                           levels, scalarValues, out);
-      }
+    if(_valueIndependent) {
+      for(int step = steps[i]; step < vdata->getNumTimeSteps(); step++)
+        out->Time.push_back(vdata->getTime(step));
+      out->setName(vdata->getName() + "_Levelset");
+      out->setFileName(vdata->getFileName() + "_Levelset.pos");
     }
-    out->setName(vdata->getName() + "_Levelset");
-    out->setFileName(vdata->getFileName() + "_Levelset.pos");
-    out->finalize();
+    else {
+      char tmp[246];
+      sprintf(tmp, "_Levelset_%d", steps[i]);
+      out->setName(vdata->getName() + tmp);
+      out->setFileName(vdata->getFileName() + tmp + ".pos");
+    }
+    out->importLists(N, V); // also finalizes the data
+    for(int j = 0; j < 24; j++) std::vector<double>().swap(*V[j]);
   }
-  else {
-    // create one view per timestep
-    for(int step = 0; step < vdata->getNumTimeSteps(); step++) {
-      if(!vdata->hasTimeStep(step)) continue;
-      v2 = new PView();
-      PViewDataList *out = getDataList(v2);
-      for(int ent = 0; ent < vdata->getNumEntities(step); ent++) {
-        for(int ele = 0; ele < vdata->getNumElements(step, ent); ele++) {
-          if(vdata->skipElement(step, ent, ele)) continue;
-          for(int nod = 0; nod < vdata->getNumNodes(step, ent, ele); nod++) {
-            vdata->getNode(step, ent, ele, nod, x[nod], y[nod], z[nod]);
-            vdata->getScalarValue(step, ent, ele, nod, scalarValues[nod]);
-            levels[nod] = levelset(x[nod], y[nod], z[nod], scalarValues[nod]);
+
+  return v2;
+}
+
+PView *GMSH_LevelsetPlugin::_executeWelded(
+  PViewDataGModel *vdata, PViewDataGModel *wdata, std::vector<int> &steps,
+  std::vector<std::vector<int> > &first)
+{
+  GModel *m = vdata->getModel(vdata->getFirstNonEmptyTimeStep());
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  PView *v2 = nullptr;
+  for(std::size_t i = 0; i < steps.size(); i++) {
+    int step = steps[i], numEle = first[i].back();
+
+    // cut the volume elements (decomposed into tetrahedra) in parallel, each
+    // thread storing the nodes of its triangles in its own buffer
+    std::vector<std::vector<weldedPoint> > points(nthreads);
+#pragma omp parallel num_threads(nthreads)
+    {
+      PViewDataCursor vc;
+      std::vector<weldedPoint> &out = points[Msg::GetThreadNum()];
+#pragma omp for schedule(static)
+      for(int k = 0; k < numEle; k++) {
+        int ent = std::upper_bound(first[i].begin(), first[i].end(), k) -
+                  first[i].begin() - 1;
+        int ele = k - first[i][ent];
+        if(vdata->skipElement(step, ent, ele)) continue;
+        MElement *e = vdata->getElement(step, ent, ele);
+        if(e->getDim() != 3 || e->getNumChildren()) continue;
+        vdata->setCursor(vc, step, ent, ele);
+        double x[8], y[8], z[8], levels[8];
+        for(std::size_t nod = 0; nod < e->getNumPrimaryVertices(); nod++) {
+          double val = 0.;
+          vc.getNode(nod, x[nod], y[nod], z[nod]);
+          if(!_valueIndependent) vc.getScalarValue(nod, val);
+          levels[nod] = levelset(x[nod], y[nod], z[nod], val);
+        }
+        int type = e->getType();
+        for(int simplex = 0; simplex < numSimplexDec(type); simplex++) {
+          int n[4], nsn, nse;
+          getSimplexDec(vc.getNumNodes(), vc.getNumEdges(), type, simplex,
+                        n[0], n[1], n[2], n[3], nsn, nse);
+          MVertex *sv[4];
+          double sx[4], sy[4], sz[4], sl[4];
+          for(int j = 0; j < 4; j++) {
+            sv[j] = e->getVertex(n[j]);
+            sx[j] = x[n[j]];
+            sy[j] = y[n[j]];
+            sz[j] = z[n[j]];
+            sl[j] = levels[n[j]];
           }
-          int wstep = (_valueTimeStep < 0) ? step : _valueTimeStep;
-          _cutAndAddElements(vdata, wdata, ent, ele, step, wstep, x, y, z,
-                             levels, scalarValues, out);
+          cutTetrahedron(sv, sx, sy, sz, sl, _orientation != NONE, out);
+        }
+      }
+    }
+
+    // weld the nodes on the same mesh edges, and discard the triangles that
+    // are degenerate (when the levelset goes through nodes of the mesh)
+    std::unordered_map<MEdge, int, MEdgeHash, MEdgeEqual> index;
+    std::vector<weldedPoint *> nodes;
+    std::vector<int> triangles;
+    for(int t = 0; t < nthreads; t++) {
+      for(std::size_t j = 0; j < points[t].size(); j += 3) {
+        int tri[3];
+        for(int k = 0; k < 3; k++) {
+          weldedPoint &p = points[t][j + k];
+          auto it = index.insert(
+            std::make_pair(MEdge(p.v0, p.v1), (int)nodes.size()));
+          if(it.second) nodes.push_back(&p);
+          tri[k] = it.first->second;
         }
+        if(tri[0] == tri[1] || tri[0] == tri[2] || tri[1] == tri[2]) continue;
+        triangles.insert(triangles.end(), tri, tri + 3);
+      }
+    }
+    if(triangles.empty()) {
+      Msg::Warning("Empty levelset for time step %d", step);
+      continue;
+    }
+
+    // only keep the nodes of the remaining triangles
+    std::vector<int> used(nodes.size(), -1);
+    std::vector<weldedPoint *> usedNodes;
+    for(std::size_t j = 0; j < triangles.size(); j++) {
+      if(used[triangles[j]] < 0) {
+        used[triangles[j]] = usedNodes.size();
+        usedNodes.push_back(nodes[triangles[j]]);
+      }
+      triangles[j] = used[triangles[j]];
+    }
+
+    // create the triangulated surface in the model
+    discreteFace *gf = new discreteFace(m, m->getMaxElementaryNumber(2) + 1);
+    m->add(gf);
+    std::size_t firstNode = m->getMaxVertexNumber();
+    m->setMaxVertexNumber(firstNode + usedNodes.size());
+    std::vector<MVertex *> verts(usedNodes.size());
+    std::vector<std::size_t> tags(usedNodes.size());
+    for(std::size_t j = 0; j < usedNodes.size(); j++) {
+      weldedPoint *p = usedNodes[j];
+      tags[j] = firstNode + 1 + j;
+      verts[j] = new MVertex(p->x, p->y, p->z, gf, tags[j]);
+      gf->mesh_vertices.push_back(verts[j]);
+    }
+    std::size_t firstElement = m->getMaxElementNumber();
+    m->setMaxElementNumber(firstElement + triangles.size() / 3);
+    for(std::size_t j = 0; j < triangles.size(); j += 3)
+      gf->triangles.push_back(new MTriangle(
+        verts[triangles[j]], verts[triangles[j + 1]], verts[triangles[j + 2]],
+        firstElement + 1 + j / 3));
+    m->destroyMeshCaches();
+    Msg::Info("Created levelset surface %d (%lu nodes, %lu triangles)",
+              gf->tag(), usedNodes.size(), gf->triangles.size());
+
+    // interpolate the values on the new nodes
+    PViewDataGModel *out = new PViewDataGModel(PViewDataGModel::NodeData);
+    int stepmin = step, stepmax = step + 1;
+    if(_valueIndependent) stepmax = vdata->getNumTimeSteps();
+    for(int vstep = stepmin; vstep < stepmax; vstep++) {
+      int wstep = (_valueTimeStep < 0) ? vstep : _valueTimeStep;
+      if(!wdata->hasTimeStep(wstep)) continue;
+      stepData<double> *sd = wdata->getStepData(wstep);
+      int numComp = sd->getNumComponents();
+      int numNodes = usedNodes.size();
+      std::vector<double> val(numNodes * numComp, 0.);
+#pragma omp parallel for num_threads(nthreads)
+      for(int j = 0; j < numNodes; j++) {
+        weldedPoint *p = usedNodes[j];
+        double *d0 = sd->getData(p->v0->getNum());
+        double *d1 = sd->getData(p->v1->getNum());
+        if(!d0 || !d1) continue;
+        for(int comp = 0; comp < numComp; comp++)
+          val[j * numComp + comp] = d0[comp] + p->c * (d1[comp] - d0[comp]);
       }
+      out->addData(m, tags, val, out->getNumTimeSteps(), vdata->getTime(vstep),
+                   0, numComp);
+    }
+    if(!out->getNumTimeSteps()) {
+      delete out;
+      continue;
+    }
+
+    if(_valueIndependent) {
+      out->setName(vdata->getName() + "_Levelset");
+      out->setFileName(vdata->getFileName() + "_Levelset.msh");
+    }
+    else {
       char tmp[246];
       sprintf(tmp, "_Levelset_%d", step);
       out->setName(vdata->getName() + tmp);
-      out->setFileName(vdata->getFileName() + tmp + ".pos");
-      out->finalize();
+      out->setFileName(vdata->getFileName() + tmp + ".msh");
     }
+    v2 = new PView(out);
   }
 
   return v2;
@@ -8,21 +8,26 @@
 
 #include "Plugin.h"
 
+class PViewDataGModel;
+
 class GMSH_LevelsetPlugin : public GMSH_PostPlugin {
 private:
-  double _invert;
   void _addElement(int np, int numEdges, int numComp, double xp[12],
                    double yp[12], double zp[12], double valp[12][9],
-                   PViewDataList *out, bool firstStep);
+                   PViewDataList *out, bool firstStep) const;
   void _cutAndAddElements(PViewData *vdata, PViewData *wdata, int ent, int ele,
-                          int step, int wstep, double x[8], double y[8],
+                          int step, int wstep, const PViewDataCursor &vc,
+                          PViewDataCursor &wc, double x[8], double y[8],
                           double z[8], double levels[8], double scalarValues[8],
-                          PViewDataList *out);
+                          PViewDataList *out) const;
+  PView *_executeWelded(PViewDataGModel *vdata, PViewDataGModel *wdata,
+                        std::vector<int> &steps,
+                        std::vector<std::vector<int> > &first);
 
 protected:
   double _ref[3], _targetError;
   int _valueTimeStep, _valueView, _valueIndependent, _recurLevel,
-    _extractVolume;
+    _extractVolume, _welded;
   typedef enum { NONE, PLANE, SPHERE, MAP } ORIENTATION;
   ORIENTATION _orientation;
 
@@ -3,6 +3,7 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include <cmath>
 #include "GmshConfig.h"
 #include "Particles.h"
@@ -211,7 +212,7 @@ PView *GMSH_ParticlesPlugin::execute(PView *v)
   double A1 = ParticlesOptions_Number[12].def;
   double A0 = ParticlesOptions_Number[13].def;
   double DT = ParticlesOptions_Number[14].def;
-  int maxIter = (int)ParticlesOptions_Number[15].def;
+  int maxIter = std::max(0, (int)ParticlesOptions_Number[15].def);
   int timeStep = (int)ParticlesOptions_Number[16].def;
   int iView = (int)ParticlesOptions_Number[17].def;
 
@@ -248,28 +249,36 @@ PView *GMSH_ParticlesPlugin::execute(PView *v)
   double c4 =
     DT * DT * (beta + (0.5 + gamma - 2 * beta) + (0.5 - gamma + beta));
 
-  for(int i = 0; i < getNbU(); ++i) {
-    for(int j = 0; j < getNbV(); ++j) {
-      double XINIT[3], X0[3], X1[3];
-      getPoint(i, j, XINIT);
-      getPoint(i, j, X0);
-      getPoint(i, j, X1);
-      data2->NbVP++;
-      data2->VP.push_back(XINIT[0]);
-      data2->VP.push_back(XINIT[1]);
-      data2->VP.push_back(XINIT[2]);
-      for(int iter = 0; iter < maxIter; iter++) {
-        double F[3], X[3];
-        o1.searchVector(X1[0], X1[1], X1[2], F, timeStep);
-        for(int k = 0; k < 3; k++)
-          X[k] = (c2 * X1[k] + c3 * X0[k] + c4 * F[k]) / c1;
-        data2->VP.push_back(X[0] - XINIT[0]);
-        data2->VP.push_back(X[1] - XINIT[1]);
-        data2->VP.push_back(X[2] - XINIT[2]);
-        for(int k = 0; k < 3; k++) {
-          X0[k] = X1[k];
-          X1[k] = X[k];
-        }
+  // each particle produces a fixed number of values, so that the trajectories
+  // can be computed concurrently directly into the list of the new view
+  int nbSeeds = getNbU() * getNbV();
+  std::size_t seedSize = 3 + 3 * maxIter;
+  data2->NbVP = nbSeeds;
+  data2->VP.resize(nbSeeds * seedSize);
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(int seed = 0; seed < nbSeeds; seed++) {
+    int i = seed / getNbV(), j = seed % getNbV();
+    double XINIT[3], X0[3], X1[3];
+    double *out = data2->VP.data() + seed * seedSize;
+    // the element containing the last position, from which the next one is
+    // searched by walking through the neighbours
+    MElement *e = nullptr;
+    getPoint(i, j, XINIT);
+    getPoint(i, j, X0);
+    getPoint(i, j, X1);
+    for(int k = 0; k < 3; k++) *out++ = XINIT[k];
+    for(int iter = 0; iter < maxIter; iter++) {
+      double F[3], X[3];
+      o1.searchVector(X1[0], X1[1], X1[2], F, timeStep, e);
+      for(int k = 0; k < 3; k++)
+        X[k] = (c2 * X1[k] + c3 * X0[k] + c4 * F[k]) / c1;
+      for(int k = 0; k < 3; k++) *out++ = X[k] - XINIT[k];
+      for(int k = 0; k < 3; k++) {
+        X0[k] = X1[k];
+        X1[k] = X[k];
       }
     }
   }
@@ -3,6 +3,7 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include <cmath>
 #include "GmshConfig.h"
 #include "StreamLines.h"
@@ -212,7 +213,7 @@ void GMSH_StreamLinesPlugin::getPoint(int iU, int iV, double *X)
 PView *GMSH_StreamLinesPlugin::execute(PView *v)
 {
   double DT = StreamLinesOptions_Number[11].def;
-  int maxIter = (int)StreamLinesOptions_Number[12].def;
+  int maxIter = std::max(0, (int)StreamLinesOptions_Number[12].def);
   int timeStep = (int)StreamLinesOptions_Number[13].def;
   int iView = (int)StreamLinesOptions_Number[14].def;
   int otherView = (int)StreamLinesOptions_Number[15].def;
@@ -231,100 +232,111 @@ PView *GMSH_StreamLinesPlugin::execute(PView *v)
   }
 
   OctreePost o1(v1);
-  double *val2 = nullptr;
-  OctreePost *o2 = nullptr;
-  if(data2) {
-    val2 = new double[data2->getNumTimeSteps()];
-    o2 = new OctreePost(v2);
-  }
+  OctreePost *o2 = data2 ? new OctreePost(v2) : nullptr;
 
   PView *v3 = new PView();
   PViewDataList *data3 = getDataList(v3);
 
   const double b1 = 1. / 3., b2 = 2. / 3., b3 = 1. / 3., b4 = 1. / 6.;
   const double a1 = 0.5, a2 = 0.5, a3 = 1., a4 = 1.;
-  double XINIT[3], X[3], DX[3], X1[3], X2[3], X3[3], X4[3];
 
-  for(int i = 0; i < getNbU(); ++i) {
-    for(int j = 0; j < getNbV(); ++j) {
-      getPoint(i, j, XINIT);
-      getPoint(i, j, X);
+  // each seed point produces a fixed number of values, so that the stream
+  // lines can be traced concurrently directly into the list of the new view
+  int nbSeeds = getNbU() * getNbV();
+  int numSteps2 = data2 ? data2->getNumTimeSteps() : 0;
+  std::size_t seedSize =
+    data2 ? maxIter * (6 + 2 * numSteps2) : 3 + 3 * maxIter;
+  if(data2) {
+    data3->NbSL = nbSeeds * maxIter;
+    data3->SL.resize(nbSeeds * seedSize);
+  }
+  else {
+    data3->NbVP = nbSeeds;
+    data3->VP.resize(nbSeeds * seedSize);
+  }
+  if(timeStep < 0) {
+    double T0 = data1->getTime(0);
+    for(int i = 0; i < nbSeeds; i++)
+      for(int iter = 0; iter < maxIter; iter++)
+        data3->Time.push_back(T0 + DT * iter);
+  }
 
-      if(data2) { o2->searchScalar(X[0], X[1], X[2], val2, -1); }
-      else {
-        data3->NbVP++;
-        data3->VP.push_back(X[0]);
-        data3->VP.push_back(X[1]);
-        data3->VP.push_back(X[2]);
-      }
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(int seed = 0; seed < nbSeeds; seed++) {
+    int i = seed / getNbV(), j = seed % getNbV();
+    double XINIT[3], X[3], DX[3], X1[3], X2[3], X3[3], X4[3];
+    std::vector<double> val2(numSteps2);
+    double *out = (data2 ? data3->SL.data() : data3->VP.data()) +
+                  seed * seedSize;
+    // the elements containing the last points found in each view, from which
+    // the next points are searched by walking through the neighbours
+    MElement *e1 = nullptr, *e2 = nullptr;
+
+    getPoint(i, j, XINIT);
+    getPoint(i, j, X);
+
+    if(data2) { o2->searchScalar(X[0], X[1], X[2], val2.data(), -1, e2); }
+    else {
+      for(int k = 0; k < 3; k++) *out++ = X[k];
+    }
 
-      int currentTimeStep = 0;
+    int currentTimeStep = 0;
 
-      for(int iter = 0; iter < maxIter; iter++) {
-        double XPREV[3] = {X[0], X[1], X[2]};
+    for(int iter = 0; iter < maxIter; iter++) {
+      double XPREV[3] = {X[0], X[1], X[2]};
 
-        if(timeStep < 0) {
-          double T0 = data1->getTime(0);
-          double currentT = T0 + DT * iter;
-          data3->Time.push_back(currentT);
-          for(; currentTimeStep < data1->getNumTimeSteps() - 1 &&
-                currentT > 0.5 * (data1->getTime(currentTimeStep) +
-                                  data1->getTime(currentTimeStep + 1));
-              currentTimeStep++)
-            ;
-        }
-        else {
-          currentTimeStep = timeStep;
-        }
+      if(timeStep < 0) {
+        double T0 = data1->getTime(0);
+        double currentT = T0 + DT * iter;
+        for(; currentTimeStep < data1->getNumTimeSteps() - 1 &&
+              currentT > 0.5 * (data1->getTime(currentTimeStep) +
+                                data1->getTime(currentTimeStep + 1));
+            currentTimeStep++)
+          ;
+      }
+      else {
+        currentTimeStep = timeStep;
+      }
 
-        // dX/dt = V
-        // X1 = X + a1 * DT * V(X)
-        // X2 = X + a2 * DT * V(X1)
-        // X3 = X + a3 * DT * V(X2)
-        // X4 = X + a4 * DT * V(X3)
-        // X = X + b1 X1 + b2 X2 + b3 X3 + b4 x4
-        double val[3];
-        o1.searchVector(X[0], X[1], X[2], val, currentTimeStep);
-        for(int k = 0; k < 3; k++) X1[k] = X[k] + DT * val[k] * a1;
-        o1.searchVector(X1[0], X1[1], X1[2], val, currentTimeStep);
-        for(int k = 0; k < 3; k++) X2[k] = X[k] + DT * val[k] * a2;
-        o1.searchVector(X2[0], X2[1], X2[2], val, currentTimeStep);
-        for(int k = 0; k < 3; k++) X3[k] = X[k] + DT * val[k] * a3;
-        o1.searchVector(X3[0], X3[1], X3[2], val, currentTimeStep);
-        for(int k = 0; k < 3; k++) X4[k] = X[k] + DT * val[k] * a4;
-
-        for(int k = 0; k < 3; k++)
-          X[k] += (b1 * (X1[k] - X[k]) + b2 * (X2[k] - X[k]) +
-                   b3 * (X3[k] - X[k]) + b4 * (X4[k] - X[k]));
-        for(int k = 0; k < 3; k++) DX[k] = X[k] - XINIT[k];
-
-        if(data2) {
-          data3->NbSL++;
-          data3->SL.push_back(XPREV[0]);
-          data3->SL.push_back(X[0]);
-          data3->SL.push_back(XPREV[1]);
-          data3->SL.push_back(X[1]);
-          data3->SL.push_back(XPREV[2]);
-          data3->SL.push_back(X[2]);
-          for(int k = 0; k < data2->getNumTimeSteps(); k++)
-            data3->SL.push_back(val2[k]);
-          o2->searchScalar(X[0], X[1], X[2], val2, -1);
-          for(int k = 0; k < data2->getNumTimeSteps(); k++)
-            data3->SL.push_back(val2[k]);
-        }
-        else {
-          data3->VP.push_back(DX[0]);
-          data3->VP.push_back(DX[1]);
-          data3->VP.push_back(DX[2]);
+      // dX/dt = V
+      // X1 = X + a1 * DT * V(X)
+      // X2 = X + a2 * DT * V(X1)
+      // X3 = X + a3 * DT * V(X2)
+      // X4 = X + a4 * DT * V(X3)
+      // X = X + b1 X1 + b2 X2 + b3 X3 + b4 x4
+      double val[3];
+      o1.searchVector(X[0], X[1], X[2], val, currentTimeStep, e1);
+      for(int k = 0; k < 3; k++) X1[k] = X[k] + DT * val[k] * a1;
+      o1.searchVector(X1[0], X1[1], X1[2], val, currentTimeStep, e1);
+      for(int k = 0; k < 3; k++) X2[k] = X[k] + DT * val[k] * a2;
+      o1.searchVector(X2[0], X2[1], X2[2], val, currentTimeStep, e1);
+      for(int k = 0; k < 3; k++) X3[k] = X[k] + DT * val[k] * a3;
+      o1.searchVector(X3[0], X3[1], X3[2], val, currentTimeStep, e1);
+      for(int k = 0; k < 3; k++) X4[k] = X[k] + DT * val[k] * a4;
+
+      for(int k = 0; k < 3; k++)
+        X[k] += (b1 * (X1[k] - X[k]) + b2 * (X2[k] - X[k]) +
+                 b3 * (X3[k] - X[k]) + b4 * (X4[k] - X[k]));
+      for(int k = 0; k < 3; k++) DX[k] = X[k] - XINIT[k];
+
+      if(data2) {
+        for(int k = 0; k < 3; k++) {
+          *out++ = XPREV[k];
+          *out++ = X[k];
         }
+        for(int k = 0; k < numSteps2; k++) *out++ = val2[k];
+        o2->searchScalar(X[0], X[1], X[2], val2.data(), -1, e2);
+        for(int k = 0; k < numSteps2; k++) *out++ = val2[k];
+      }
+      else {
+        for(int k = 0; k < 3; k++) *out++ = DX[k];
       }
     }
   }
 
-  if(data2) {
-    delete[] val2;
-    delete o2;
-  }
+  if(data2) { delete o2; }
   else {
     v3->getOptions()->vectorType = PViewOptions::Displacement;
   }
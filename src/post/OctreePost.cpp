@@ -3,6 +3,9 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
 #include "Octree.h"
 #include "OctreePost.h"
 #include "PView.h"
@@ -16,6 +19,12 @@
 #include "MElement.h"
 #include "Context.h"
 #include "SBoundingBox3d.h"
+#include "MEdgeHash.h"
+#include "MFaceHash.h"
+
+// in MElementOctree.cpp
+void MElementBB(void *a, double *min, double *max);
+int MElementInEle(void *a, double *x);
 
 // helper routines for list-based views
 
@@ -233,10 +242,78 @@ static void addListOfStuff(Octree *o, std::vector<double> &l, int nbelm)
   for(std::size_t i = 0; i < l.size(); i += nbelm) Octree_Insert(&l[i], o);
 }
 
+// face (for volume elements) or edge (for surface elements) neighbours of the
+// elements of highest dimension of a model, used to walk from element to
+// element in model-based views
+
+class elementNeighbours {
+private:
+  std::unordered_map<MElement *, std::size_t> _first;
+  std::vector<MElement *> _neighbours;
+  template <class Side, class Hash, class Equal, class GetSide>
+  void _connect(const std::vector<MElement *> &elements, GetSide getSide)
+  {
+    std::unordered_map<Side, std::pair<MElement *, std::size_t>, Hash, Equal>
+      open;
+    for(auto e : elements) {
+      std::size_t first = _first[e];
+      for(int i = 0; i < numSides(e); i++) {
+        Side s = getSide(e, i);
+        auto it = open.find(s);
+        if(it == open.end()) { open[s] = std::make_pair(e, first + i); }
+        else {
+          _neighbours[first + i] = it->second.first;
+          _neighbours[it->second.second] = e;
+          open.erase(it);
+        }
+      }
+    }
+  }
+
+public:
+  GModel *model;
+  int dim;
+  elementNeighbours(GModel *m) : model(m), dim(m->getDim())
+  {
+    std::vector<GEntity *> entities;
+    m->getEntities(entities, dim);
+    std::vector<MElement *> elements;
+    std::size_t n = 0;
+    for(auto ge : entities) {
+      for(std::size_t i = 0; i < ge->getNumMeshElements(); i++) {
+        MElement *e = ge->getMeshElement(i);
+        elements.push_back(e);
+        _first[e] = n;
+        n += numSides(e);
+      }
+    }
+    _neighbours.resize(n, nullptr);
+    if(dim == 3)
+      _connect<MFace, MFaceHash, MFaceEqual>(
+        elements, [](MElement *e, int i) { return e->getFace(i); });
+    else
+      _connect<MEdge, MEdgeHash, MEdgeEqual>(
+        elements, [](MElement *e, int i) { return e->getEdge(i); });
+  }
+  int numSides(MElement *e) const
+  {
+    return (dim == 3) ? e->getNumFaces() : e->getNumEdges();
+  }
+  // return the neighbours of e across each of its sides (nullptr on the
+  // boundary), or nullptr if e is not in the table
+  MElement *const *get(MElement *e) const
+  {
+    auto it = _first.find(e);
+    if(it == _first.end()) return nullptr;
+    return &_neighbours[it->second];
+  }
+};
+
 // OctreePost implementation
 
 OctreePost::~OctreePost()
 {
+  delete _neighbours.load();
   Octree_Delete(_sp);
   Octree_Delete(_vp);
   Octree_Delete(_tp);
@@ -277,6 +354,7 @@ void OctreePost::_create(PViewData *data)
   _si = _vi = _ti = _sy = _vy = _ty = nullptr;
   _theViewDataList = nullptr;
   _theViewDataGModel = nullptr;
+  _neighbours = nullptr;
 
   _theViewDataGModel = dynamic_cast<PViewDataGModel *>(data);
 
@@ -742,3 +820,203 @@ bool OctreePost::searchTensor(double x, double y, double z, double *values,
 
   return false;
 }
+
+// spread the 21 lowest bits of v so that there are 2 zero bits between each of
+// them
+static std::uint64_t mortonSpread(std::uint64_t v)
+{
+  v &= 0x1fffff;
+  v = (v | v << 32) & 0x1f00000000ffffULL;
+  v = (v | v << 16) & 0x1f0000ff0000ffULL;
+  v = (v | v << 8) & 0x100f00f00f00f00fULL;
+  v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+  v = (v | v << 2) & 0x1249249249249249ULL;
+  return v;
+}
+
+// sort the points xyz = [p1x, p1y, p1z, p2x, ...] along a Morton (Z-order)
+// curve, so that consecutive points are close to each other
+static void mortonOrder(const std::vector<double> &xyz,
+                        std::vector<std::size_t> &order)
+{
+  std::size_t n = xyz.size() / 3;
+  SBoundingBox3d bb;
+  for(std::size_t i = 0; i < n; i++)
+    bb += SPoint3(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]);
+  double min[3] = {bb.min().x(), bb.min().y(), bb.min().z()};
+  double scale[3];
+  for(int k = 0; k < 3; k++) {
+    double size = bb.max()[k] - bb.min()[k];
+    scale[k] = (size > 0.) ? double((1 << 21) - 1) / size : 0.;
+  }
+  std::vector<std::pair<std::uint64_t, std::size_t> > codes(n);
+  for(std::size_t i = 0; i < n; i++) {
+    std::uint64_t code = 0;
+    for(int k = 0; k < 3; k++)
+      code |= mortonSpread((std::uint64_t)((xyz[3 * i + k] - min[k]) *
+                                           scale[k]))
+              << k;
+    codes[i] = std::make_pair(code, i);
+  }
+  std::sort(codes.begin(), codes.end());
+  order.resize(n);
+  for(std::size_t i = 0; i < n; i++) order[i] = codes[i].second;
+}
+
+// check if the point P is in the element e (with the same criteria as the
+// element search in the model)
+static bool isInElement(MElement *e, double P[3], int dim)
+{
+  if(dim >= 0 && e->getDim() != dim) return false;
+  double min[3], max[3];
+  MElementBB(e, min, max);
+  for(int k = 0; k < 3; k++)
+    if(P[k] < min[k] || P[k] > max[k]) return false;
+  return MElementInEle(e, P);
+}
+
+elementNeighbours *OctreePost::_getNeighbours()
+{
+  // built by the first caller, like the octree of the view data
+  elementNeighbours *nb = _neighbours.load(std::memory_order_acquire);
+  if(nb) return nb;
+#pragma omp critical(OctreePostNeighbours)
+  {
+    nb = _neighbours.load(std::memory_order_acquire);
+    if(!nb) {
+      nb = new elementNeighbours(_theViewDataGModel->getModel(0));
+      _neighbours.store(nb, std::memory_order_release);
+    }
+  }
+  return nb;
+}
+
+MElement *OctreePost::_walk(double P[3], int step, MElement *hint, int dim)
+{
+  GModel *m = _theViewDataGModel->getModel((step < 0) ? 0 : step);
+  if(!m) return nullptr;
+  if(hint && isInElement(hint, P, dim)) return hint;
+
+  // only the elements of highest dimension are connected
+  elementNeighbours *nb = hint ? _getNeighbours() : nullptr;
+  if(nb && nb->model == m && (dim < 0 || dim == nb->dim)) {
+    // move to the neighbour across the side the point is the farthest outside
+    // of, until the point is found or the walk leaves the mesh
+    MElement *e = hint;
+    for(int iter = 0; iter < 100; iter++) {
+      MElement *const *next = nb->get(e);
+      if(!next) break;
+      SPoint3 c = e->barycenter();
+      double dmax = 0.;
+      int imax = -1;
+      for(int i = 0; i < nb->numSides(e); i++) {
+        SPoint3 b;
+        SVector3 n;
+        if(nb->dim == 3) {
+          MFace f = e->getFace(i);
+          b = f.barycenter();
+          n = f.normal();
+        }
+        else {
+          MEdge ed = e->getEdge(i);
+          b = ed.barycenter();
+          SVector3 t = ed.tangent(), w(c, b);
+          n = w - dot(w, t) * t;
+          n.normalize();
+        }
+        if(dot(n, SVector3(c, b)) < 0.) n *= -1.;
+        double d = dot(n, SVector3(b, SPoint3(P)));
+        if(d > dmax) {
+          dmax = d;
+          imax = i;
+        }
+      }
+      if(imax < 0 || !next[imax]) break;
+      e = next[imax];
+      if(isInElement(e, P, dim)) return e;
+    }
+  }
+
+  return getElement(P, m, 0, nullptr, nullptr, nullptr, dim);
+}
+
+bool OctreePost::_search(double P[3], int nbComp, double *values, int step,
+                         MElement *&hint)
+{
+  int numSteps = (step < 0) ? _theViewDataGModel->getNumTimeSteps() : 1;
+  for(int i = 0; i < nbComp * numSteps; i++) values[i] = 0.;
+  hint = _walk(P, step, hint);
+  return _getValue(hint, nbComp, P, step, values, nullptr, false);
+}
+
+bool OctreePost::searchScalar(double x, double y, double z, double *values,
+                              int step, MElement *&hint)
+{
+  if(!_theViewDataGModel) return searchScalar(x, y, z, values, step);
+  double P[3] = {x, y, z};
+  return _search(P, 1, values, step, hint);
+}
+
+bool OctreePost::searchVector(double x, double y, double z, double *values,
+                              int step, MElement *&hint)
+{
+  if(!_theViewDataGModel) return searchVector(x, y, z, values, step);
+  double P[3] = {x, y, z};
+  return _search(P, 3, values, step, hint);
+}
+
+void OctreePost::search(const std::vector<double> &xyz, int nbComp,
+                        std::vector<double> &values, std::vector<char> &found,
+                        int step, bool grad, int dim)
+{
+  std::size_t n = xyz.size() / 3;
+  int numSteps = 1;
+  if(step < 0) {
+    if(_theViewDataList)
+      numSteps = _theViewDataList->getNumTimeSteps();
+    else if(_theViewDataGModel)
+      numSteps = _theViewDataGModel->getNumTimeSteps();
+  }
+  std::size_t numVal = nbComp * numSteps * (grad ? 3 : 1);
+  values.assign(n * numVal, 0.);
+  found.assign(n, 0);
+  if(!n) return;
+
+  std::vector<std::size_t> order;
+  mortonOrder(xyz, order);
+
+  GModel *m = nullptr;
+  if(_theViewDataGModel) {
+    m = _theViewDataGModel->getModel((step < 0) ? 0 : step);
+    if(!m) return;
+  }
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel num_threads(nthreads)
+  {
+    // the element found for the previous point treated by this thread
+    MElement *last = nullptr;
+#pragma omp for schedule(dynamic, 256)
+    for(std::size_t k = 0; k < n; k++) {
+      std::size_t i = order[k];
+      double P[3] = {xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]};
+      double *val = &values[i * numVal];
+      bool ok = false;
+      if(m) {
+        last = _walk(P, step, last, dim);
+        ok = _getValue(last, nbComp, P, step, val, nullptr, grad);
+      }
+      else if(nbComp == 1)
+        ok = searchScalar(P[0], P[1], P[2], val, step, nullptr, 0, nullptr,
+                          nullptr, nullptr, grad, dim);
+      else if(nbComp == 3)
+        ok = searchVector(P[0], P[1], P[2], val, step, nullptr, 0, nullptr,
+                          nullptr, nullptr, grad, dim);
+      else if(nbComp == 9)
+        ok = searchTensor(P[0], P[1], P[2], val, step, nullptr, 0, nullptr,
+                          nullptr, nullptr, grad, dim);
+      found[i] = ok ? 1 : 0;
+    }
+  }
+}
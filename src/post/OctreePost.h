@@ -6,12 +6,16 @@
 #ifndef OCTREE_POST_H
 #define OCTREE_POST_H
 
+#include <atomic>
+#include <vector>
 #include "Octree.h"
 
 class PView;
 class PViewData;
 class PViewDataList;
 class PViewDataGModel;
+class MElement;
+class elementNeighbours;
 
 class OctreePost {
 private:
@@ -25,7 +29,12 @@ private:
   Octree *_sy, *_vy, *_ty;
   PViewDataList *_theViewDataList;
   PViewDataGModel *_theViewDataGModel;
+  std::atomic<elementNeighbours *> _neighbours;
   void _create(PViewData *data);
+  elementNeighbours *_getNeighbours();
+  MElement *_walk(double P[3], int step, MElement *hint, int dim = -1);
+  bool _search(double P[3], int nbComp, double *values, int step,
+               MElement *&hint);
   bool _getValue(void *in, int dim, int nbNod, int nbComp, double P[3],
                  int step, double *values, double *elementSize, bool grad);
   bool _getValue(void *in, int nbComp, double P[3], int step, double *values,
@@ -56,6 +65,29 @@ public:
                     double *size = nullptr, int qn = 0, double *qx = nullptr,
                     double *qy = nullptr, double *qz = nullptr,
                     bool grad = false, int dim = -1);
+  // same as searchScalar and searchVector, but for model-based views first
+  // look for the element containing the point by walking through the face (or
+  // edge) neighbours of the element `hint' found for a nearby point, and only
+  // search the element locator if the walk fails. `hint' is updated with the
+  // element found, and should be set to nullptr for the first point of a
+  // path. For list-based views `hint' is ignored. Can be called concurrently,
+  // with one hint per thread.
+  bool searchScalar(double x, double y, double z, double *values, int step,
+                    MElement *&hint);
+  bool searchVector(double x, double y, double z, double *values, int step,
+                    MElement *&hint);
+  // search for the values of the View at a batch of points, given by their
+  // coordinates xyz = [p1x, p1y, p1z, p2x, ...], for data with nbComp (1, 3 or
+  // 9) components. The points are searched concurrently, in spatial (Morton)
+  // order, so that for model-based views the element containing each point
+  // is found by walking from the element found for the previous point (see
+  // the hint-based searchScalar), before searching the element locator. The
+  // values for the i-th point are stored in values[i * n], where n is the
+  // number of values returned by searchScalar, searchVector or searchTensor for
+  // a single point, and found[i] is set to 0 if no value is found.
+  void search(const std::vector<double> &xyz, int nbComp,
+              std::vector<double> &values, std::vector<char> &found,
+              int step = -1, bool grad = false, int dim = -1);
 };
 
 #endif
@@ -7,6 +7,7 @@
 #include "adaptiveData.h"
 #include "Numeric.h"
 #include "GmshMessage.h"
+#include "Context.h"
 #include "OctreePost.h"
 #include "fullMatrix.h"
 
@@ -23,7 +24,8 @@ PViewData::~PViewData()
   if(_adaptive) delete _adaptive;
   for(auto it = _interpolation.begin(); it != _interpolation.end(); it++)
     for(std::size_t i = 0; i < it->second.size(); i++) delete it->second[i];
-  if(_octree) delete _octree;
+  OctreePost *octree = _octree.load();
+  if(octree) delete octree;
   if(_kdtree) delete _kdtree;
 }
 
@@ -121,6 +123,42 @@ void PViewData::getScalarValue(int step, int ent, int ele, int nod, double &val,
   }
 }
 
+void PViewDataCursor::getScalarValue(int nod, double &val, int tensorRep) const
+{
+  if(_numComponents == 1) {
+    getValue(nod, 0, val);
+    return;
+  }
+  double d[9];
+  int numComp = std::min(_numComponents, 9);
+  for(int comp = 0; comp < numComp; comp++) getValue(nod, comp, d[comp]);
+  val = ComputeScalarRep(numComp, d, tensorRep);
+}
+
+void PViewData::setCursor(PViewDataCursor &c, int step, int ent, int ele)
+{
+  // generic implementation, using the element accessors
+#pragma omp critical(PViewDataSetCursor)
+  {
+    c._dim = getDimension(step, ent, ele);
+    c._numNodes = getNumNodes(step, ent, ele);
+    c._numComponents = getNumComponents(step, ent, ele);
+    c._numValues = getNumValues(step, ent, ele);
+    c._numEdges = getNumEdges(step, ent, ele);
+    c._type = getType(step, ent, ele);
+    c._xyzBuffer.resize(3 * c._numNodes);
+    for(int nod = 0; nod < c._numNodes; nod++)
+      getNode(step, ent, ele, nod, c._xyzBuffer[nod],
+              c._xyzBuffer[c._numNodes + nod],
+              c._xyzBuffer[2 * c._numNodes + nod]);
+    c._valBuffer.resize(c._numValues);
+    for(int idx = 0; idx < c._numValues; idx++)
+      getValue(step, ent, ele, idx, c._valBuffer[idx]);
+  }
+  c._xyz = c._xyzBuffer.data();
+  c._val = c._valBuffer.data();
+}
+
 void PViewData::setNode(int step, int ent, int ele, int nod, double x, double y,
                         double z)
 {
@@ -319,19 +357,29 @@ double PViewData::findClosestNode(double &xn, double &yn, double &zn, int step)
 #endif
 }
 
-bool PViewData::searchScalar(double x, double y, double z, double *values,
-                             int step, double *size, int qn, double *qx,
-                             double *qy, double *qz, bool grad, int dim)
+OctreePost *PViewData::_getOctree()
 {
-  if(!_octree) {
-#pragma omp barrier
-#pragma omp single
-    {
+  // the octree is built by the first caller; concurrent callers wait until it
+  // is available, and then only perform read-only queries
+  OctreePost *octree = _octree.load(std::memory_order_acquire);
+  if(octree) return octree;
+#pragma omp critical(PViewDataOctree)
+  {
+    octree = _octree.load(std::memory_order_acquire);
+    if(!octree) {
       Msg::Debug("Rebuilding octree for view data '%s'", _name.c_str());
-      _octree = new OctreePost(this);
+      octree = new OctreePost(this);
+      _octree.store(octree, std::memory_order_release);
     }
   }
-  return _octree->searchScalar(x, y, z, values, step, size, qn, qx, qy, qz,
+  return octree;
+}
+
+bool PViewData::searchScalar(double x, double y, double z, double *values,
+                             int step, double *size, int qn, double *qx,
+                             double *qy, double *qz, bool grad, int dim)
+{
+  return _getOctree()->searchScalar(x, y, z, values, step, size, qn, qx, qy, qz,
                                grad, dim);
 }
 
@@ -363,15 +411,7 @@ bool PViewData::searchVector(double x, double y, double z, double *values,
                              int step, double *size, int qn, double *qx,
                              double *qy, double *qz, bool grad, int dim)
 {
-  if(!_octree) {
-#pragma omp barrier
-#pragma omp single
-    {
-      Msg::Debug("Rebuilding octree for view data '%s'", _name.c_str());
-      _octree = new OctreePost(this);
-    }
-  }
-  return _octree->searchVector(x, y, z, values, step, size, qn, qx, qy, qz,
+  return _getOctree()->searchVector(x, y, z, values, step, size, qn, qx, qy, qz,
                                grad, dim);
 }
 
@@ -403,15 +443,7 @@ bool PViewData::searchTensor(double x, double y, double z, double *values,
                              int step, double *size, int qn, double *qx,
                              double *qy, double *qz, bool grad, int dim)
 {
-  if(!_octree) {
-#pragma omp barrier
-#pragma omp single
-    {
-      Msg::Debug("Rebuilding octree for view data '%s'", _name.c_str());
-      _octree = new OctreePost(this);
-    }
-  }
-  return _octree->searchTensor(x, y, z, values, step, size, qn, qx, qy, qz,
+  return _getOctree()->searchTensor(x, y, z, values, step, size, qn, qx, qy, qz,
                                grad, dim);
 }
 
@@ -438,3 +470,41 @@ bool PViewData::searchTensorClosest(double x, double y, double z,
   }
   return ret;
 }
+
+void PViewData::searchClosest(const std::vector<double> &xyz, int numComp,
+                              double distanceMax, std::vector<double> &distance,
+                              std::vector<double> &values, int step, bool grad,
+                              int dim)
+{
+  std::size_t n = xyz.size() / 3;
+  std::vector<char> found;
+  _getOctree()->search(xyz, numComp, values, found, step, grad, dim);
+  distance.assign(n, 0.);
+  if(!n) return;
+  std::size_t numVal = values.size() / n;
+
+  // fall back to the closest node for the points that were not found
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 64)
+  for(std::size_t i = 0; i < n; i++) {
+    if(found[i]) continue;
+    distance[i] = -1.;
+    if(!distanceMax) continue;
+    double xn = xyz[3 * i], yn = xyz[3 * i + 1], zn = xyz[3 * i + 2];
+    double d = findClosestNode(xn, yn, zn, step);
+    if(d < 0. || (distanceMax > 0. && d > distanceMax)) continue;
+    double *val = &values[i * numVal];
+    bool ok = false;
+    if(numComp == 1)
+      ok = searchScalar(xn, yn, zn, val, step, nullptr, 0, nullptr, nullptr,
+                        nullptr, grad, dim);
+    else if(numComp == 3)
+      ok = searchVector(xn, yn, zn, val, step, nullptr, 0, nullptr, nullptr,
+                        nullptr, grad, dim);
+    else if(numComp == 9)
+      ok = searchTensor(xn, yn, zn, val, step, nullptr, 0, nullptr, nullptr,
+                        nullptr, grad, dim);
+    if(ok) distance[i] = d;
+  }
+}
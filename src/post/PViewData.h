@@ -6,6 +6,7 @@
 #ifndef PVIEW_DATA_H
 #define PVIEW_DATA_H
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
@@ -25,6 +26,56 @@ template <class scalar> class fullMatrix;
 
 typedef std::map<int, std::vector<fullMatrix<double> *> > interpolationMatrices;
 
+// A cursor on an element of a dataset, at a given time step: it gives access to
+// the coordinates of the nodes of the element and to its values, which are
+// either stored in the cursor or directly pointed to in the dataset. Contrary
+// to the element accessors of PViewData (which are not thread-safe, as
+// datasets can cache the current element), cursors allow to iterate
+// concurrently over the elements of a dataset, with one cursor per thread, as
+// long as the dataset is not modified.
+class PViewDataCursor {
+  friend class PViewData;
+  friend class PViewDataList;
+  friend class PViewDataGModel;
+
+private:
+  int _dim, _numNodes, _numComponents, _numValues, _numEdges, _type;
+  // coordinates of the nodes (x of all the nodes, then y, then z) and values
+  double *_xyz, *_val;
+  // storage of the coordinates and values, if they are not pointed to
+  std::vector<double> _xyzBuffer, _valBuffer;
+
+public:
+  PViewDataCursor()
+    : _dim(0), _numNodes(0), _numComponents(0), _numValues(0), _numEdges(0),
+      _type(0), _xyz(nullptr), _val(nullptr)
+  {
+  }
+  int getDimension() const { return _dim; }
+  int getNumNodes() const { return _numNodes; }
+  int getNumComponents() const { return _numComponents; }
+  int getNumValues() const { return _numValues; }
+  int getNumEdges() const { return _numEdges; }
+  int getType() const { return _type; }
+  void getNode(int nod, double &x, double &y, double &z) const
+  {
+    x = _xyz[nod];
+    y = _xyz[_numNodes + nod];
+    z = _xyz[2 * _numNodes + nod];
+  }
+  // get the idx'th value
+  void getValue(int idx, double &val) const { val = _val[idx]; }
+  // get the comp-th component associated with the nod-th node (elements with
+  // less values than nodes return the values of the first node)
+  void getValue(int nod, int comp, double &val) const
+  {
+    if((nod + 1) * _numComponents > _numValues) nod = 0;
+    val = _val[nod * _numComponents + comp];
+  }
+  // same as PViewData::getScalarValue
+  void getScalarValue(int nod, double &val, int tensorRep = 0) const;
+};
+
 // The abstract interface to post-processing view data.
 class PViewData {
 private:
@@ -37,12 +88,13 @@ private:
   std::set<std::string> _fileNames;
   // index of the view in the file
   int _fileIndex;
-  // octree for rapid search
-  OctreePost *_octree;
+  // octree for rapid search, built on first use (see _getOctree)
+  std::atomic<OctreePost *> _octree;
   // kdtree for rapid search of neighrest neighbor
   SPoint3Cloud _pc;
   SPoint3CloudAdaptor<SPoint3Cloud> _pc2kdtree;
   SPoint3KDTree *_kdtree;
+  OctreePost *_getOctree();
 
 protected:
   // adaptive visualization data
@@ -182,6 +234,11 @@ public:
   // return the type of the ele-th element in the ent-th entity
   virtual int getType(int step, int ent, int ele) { return 0; }
 
+  // set the cursor on the ele-th element in the ent-th entity, at the step-th
+  // time step; this does not modify the dataset, and can thus be called
+  // concurrently with different cursors
+  virtual void setCursor(PViewDataCursor &c, int step, int ent, int ele);
+
   // return the number of 2D/3D strings in the view
   virtual int getNumStrings2D() { return 0; }
   virtual int getNumStrings3D() { return 0; }
@@ -338,6 +395,17 @@ public:
                            double *qy = nullptr, double *qz = nullptr,
                            bool grad = false, int dim = -1);
 
+  // same as above for a batch of points xyz = [p1x, p1y, p1z, p2x, ...] and
+  // for data with numComp (1, 3 or 9) components: the points are searched
+  // concurrently, and the values for the i-th point are stored in values[i *
+  // n], where n is the number of values returned for a single point. Upon
+  // return, distance[i] contains the distance of the match, or -1 if no match
+  // was found (in which case the values are set to zero)
+  void searchClosest(const std::vector<double> &xyz, int numComp,
+                     double distanceMax, std::vector<double> &distance,
+                     std::vector<double> &values, int step = -1,
+                     bool grad = false, int dim = -1);
+
   // I/O routines
   virtual bool writeSTL(const std::string &fileName);
   virtual bool writeTXT(const std::string &fileName);
@@ -16,6 +16,7 @@
 #include "MElementCut.h"
 #include "Numeric.h"
 #include "GmshMessage.h"
+#include "Context.h"
 #include "pyramidalBasis.h"
 
 PViewDataGModel::PViewDataGModel(DataType type)
@@ -108,15 +109,31 @@ bool PViewDataGModel::finalize(bool computeMinMax,
         }
       }
       else {
-        // general case (slower)
+        // general case (slower), in parallel over the elements of each entity
+        int nthreads = CTX::instance()->numThreads;
+        if(!nthreads) nthreads = Msg::GetMaxThreads();
+        stepData<double> *sd = _steps[step];
         for(int ent = 0; ent < getNumEntities(step); ent++) {
-          for(int ele = 0; ele < getNumElements(step, ent); ele++) {
-            if(skipElement(step, ent, ele)) continue;
-            for(int nod = 0; nod < getNumNodes(step, ent, ele); nod++) {
-              double val;
-              getScalarValue(step, ent, ele, nod, val, tensorRep);
-              _steps[step]->setMin(std::min(_steps[step]->getMin(), val));
-              _steps[step]->setMax(std::max(_steps[step]->getMax(), val));
+          int numEle = getNumElements(step, ent);
+#pragma omp parallel num_threads(nthreads)
+          {
+            PViewDataCursor c;
+            double vmin = VAL_INF, vmax = -VAL_INF;
+#pragma omp for schedule(static)
+            for(int ele = 0; ele < numEle; ele++) {
+              if(skipElement(step, ent, ele)) continue;
+              setCursor(c, step, ent, ele);
+              for(int nod = 0; nod < c.getNumNodes(); nod++) {
+                double val;
+                c.getScalarValue(nod, val, tensorRep);
+                vmin = std::min(vmin, val);
+                vmax = std::max(vmax, val);
+              }
+            }
+#pragma omp critical
+            {
+              sd->setMin(std::min(sd->getMin(), vmin));
+              sd->setMax(std::max(sd->getMax(), vmax));
             }
           }
         }
@@ -254,11 +271,7 @@ bool PViewDataGModel::finalize(bool computeMinMax,
 
 MElement *PViewDataGModel::_getElement(int step, int ent, int ele)
 {
-  static int lastStep = -1, lastEnt = -1, lastEle = -1;
-  static MElement *curr = nullptr;
-  if(step != lastStep || ent != lastEnt || ele != lastEle)
-    curr = _steps[step]->getEntity(ent)->getMeshElement(ele);
-  return curr;
+  return _steps[step]->getEntity(ent)->getMeshElement(ele);
 }
 
 std::string PViewDataGModel::getFileName(int step)
@@ -519,7 +532,11 @@ int PViewDataGModel::getDimension(int step, int ent, int ele)
 
 int PViewDataGModel::getNumNodes(int step, int ent, int ele)
 {
-  MElement *e = _getElement(step, ent, ele);
+  return _getNumNodes(step, _getElement(step, ent, ele));
+}
+
+int PViewDataGModel::_getNumNodes(int step, MElement *e)
+{
   if(_type == GaussPointData) {
     return _steps[step]->getGaussPoints(e->getTypeForMSH()).size() / 3;
   }
@@ -546,7 +563,12 @@ MVertex *PViewDataGModel::_getNode(MElement *e, int nod)
 int PViewDataGModel::getNode(int step, int ent, int ele, int nod, double &x,
                              double &y, double &z)
 {
-  MElement *e = _getElement(step, ent, ele);
+  return _getNode(step, _getElement(step, ent, ele), nod, x, y, z);
+}
+
+int PViewDataGModel::_getNode(int step, MElement *e, int nod, double &x,
+                              double &y, double &z)
+{
   MVertex *v = _getNode(e, nod);
   if(_type == GaussPointData) {
     std::vector<double> &p(_steps[step]->getGaussPoints(e->getTypeForMSH()));
@@ -702,6 +724,45 @@ int PViewDataGModel::getType(int step, int ent, int ele)
   return _getElement(step, ent, ele)->getType();
 }
 
+void PViewDataGModel::setCursor(PViewDataCursor &c, int step, int ent,
+                                int ele)
+{
+  MElement *e = _getElement(step, ent, ele);
+  stepData<double> *sd = _steps[step];
+  c._dim = e->getDim();
+  c._numNodes = _getNumNodes(step, e);
+  c._numComponents = sd->getNumComponents();
+  c._numEdges = e->getNumEdges();
+  c._type = e->getType();
+  c._xyzBuffer.resize(3 * c._numNodes);
+  for(int nod = 0; nod < c._numNodes; nod++)
+    _getNode(step, e, nod, c._xyzBuffer[nod], c._xyzBuffer[c._numNodes + nod],
+             c._xyzBuffer[2 * c._numNodes + nod]);
+  c._xyz = c._xyzBuffer.data();
+  int numComp = c._numComponents;
+  if(_type == NodeData) {
+    c._numValues = c._numNodes * numComp;
+    c._valBuffer.assign(c._numValues, 0.);
+    for(int nod = 0; nod < c._numNodes; nod++) {
+      double *d = sd->getData(_getNode(e, nod)->getNum());
+      if(d)
+        for(int comp = 0; comp < numComp; comp++)
+          c._valBuffer[nod * numComp + comp] = d[comp];
+    }
+    c._val = c._valBuffer.data();
+  }
+  else {
+    // the values of the element are stored contiguously
+    c._numValues = (_type == ElementData ? 1 : sd->getMult(e->getNum())) *
+                   numComp;
+    c._val = sd->getData(e->getNum());
+    if(!c._val) {
+      c._valBuffer.assign(c._numValues, 0.);
+      c._val = c._valBuffer.data();
+    }
+  }
+}
+
 void PViewDataGModel::reverseElement(int step, int ent, int ele)
 {
   if(!step) _getElement(step, ent, ele)->reverse();
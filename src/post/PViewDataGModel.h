@@ -6,6 +6,7 @@
 #ifndef PVIEW_DATA_GMODEL_H
 #define PVIEW_DATA_GMODEL_H
 
+#include <algorithm>
 #include "PViewData.h"
 #include "GModel.h"
 #include "SBoundingBox3d.h"
@@ -27,18 +28,20 @@ private:
   // the number of components in the data (one stepData contains only
   // a single field type)
   int _numComp;
-  // the values, indexed by MVertex or MElement id numbers (If the
-  // numbering is sparse, or if we only have data for high-id
-  // entities, the vector has zero entries and is thus not
-  // optimal. This is the price to pay if we want 1) rapid access to
-  // the data and 2) not to store any additional info in MVertex or
-  // MElement)
-  //
-  // FIXME: we should change this design and store a vector<int> of tags, and do
-  // indirect addressing, even if it's a bit slower...
-  std::vector<Real *> *_data;
+  // the values, indexed by MVertex or MElement id numbers, stored
+  // contiguously: the values for index i start at _values[_offset[i] - 1],
+  // with _offset[i] == 0 if there are no values for i. (If the numbering is
+  // sparse, or if we only have data for high-id entities, the offset vector has
+  // zero entries and is thus not optimal. This is the price to pay if we want
+  // 1) rapid access to the data and 2) not to store any additional info in
+  // MVertex or MElement.) Values are appended in the order they are allocated,
+  // so that pointers returned by getData() are only valid until the next
+  // allocation. Reallocating an index with a larger multiplicity leaves its
+  // previous values unused in _values.
+  std::vector<Real> _values;
+  std::vector<std::size_t> _offset;
   // a vector containing the multiplying factor allowing to compute
-  // the number of values stored in _data for each index (number of
+  // the number of values stored in _values for each index (number of
   // values = getMult() * getNumComponents()). If _mult is empty, a
   // default value of "1" is assumed
   std::vector<int> _mult;
@@ -53,10 +56,10 @@ public:
            int fileIndex = -1, double time = 0., double min = VAL_INF,
            double max = -VAL_INF)
     : _model(model), _fileName(fileName), _fileIndex(fileIndex), _time(time),
-      _min(min), _max(max), _numComp(numComp), _data(0)
+      _min(min), _max(max), _numComp(numComp)
   {
   }
-  stepData(stepData<Real> &other) : _data(0)
+  stepData(stepData<Real> &other)
   {
     _model = other._model;
     _entities = other._entities;
@@ -67,18 +70,8 @@ public:
     _min = other._min;
     _max = other._max;
     _numComp = other._numComp;
-    if(other._data) {
-      std::size_t n = other.getNumData();
-      _data = new std::vector<Real *>(n, (Real *)0);
-      for(std::size_t i = 0; i < n; i++) {
-        Real *d = other.getData(i);
-        if(d) {
-          int m = other.getMult(i) * _numComp;
-          (*_data)[i] = new Real[m];
-          for(int j = 0; j < m; j++) (*_data)[i][j] = d[j];
-        }
-      }
-    }
+    _values = other._values;
+    _offset = other._offset;
     _mult = other._mult;
     _gaussPoints = other._gaussPoints;
     _partitions = other._partitions;
@@ -106,24 +99,34 @@ public:
   void setMin(double min) { _min = min; }
   double getMax() { return _max; }
   void setMax(double max) { _max = max; }
-  std::size_t getNumData()
-  {
-    if(!_data) return 0;
-    return _data->size();
-  }
+  std::size_t getNumData() { return _offset.size(); }
+  // make room for n indices, and reserve space for the values of n more
+  // indices (readers call this with the number of records they will add)
   void resizeData(int n)
   {
-    if(!_data) _data = new std::vector<Real *>(n, (Real *)0);
-    if(n > (int)_data->size()) _data->resize(n, (Real *)0);
+    if(n > (int)_offset.size()) _offset.resize(n, 0);
+    std::size_t size = _values.size() + (std::size_t)n * _numComp;
+    if(size > _values.capacity())
+      _values.reserve(std::max(size, 2 * _values.capacity()));
   }
   Real *getData(int index, bool allocIfNeeded = false, int mult = 1)
   {
     if(index < 0) return 0;
     if(allocIfNeeded) {
-      if(index >= (int)getNumData()) resizeData(index + 100); // optimize this
-      if(!(*_data)[index]) {
-        (*_data)[index] = new Real[_numComp * mult];
-        for(int i = 0; i < _numComp * mult; i++) (*_data)[index][i] = 0.;
+      if(index >= (int)getNumData())
+        _offset.resize(index + 100, 0); // optimize this
+      int n = _numComp * mult;
+      int old = _offset[index] ? _numComp * getMult(index) : 0;
+      if(!_offset[index] || old < n) {
+        // the values are moved to a new block at the end; the old block is
+        // not reused until the data is destroyed
+        std::size_t offset = _values.size();
+        _values.resize(offset + n, 0.);
+        if(old)
+          std::copy(_values.begin() + _offset[index] - 1,
+                    _values.begin() + _offset[index] - 1 + old,
+                    _values.begin() + offset);
+        _offset[index] = offset + 1;
       }
       if(mult > 1) {
         if(index >= (int)_mult.size())
@@ -132,22 +135,35 @@ public:
       }
     }
     else {
-      if(index >= (int)getNumData()) return 0;
+      if(index >= (int)getNumData() || !_offset[index]) return 0;
     }
-    return (*_data)[index];
+    return _values.data() + _offset[index] - 1;
   }
-  void destroyData()
+  // allocate the values for all the indices in tags, each with multiplicity
+  // mult, in a single contiguous block; return a pointer to the block, where
+  // the values for tags[i] start at i * mult * getNumComponents()
+  Real *getData(const std::vector<std::size_t> &tags, int mult)
   {
-    if(_data) {
-      for(unsigned int i = 0; i < _data->size(); i++)
-        if((*_data)[i]) delete[](*_data)[i];
-      delete _data;
-      _data = 0;
+    if(tags.empty()) return 0;
+    std::size_t imax = *std::max_element(tags.begin(), tags.end());
+    if(imax >= getNumData()) _offset.resize(imax + 1, 0);
+    if(mult > 1 && imax >= _mult.size()) _mult.resize(imax + 1, 1);
+    std::size_t n = (std::size_t)_numComp * mult, offset = _values.size();
+    _values.resize(offset + tags.size() * n, 0.);
+    for(std::size_t i = 0; i < tags.size(); i++) {
+      _offset[tags[i]] = offset + i * n + 1;
+      if(mult > 1) _mult[tags[i]] = mult;
     }
+    return _values.data() + offset;
+  }
+  void destroyData()
+  {
+    std::vector<Real>().swap(_values);
+    std::vector<std::size_t>().swap(_offset);
   }
   void renumberData(const std::map<int, int> &mapping)
   {
-    if(!_data) return;
+    if(_offset.empty()) return;
     int imax = 0, imin = 0;
     for(auto m : mapping) {
       imax = std::max(imax, m.second);
@@ -157,11 +173,11 @@ public:
       Msg::Warning("Wrong destination index %d in step data renumbering", imin);
       return;
     }
-    std::vector<Real *> data2(imax + 1, nullptr);
+    std::vector<std::size_t> offset2(imax + 1, 0);
     std::vector<int> mult2(imax + 1, 1);
     for(auto m : mapping) {
-      if(m.first >= 0 && m.first < (int)_data->size()) {
-        data2[m.second] = (*_data)[m.first];
+      if(m.first >= 0 && m.first < (int)_offset.size()) {
+        offset2[m.second] = _offset[m.first];
       }
       else {
         Msg::Warning("Wrong source index %d in step data renumbering", m.first);
@@ -170,7 +186,7 @@ public:
       if(m.first >= 0 && m.first < (int)_mult.size())
         mult2[m.second] = _mult[m.first];
     }
-    *_data = data2;
+    _offset = offset2;
     _mult = mult2;
   }
   std::vector<double> &getGaussPoints(int msh)
@@ -181,9 +197,10 @@ public:
   std::set<int> &getPartitions() { return _partitions; }
   double getMemoryInMb()
   {
-    double b = 0.;
-    for(std::size_t i = 0; i < getNumData(); i++) b += getMult(i);
-    return b * getNumComponents() * sizeof(Real) / 1024. / 1024.;
+    double b = _values.capacity() * sizeof(Real) +
+               _offset.capacity() * sizeof(std::size_t) +
+               _mult.capacity() * sizeof(int);
+    return b / 1024. / 1024.;
   }
 };
 
@@ -208,6 +225,9 @@ private:
   // cache last element to speed up loops
   MElement *_getElement(int step, int ent, int ele);
   MVertex *_getNode(MElement *e, int nod);
+  int _getNumNodes(int step, MElement *e);
+  int _getNode(int step, MElement *e, int nod, double &x, double &y,
+               double &z);
 
 public:
   PViewDataGModel(DataType type = NodeData);
@@ -256,6 +276,7 @@ public:
   void setValue(int step, int ent, int ele, int node, int comp, double val);
   int getNumEdges(int step, int ent, int ele);
   int getType(int step, int ent, int ele);
+  void setCursor(PViewDataCursor &c, int step, int ent, int ele);
   void reverseElement(int step, int ent, int ele);
   void smooth();
   double getMemoryInMb();
@@ -117,11 +117,14 @@ bool PViewDataGModel::addData(GModel *model,
   _steps[step]->resizeData(numEnt);
 
   int mult = stride / numComp;
-  for(std::size_t i = 0; i < tags.size(); i++) {
-    double *d = _steps[step]->getData(tags[i], true, mult);
-    int k = i * stride;
-    for(std::size_t j = 0; j < stride; j++) d[j] = data[k + j];
-  }
+  std::size_t n = numComp * mult;
+  double *d = _steps[step]->getData(tags, mult);
+  if(n == stride)
+    std::copy(data.begin(), data.begin() + tags.size() * n, d);
+  else
+    for(std::size_t i = 0; i < tags.size(); i++)
+      std::copy(data.begin() + i * stride, data.begin() + i * stride + n,
+                d + i * n);
   if(partition >= 0) _steps[step]->getPartitions().insert(partition);
   finalize();
   return true;
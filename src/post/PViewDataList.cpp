@@ -20,9 +20,7 @@ PViewDataList::PViewDataList(bool isAdapted)
     NbVQ(0), NbTQ(0), NbSG(0), NbVG(0), NbTG(0), NbSS(0), NbVS(0), NbTS(0),
     NbSH(0), NbVH(0), NbTH(0), NbSI(0), NbVI(0), NbTI(0), NbSY(0), NbVY(0),
     NbTY(0), NbSR(0), NbVR(0), NbTR(0), NbSD(0), NbVD(0), NbTD(0), NbT2(0),
-    NbT3(0), _lastElement(-1), _lastDimension(-1), _lastNumNodes(-1),
-    _lastNumComponents(-1), _lastNumValues(-1), _lastNumEdges(-1),
-    _lastType(-1), _lastXYZ(nullptr), _lastVal(nullptr), _isAdapted(isAdapted)
+    NbT3(0), _lastElement(-1), _isAdapted(isAdapted)
 {
   for(int i = 0; i < 33; i++) _index[i] = 0;
   polyTotNumNodes[0] = 0.;
@@ -312,19 +310,20 @@ void PViewDataList::_stat(std::vector<double> &list, int nbcomp, int nbelm,
   }
 }
 
-void PViewDataList::_setLast(int ele, int dim, int nbnod, int nbcomp, int nbedg,
-                             int type, std::vector<double> &list, int nblist)
+void PViewDataList::_setCursor(PViewDataCursor &c, int ele, int dim, int nbnod,
+                               int nbcomp, int nbedg, int type,
+                               std::vector<double> &list, int nblist)
 {
   if(haveInterpolationMatrices()) {
     std::vector<fullMatrix<double> *> im;
     if(getInterpolationMatrices(type, im) == 4) nbnod = im[2]->size1();
   }
 
-  _lastDimension = dim;
-  _lastNumNodes = nbnod;
-  _lastNumComponents = nbcomp;
-  _lastNumEdges = nbedg;
-  _lastType = type;
+  c._dim = dim;
+  c._numNodes = nbnod;
+  c._numComponents = nbcomp;
+  c._numEdges = nbedg;
+  c._type = type;
   int nb = list.size() / nblist; // number of coords and values for the element
   int nbAg =
     ele * nb; // number of coords and values before the ones of the element
@@ -333,125 +332,130 @@ void PViewDataList::_setLast(int ele, int dim, int nbnod, int nbcomp, int nbedg,
     nb = list.size() / polyTotNumNodes[t] * nbnod;
     nbAg = polyAgNumNodes[t][ele] * nb / nbnod;
   }
-  _lastNumValues = (nb - 3 * nbnod) / NbTimeStep;
-  _lastXYZ = &list[nbAg];
-  _lastVal = &list[nbAg + 3 * _lastNumNodes];
+  c._numValues = (nb - 3 * nbnod) / NbTimeStep;
+  c._xyz = &list[nbAg];
+  c._val = &list[nbAg + 3 * nbnod];
 }
 
 void PViewDataList::_setLast(int ele)
 {
   _lastElement = ele;
+  _setCursor(_last, ele);
+}
+
+void PViewDataList::_setCursor(PViewDataCursor &c, int ele)
+{
   if(ele < _index[2]) { // points
     if(ele < _index[0])
-      _setLast(ele, 0, 1, 1, 0, TYPE_PNT, SP, NbSP);
+      _setCursor(c, ele, 0, 1, 1, 0, TYPE_PNT, SP, NbSP);
     else if(ele < _index[1])
-      _setLast(ele - _index[0], 0, 1, 3, 0, TYPE_PNT, VP, NbVP);
+      _setCursor(c, ele - _index[0], 0, 1, 3, 0, TYPE_PNT, VP, NbVP);
     else
-      _setLast(ele - _index[1], 0, 1, 9, 0, TYPE_PNT, TP, NbTP);
+      _setCursor(c, ele - _index[1], 0, 1, 9, 0, TYPE_PNT, TP, NbTP);
   }
   else if(ele < _index[5]) { // lines
     if(ele < _index[3])
-      _setLast(ele - _index[2], 1, 2, 1, 1, TYPE_LIN, SL, NbSL);
+      _setCursor(c, ele - _index[2], 1, 2, 1, 1, TYPE_LIN, SL, NbSL);
     else if(ele < _index[4])
-      _setLast(ele - _index[3], 1, 2, 3, 1, TYPE_LIN, VL, NbVL);
+      _setCursor(c, ele - _index[3], 1, 2, 3, 1, TYPE_LIN, VL, NbVL);
     else
-      _setLast(ele - _index[4], 1, 2, 9, 1, TYPE_LIN, TL, NbTL);
+      _setCursor(c, ele - _index[4], 1, 2, 9, 1, TYPE_LIN, TL, NbTL);
   }
   else if(ele < _index[8]) { // triangles
     if(ele < _index[6])
-      _setLast(ele - _index[5], 2, 3, 1, 3, TYPE_TRI, ST, NbST);
+      _setCursor(c, ele - _index[5], 2, 3, 1, 3, TYPE_TRI, ST, NbST);
     else if(ele < _index[7])
-      _setLast(ele - _index[6], 2, 3, 3, 3, TYPE_TRI, VT, NbVT);
+      _setCursor(c, ele - _index[6], 2, 3, 3, 3, TYPE_TRI, VT, NbVT);
     else
-      _setLast(ele - _index[7], 2, 3, 9, 3, TYPE_TRI, TT, NbTT);
+      _setCursor(c, ele - _index[7], 2, 3, 9, 3, TYPE_TRI, TT, NbTT);
   }
   else if(ele < _index[11]) { // quadrangles
     if(ele < _index[9])
-      _setLast(ele - _index[8], 2, 4, 1, 4, TYPE_QUA, SQ, NbSQ);
+      _setCursor(c, ele - _index[8], 2, 4, 1, 4, TYPE_QUA, SQ, NbSQ);
     else if(ele < _index[10])
-      _setLast(ele - _index[9], 2, 4, 3, 4, TYPE_QUA, VQ, NbVQ);
+      _setCursor(c, ele - _index[9], 2, 4, 3, 4, TYPE_QUA, VQ, NbVQ);
     else
-      _setLast(ele - _index[10], 2, 4, 9, 4, TYPE_QUA, TQ, NbTQ);
+      _setCursor(c, ele - _index[10], 2, 4, 9, 4, TYPE_QUA, TQ, NbTQ);
   }
   else if(ele < _index[14]) { // tetrahedra
     if(ele < _index[12])
-      _setLast(ele - _index[11], 3, 4, 1, 6, TYPE_TET, SS, NbSS);
+      _setCursor(c, ele - _index[11], 3, 4, 1, 6, TYPE_TET, SS, NbSS);
     else if(ele < _index[13])
-      _setLast(ele - _index[12], 3, 4, 3, 6, TYPE_TET, VS, NbVS);
+      _setCursor(c, ele - _index[12], 3, 4, 3, 6, TYPE_TET, VS, NbVS);
     else
-      _setLast(ele - _index[13], 3, 4, 9, 6, TYPE_TET, TS, NbTS);
+      _setCursor(c, ele - _index[13], 3, 4, 9, 6, TYPE_TET, TS, NbTS);
   }
   else if(ele < _index[17]) { // hexahedra
     if(ele < _index[15])
-      _setLast(ele - _index[14], 3, 8, 1, 12, TYPE_HEX, SH, NbSH);
+      _setCursor(c, ele - _index[14], 3, 8, 1, 12, TYPE_HEX, SH, NbSH);
     else if(ele < _index[16])
-      _setLast(ele - _index[15], 3, 8, 3, 12, TYPE_HEX, VH, NbVH);
+      _setCursor(c, ele - _index[15], 3, 8, 3, 12, TYPE_HEX, VH, NbVH);
     else
-      _setLast(ele - _index[16], 3, 8, 9, 12, TYPE_HEX, TH, NbTH);
+      _setCursor(c, ele - _index[16], 3, 8, 9, 12, TYPE_HEX, TH, NbTH);
   }
   else if(ele < _index[20]) { // prisms
     if(ele < _index[18])
-      _setLast(ele - _index[17], 3, 6, 1, 9, TYPE_PRI, SI, NbSI);
+      _setCursor(c, ele - _index[17], 3, 6, 1, 9, TYPE_PRI, SI, NbSI);
     else if(ele < _index[19])
-      _setLast(ele - _index[18], 3, 6, 3, 9, TYPE_PRI, VI, NbVI);
+      _setCursor(c, ele - _index[18], 3, 6, 3, 9, TYPE_PRI, VI, NbVI);
     else
-      _setLast(ele - _index[19], 3, 6, 9, 9, TYPE_PRI, TI, NbTI);
+      _setCursor(c, ele - _index[19], 3, 6, 9, 9, TYPE_PRI, TI, NbTI);
   }
   else if(ele < _index[23]) { // pyramids
     if(ele < _index[21])
-      _setLast(ele - _index[20], 3, 5, 1, 8, TYPE_PYR, SY, NbSY);
+      _setCursor(c, ele - _index[20], 3, 5, 1, 8, TYPE_PYR, SY, NbSY);
     else if(ele < _index[22])
-      _setLast(ele - _index[21], 3, 5, 3, 8, TYPE_PYR, VY, NbVY);
+      _setCursor(c, ele - _index[21], 3, 5, 3, 8, TYPE_PYR, VY, NbVY);
     else
-      _setLast(ele - _index[22], 3, 5, 9, 8, TYPE_PYR, TY, NbTY);
+      _setCursor(c, ele - _index[22], 3, 5, 9, 8, TYPE_PYR, TY, NbTY);
   }
   else if(ele < _index[26]) { // trihedra
     if(ele < _index[24])
-      _setLast(ele - _index[23], 3, 4, 1, 5, TYPE_TRIH, SR, NbSR);
+      _setCursor(c, ele - _index[23], 3, 4, 1, 5, TYPE_TRIH, SR, NbSR);
     else if(ele < _index[25])
-      _setLast(ele - _index[24], 3, 4, 3, 5, TYPE_TRIH, VR, NbVR);
+      _setCursor(c, ele - _index[24], 3, 4, 3, 5, TYPE_TRIH, VR, NbVR);
     else
-      _setLast(ele - _index[25], 3, 4, 9, 5, TYPE_TRIH, TR, NbTR);
+      _setCursor(c, ele - _index[25], 3, 4, 9, 5, TYPE_TRIH, TR, NbTR);
   }
   else if(ele < _index[29]) { // polygons
     int nN = polyNumNodes[0][ele - _index[26]];
     if(ele < _index[27])
-      _setLast(ele - _index[26], 2, nN, 1, nN, TYPE_POLYG, SG, NbSG);
+      _setCursor(c, ele - _index[26], 2, nN, 1, nN, TYPE_POLYG, SG, NbSG);
     else if(ele < _index[28])
-      _setLast(ele - _index[27], 2, nN, 3, nN, TYPE_POLYG, VG, NbVG);
+      _setCursor(c, ele - _index[27], 2, nN, 3, nN, TYPE_POLYG, VG, NbVG);
     else
-      _setLast(ele - _index[28], 2, nN, 9, nN, TYPE_POLYG, TG, NbTG);
+      _setCursor(c, ele - _index[28], 2, nN, 9, nN, TYPE_POLYG, TG, NbTG);
   }
   else if(ele < _index[32]) { // polyhedra
     int nN = polyNumNodes[1][ele - _index[29]];
     if(ele < _index[30])
-      _setLast(ele - _index[29], 3, nN, 1, nN * 1.5, TYPE_POLYH, SD, NbSD);
+      _setCursor(c, ele - _index[29], 3, nN, 1, nN * 1.5, TYPE_POLYH, SD, NbSD);
     else if(ele < _index[32])
-      _setLast(ele - _index[30], 3, nN, 3, nN * 1.5, TYPE_POLYH, VD, NbVD);
+      _setCursor(c, ele - _index[30], 3, nN, 3, nN * 1.5, TYPE_POLYH, VD, NbVD);
     else
-      _setLast(ele - _index[31], 3, nN, 9, nN * 1.5, TYPE_POLYH, TD, NbTD);
+      _setCursor(c, ele - _index[31], 3, nN, 9, nN * 1.5, TYPE_POLYH, TD, NbTD);
   }
 }
 
 int PViewDataList::getDimension(int step, int ent, int ele)
 {
   if(ele != _lastElement) _setLast(ele);
-  return _lastDimension;
+  return _last._dim;
 }
 
 int PViewDataList::getNumNodes(int step, int ent, int ele)
 {
   if(ele != _lastElement) _setLast(ele);
-  return _lastNumNodes;
+  return _last._numNodes;
 }
 
 int PViewDataList::getNode(int step, int ent, int ele, int nod, double &x,
                            double &y, double &z)
 {
   if(ele != _lastElement) _setLast(ele);
-  x = _lastXYZ[nod];
-  y = _lastXYZ[_lastNumNodes + nod];
-  z = _lastXYZ[2 * _lastNumNodes + nod];
+  x = _last._xyz[nod];
+  y = _last._xyz[_last._numNodes + nod];
+  z = _last._xyz[2 * _last._numNodes + nod];
   return 0;
 }
 
@@ -460,28 +464,28 @@ void PViewDataList::setNode(int step, int ent, int ele, int nod, double x,
 {
   if(step) return;
   if(ele != _lastElement) _setLast(ele);
-  _lastXYZ[nod] = x;
-  _lastXYZ[_lastNumNodes + nod] = y;
-  _lastXYZ[2 * _lastNumNodes + nod] = z;
+  _last._xyz[nod] = x;
+  _last._xyz[_last._numNodes + nod] = y;
+  _last._xyz[2 * _last._numNodes + nod] = z;
 }
 
 int PViewDataList::getNumComponents(int step, int ent, int ele)
 {
   if(ele != _lastElement) _setLast(ele);
-  return _lastNumComponents;
+  return _last._numComponents;
 }
 
 int PViewDataList::getNumValues(int step, int ent, int ele)
 {
   if(ele != _lastElement) _setLast(ele);
-  return _lastNumValues;
+  return _last._numValues;
 }
 
 void PViewDataList::getValue(int step, int ent, int ele, int idx, double &val)
 {
   if(ele != _lastElement) _setLast(ele);
   if(step >= NbTimeStep) step = 0;
-  val = _lastVal[step * _lastNumValues + idx];
+  val = _last._val[step * _last._numValues + idx];
 }
 
 void PViewDataList::getValue(int step, int ent, int ele, int nod, int comp,
@@ -489,8 +493,8 @@ void PViewDataList::getValue(int step, int ent, int ele, int nod, int comp,
 {
   if(ele != _lastElement) _setLast(ele);
   if(step >= NbTimeStep) step = 0;
-  val = _lastVal[step * _lastNumNodes * _lastNumComponents +
-                 nod * _lastNumComponents + comp];
+  val = _last._val[step * _last._numNodes * _last._numComponents +
+                 nod * _last._numComponents + comp];
 }
 
 void PViewDataList::setValue(int step, int ent, int ele, int nod, int comp,
@@ -498,20 +502,27 @@ void PViewDataList::setValue(int step, int ent, int ele, int nod, int comp,
 {
   if(ele != _lastElement) _setLast(ele);
   if(step >= NbTimeStep) step = 0;
-  _lastVal[step * _lastNumNodes * _lastNumComponents +
-           nod * _lastNumComponents + comp] = val;
+  _last._val[step * _last._numNodes * _last._numComponents +
+           nod * _last._numComponents + comp] = val;
 }
 
 int PViewDataList::getNumEdges(int step, int ent, int ele)
 {
   if(ele != _lastElement) _setLast(ele);
-  return _lastNumEdges;
+  return _last._numEdges;
 }
 
 int PViewDataList::getType(int step, int ent, int ele)
 {
   if(ele != _lastElement) _setLast(ele);
-  return _lastType;
+  return _last._type;
+}
+
+void PViewDataList::setCursor(PViewDataCursor &c, int step, int ent, int ele)
+{
+  _setCursor(c, ele);
+  if(step >= NbTimeStep) step = 0;
+  c._val += step * c._numValues;
 }
 
 void PViewDataList::_getString(int dim, int i, int step, std::string &str,
@@ -585,26 +596,27 @@ void PViewDataList::reverseElement(int step, int ent, int ele)
   if(ele != _lastElement) _setLast(ele);
 
   // copy data
-  std::vector<double> XYZ(3 * _lastNumNodes);
-  for(std::size_t i = 0; i < XYZ.size(); i++) XYZ[i] = _lastXYZ[i];
+  std::vector<double> XYZ(3 * _last._numNodes);
+  for(std::size_t i = 0; i < XYZ.size(); i++) XYZ[i] = _last._xyz[i];
 
-  std::vector<double> V(_lastNumNodes * _lastNumComponents * getNumTimeSteps());
-  for(std::size_t i = 0; i < V.size(); i++) V[i] = _lastVal[i];
+  std::vector<double> V(_last._numNodes * _last._numComponents *
+                        getNumTimeSteps());
+  for(std::size_t i = 0; i < V.size(); i++) V[i] = _last._val[i];
 
   // reverse node order
-  for(int i = 0; i < _lastNumNodes; i++) {
-    _lastXYZ[i] = XYZ[_lastNumNodes - i - 1];
-    _lastXYZ[_lastNumNodes + i] = XYZ[2 * _lastNumNodes - i - 1];
-    _lastXYZ[2 * _lastNumNodes + i] = XYZ[3 * _lastNumNodes - i - 1];
+  for(int i = 0; i < _last._numNodes; i++) {
+    _last._xyz[i] = XYZ[_last._numNodes - i - 1];
+    _last._xyz[_last._numNodes + i] = XYZ[2 * _last._numNodes - i - 1];
+    _last._xyz[2 * _last._numNodes + i] = XYZ[3 * _last._numNodes - i - 1];
   }
 
   for(int step = 0; step < getNumTimeSteps(); step++)
-    for(int i = 0; i < _lastNumNodes; i++)
-      for(int k = 0; k < _lastNumComponents; k++)
-        _lastVal[_lastNumComponents * _lastNumNodes * step +
-                 _lastNumComponents * i + k] =
-          V[_lastNumComponents * _lastNumNodes * step +
-            _lastNumComponents * (_lastNumNodes - i - 1) + k];
+    for(int i = 0; i < _last._numNodes; i++)
+      for(int k = 0; k < _last._numComponents; k++)
+        _last._val[_last._numComponents * _last._numNodes * step +
+                   _last._numComponents * i + k] =
+          V[_last._numComponents * _last._numNodes * step +
+            _last._numComponents * (_last._numNodes - i - 1) + k];
 }
 
 static void generateConnectivities(std::vector<double> &list, int nbList,
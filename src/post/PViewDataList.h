@@ -54,17 +54,17 @@ public:
 
 private:
   int _index[33];
-  int _lastElement, _lastDimension;
-  int _lastNumNodes, _lastNumComponents, _lastNumValues, _lastNumEdges,
-    _lastType;
-  double *_lastXYZ, *_lastVal;
+  // cache of the current element (with the values of all the time steps)
+  int _lastElement;
+  PViewDataCursor _last;
   bool _isAdapted;
   void _stat(std::vector<double> &D, std::vector<char> &C, int nb);
   void _stat(std::vector<double> &list, int nbcomp, int nbelm, int nbnod,
              int type);
   void _setLast(int ele);
-  void _setLast(int ele, int dim, int nbnod, int nbcomp, int nbedg, int type,
-                std::vector<double> &list, int nblist);
+  void _setCursor(PViewDataCursor &c, int ele);
+  void _setCursor(PViewDataCursor &c, int ele, int dim, int nbnod, int nbcomp,
+                  int nbedg, int type, std::vector<double> &list, int nblist);
   void _getString(int dim, int i, int timestep, std::string &str, double &x,
                   double &y, double &z, double &style);
   int _getRawData(int idxtype, std::vector<double> **l, int **ne, int *nc,
@@ -115,6 +115,7 @@ public:
   void setValue(int step, int ent, int ele, int nod, int comp, double val);
   int getNumEdges(int step, int ent, int ele);
   int getType(int step, int ent, int ele);
+  void setCursor(PViewDataCursor &c, int step, int ent, int ele);
   int getNumStrings2D() { return NbT2; }
   int getNumStrings3D() { return NbT3; }
   void getString2D(int i, int step, std::string &str, double &x, double &y,